@@ -52,7 +52,9 @@
 #include <string.h>
 
 #include "cmd.h"
+#include "cmdframe.h"
 #include "project/cmd_tbl.h"
+#include "core/trace/trace.h"
 
 #ifdef CFG_PRINTF_UART
 #include "core/uart/uart.h"
@@ -60,7 +62,6 @@
 
 #ifdef CFG_PRINTF_USBCDC
   #include "core/usbcdc/cdcuser.h"
-  static char usbcdcBuf [32];
 #endif
 
 #if CFG_INTERFACE_ENABLEIRQ == 1
@@ -70,6 +71,51 @@
 static uint8_t msg[CFG_INTERFACE_MAXMSGSIZE];
 static uint8_t *msg_ptr;
 
+// Command lookup table indexed by the (single character) command name
+#define CMD_INDEX_FIRST   (' ')
+#define CMD_INDEX_LAST    ('~')
+static uint8_t cmdIndex[CMD_INDEX_LAST - CMD_INDEX_FIRST + 1];
+static bool cmdIndexReady = false;
+
+#if CFG_INTERFACE_FRAMES == 1
+// Set between the two delimiters of a binary frame (see cmdframe.c)
+static bool cmdFraming = false;
+#endif
+
+static void cmdMenu();
+
+#if defined CFG_PRINTF_USBCDC
+/**************************************************************************/
+/*! 
+    @brief  Applies any backspace characters in a NULL-terminated line
+            in place, removing them and the characters they erase.
+
+    @param[in]  line
+                The line to edit
+*/
+/**************************************************************************/
+static void cmdApplyBackspace(char *line)
+{
+  char *src, *dst;
+
+  for (src = dst = line; *src != '\0'; src++)
+  {
+    if (*src == '\b')
+    {
+      if (dst > line)
+      {
+        dst--;
+      }
+    }
+    else
+    {
+      *dst++ = *src;
+    }
+  }
+  *dst = '\0';
+}
+#endif
+
 /**************************************************************************/
 /*! 
     @brief  Polls the relevant incoming message queue to see if anything
@@ -87,18 +133,86 @@ void cmdPoll()
   #endif
 
   #if defined CFG_PRINTF_USBCDC
-    int  numBytesToRead, numBytesRead, numAvailByte;
-  
-    CDC_OutBufAvailChar (&numAvailByte);
-    if (numAvailByte > 0) 
+    // USB data is assembled into lines directly in the CDC OUT buffer,
+    // and each line is parsed in place before being released.  'scanned'
+    // is the number of bytes already checked (and echoed) for a new line.
+    static int scanned = 0;
+    int  length, i;
+    char *line = CDC_OutBufData(&length);
+
+    for (i = scanned; i < length; i++) 
+    {
+      #if CFG_INTERFACE_FRAMES == 1
+      if (line[i] == CMDFRAME_DELIMITER)
+      {
+        // Either the end of a frame or the start of one, in which case
+        // any partial text line before it is thrown away
+        if (cmdFraming && (i > 0))
+        {
+          cmdFrameProcess((uint8_t *)line, i);
+          cmdFraming = false;
+        }
+        else
+        {
+          cmdFraming = true;
+        }
+        CDC_OutBufConsume(i + 1);
+        line = CDC_OutBufData(&length);
+        scanned = 0;
+        i = -1;
+        continue;
+      }
+      if (cmdFraming)
+      {
+        continue;
+      }
+      #endif
+      if ((line[i] != '\r') && (line[i] != '\n'))
+      {
+        continue;
+      }
+      #if CFG_INTERFACE_SILENTMODE == 0
+      CDC_WrInBuf(&line[scanned], i - scanned);
+      printf("%s", CFG_PRINTF_NEWLINE);
+      #endif
+      line[i] = '\0';
+      cmdApplyBackspace(line);
+      cmdParse(line);
+      CDC_OutBufConsume(i + 1);
+
+      // Anything after the new line has moved to the start of the buffer
+      line = CDC_OutBufData(&length);
+      scanned = 0;
+      i = -1;
+    }
+
+    #if CFG_INTERFACE_FRAMES == 1
+    if (cmdFraming)
     {
-      numBytesToRead = numAvailByte > 32 ? 32 : numAvailByte; 
-      numBytesRead = CDC_RdOutBuf (&usbcdcBuf[0], &numBytesToRead);
-      int i;
-      for (i = 0; i < numBytesRead; i++) 
-      {  
-        cmdRx(usbcdcBuf[i]);   
+      // Frames are never echoed, and an oversized one is dropped quietly
+      scanned = length;
+      if (length >= CDC_OutBufSize())
+      {
+        CDC_OutBufConsume(length);
+        scanned = 0;
       }
+      return;
+    }
+    #endif
+
+    #if CFG_INTERFACE_SILENTMODE == 0
+    CDC_WrInBuf(&line[scanned], length - scanned);
+    #endif
+    scanned = length;
+
+    // The buffer can't accept another packet and there's still no new
+    // line, so throw the partial command away rather than stall the host
+    if (length >= CDC_OutBufSize())
+    {
+      CDC_OutBufConsume(length);
+      scanned = 0;
+      printf("%sCommand too long%s", CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
+      cmdMenu();
     }
   #endif
 }
@@ -109,7 +223,8 @@ void cmdPoll()
             detected, the entire command will be passed to the command
             parser.  If a text character is detected, it will be added to
             the message buffer until a new line is detected (up to the
-            maximum queue size, CFG_INTERFACE_MAXMSGSIZE).
+            maximum queue size, CFG_INTERFACE_MAXMSGSIZE).  Binary frames
+            (see cmdframe.c) are collected in the same buffer.
 
     @param[in]  c
                 The character to parse.
@@ -117,6 +232,34 @@ void cmdPoll()
 /**************************************************************************/
 void cmdRx(uint8_t c)
 {
+  #if CFG_INTERFACE_FRAMES == 1
+  if (c == CMDFRAME_DELIMITER)
+  {
+    // Either the end of a frame or the start of one, in which case any
+    // partial text line before it is thrown away
+    if (cmdFraming && (msg_ptr > msg))
+    {
+      cmdFrameProcess(msg, msg_ptr - msg);
+      cmdFraming = false;
+    }
+    else
+    {
+      cmdFraming = true;
+    }
+    msg_ptr = msg;
+    return;
+  }
+  if (cmdFraming)
+  {
+    // An oversized frame is truncated and will fail its CRC check
+    if (msg_ptr < &msg[CFG_INTERFACE_MAXMSGSIZE])
+    {
+      *msg_ptr++ = c;
+    }
+    return;
+  }
+  #endif
+
   // read out the data in the buffer and echo it back to the host. 
   switch (c)
   {
@@ -146,7 +289,11 @@ void cmdRx(uint8_t c)
         #if CFG_INTERFACE_SILENTMODE == 0
         printf("%c",c);
         #endif
-        *msg_ptr++ = c;
+        // Leave room for the terminating NULL
+        if (msg_ptr < &msg[CFG_INTERFACE_MAXMSGSIZE - 1])
+        {
+          *msg_ptr++ = c;
+        }
         break;
   }
 }
@@ -167,73 +314,310 @@ static void cmdMenu()
 
 /**************************************************************************/
 /*! 
-    @brief  Parse the command line. This function tokenizes the command
-            input, then searches for the command table entry associated
-            with the commmand. Once found, it will jump to the
-            corresponding function.
+    @brief  Builds the command lookup table.  Commands are single
+            characters, so the character itself is a perfect hash into
+            cmdIndex, which holds the matching cmd_tbl position + 1 (0
+            means no command).  The table is filled in at startup because
+            cmd_tbl's contents depend on projectconfig.h.
+*/
+/**************************************************************************/
+static void cmdBuildIndex()
+{
+  size_t i;
+  uint8_t c;
 
-    @param[in]  cmd
-                The entire command string to be parsed
+  memset(cmdIndex, 0, sizeof(cmdIndex));
+  for (i = 0; i < CMD_COUNT; i++)
+  {
+    c = (uint8_t)cmd_tbl[i].command[0];
+    if ((cmd_tbl[i].command[1] == '\0') && (c >= CMD_INDEX_FIRST) && (c <= CMD_INDEX_LAST))
+    {
+      cmdIndex[c - CMD_INDEX_FIRST] = i + 1;
+    }
+  }
+  cmdIndexReady = true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Finds the command table entry for the supplied command name
+
+    @param[in]  name
+                The command name (the first token of a command line)
+
+    @returns  The matching cmd_tbl entry, or NULL if there isn't one
 */
 /**************************************************************************/
-void cmdParse(char *cmd)
+cmd_t *cmdFind(const char *name)
 {
-  size_t argc, i = 0;
-  char *argv[30];
+  size_t i;
+  uint8_t c = (uint8_t)name[0];
 
-  argv[i] = strtok(cmd, " ");
-  do
+  if (!cmdIndexReady)
   {
-      argv[++i] = strtok(NULL, " ");
-  } while ((i < 30) && (argv[i] != NULL));
-  
-  argc = i;
-  for (i=0; i < CMD_COUNT; i++)
+    cmdBuildIndex();
+  }
+
+  // Single character names are looked up directly
+  if ((name[1] == '\0') && (c >= CMD_INDEX_FIRST) && (c <= CMD_INDEX_LAST))
   {
-      if (!strcmp(argv[0], cmd_tbl[i].command))
-      {
-        if ((argc == 2) && !strcmp (argv [1], "?"))
-        {
-          // Display parameter help menu on 'command ?'
-          printf ("%s%s%s", cmd_tbl[i].description, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
-          printf ("%s%s", cmd_tbl[i].parameters, CFG_PRINTF_NEWLINE);
-        }
-        else if ((argc - 1) < cmd_tbl[i].minArgs)
-        {
-          // Too few arguments supplied
-          printf ("Too few arguments (%d expected)%s", cmd_tbl[i].minArgs, CFG_PRINTF_NEWLINE);
-          printf ("%sType '%s ?' for more information%s%s", CFG_PRINTF_NEWLINE, cmd_tbl[i].command, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
-        }
-        else if ((argc - 1) > cmd_tbl[i].maxArgs)
-        {
-          // Too many arguments supplied
-          printf ("Too many arguments (%d maximum)%s", cmd_tbl[i].maxArgs, CFG_PRINTF_NEWLINE);
-          printf ("%sType '%s ?' for more information%s%s", CFG_PRINTF_NEWLINE, cmd_tbl[i].command, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
-        }
-        else
-        {
-          #if CFG_INTERFACE_ENABLEIRQ != 0
-          // Set the IRQ pin high at start of a command
-          gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 1);
-          #endif
-          // Dispatch command to the appropriate function
-          cmd_tbl[i].func(argc - 1, &argv [1]);
-          #if CFG_INTERFACE_ENABLEIRQ  != 0
-          // Set the IRQ pin low to signal the end of a command
-          gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 0);
-          #endif
-        }
+    i = cmdIndex[c - CMD_INDEX_FIRST];
+    return i ? &cmd_tbl[i - 1] : NULL;
+  }
+
+  // Anything longer falls back to a search of the table
+  for (i = 0; i < CMD_COUNT; i++)
+  {
+    if (!strcmp(name, cmd_tbl[i].command))
+    {
+      return &cmd_tbl[i];
+    }
+  }
+
+  return NULL;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Splits a command line into arguments in a single pass,
+            modifying the line in place.  Arguments are separated by
+            spaces or tabs.  Double quotes group text containing spaces
+            into a single argument, and \" and \\ can be used inside
+            quotes for a literal quote or backslash.
+
+    @param[in]  line
+                The NULL-terminated command line (modified in place)
+    @param[out] argv
+                Receives pointers to the arguments, followed by a NULL
+                entry, so it must have room for maxArgs + 1 pointers
+    @param[in]  maxArgs
+                Maximum number of arguments (including the command)
+
+    @returns  The number of arguments, or -1 if there were too many or
+              a quote wasn't closed
+*/
+/**************************************************************************/
+int cmdTokenize(char *line, char **argv, int maxArgs)
+{
+  char *src = line;
+  char *dst = line;
+  int argc = 0;
+  bool quoted;
 
-        // Refresh the command prompt
-        cmdMenu();
-        return;
+  while (1)
+  {
+    // Skip leading separators
+    while ((*src == ' ') || (*src == '\t'))
+    {
+      src++;
+    }
+    if (*src == '\0')
+    {
+      break;
+    }
+    if (argc == maxArgs)
+    {
+      return -1;
+    }
+
+    // Copy the argument down over any quotes and escapes removed so far
+    argv[argc++] = dst;
+    quoted = false;
+    while (*src != '\0')
+    {
+      if (*src == '"')
+      {
+        quoted = !quoted;
+        src++;
+        continue;
+      }
+      if (!quoted && ((*src == ' ') || (*src == '\t')))
+      {
+        break;
       }
+      if (quoted && (*src == '\\') && ((src[1] == '"') || (src[1] == '\\')))
+      {
+        src++;
+      }
+      *dst++ = *src++;
+    }
+    if (quoted)
+    {
+      return -1;
+    }
+    if (*src != '\0')
+    {
+      src++;
+    }
+    *dst++ = '\0';
   }
-  printf("Command not recognized: '%s'%s%s", cmd, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
-  #if CFG_INTERFACE_SILENTMODE == 0
-  printf("Type '?' for a list of all available commands%s", CFG_PRINTF_NEWLINE);
-  #endif
 
+  argv[argc] = NULL;
+  return argc;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Finds the end of the first ';' separated statement in a line,
+            ignoring any ';' inside double quotes.  The separator is
+            replaced with a NULL.
+
+    @param[in]  line
+                The NULL-terminated line (modified in place)
+
+    @returns  The start of the next statement, or NULL if this was the
+              last one
+*/
+/**************************************************************************/
+static char *cmdSplitStatement(char *line)
+{
+  bool quoted = false;
+
+  for (; *line != '\0'; line++)
+  {
+    if (*line == '"')
+    {
+      quoted = !quoted;
+    }
+    else if (quoted && (*line == '\\') && (line[1] != '\0'))
+    {
+      line++;
+    }
+    else if (!quoted && (*line == ';'))
+    {
+      *line = '\0';
+      return line + 1;
+    }
+  }
+
+  return NULL;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Tokenizes a single statement, looks up the command table
+            entry associated with the command and, if the arguments are
+            valid, jumps to the corresponding function.
+
+    @param[in]  cmd
+                The statement to execute (modified in place)
+
+    @returns  true if the command was executed (or the statement was
+              empty), false if it was rejected
+*/
+/**************************************************************************/
+static bool cmdDispatch(char *cmd)
+{
+  int argc;
+  char *argv[CMD_MAXARGS + 1];
+  cmd_t *entry;
+
+  argc = cmdTokenize(cmd, argv, CMD_MAXARGS);
+  if (argc < 0)
+  {
+    printf("Malformed command (unclosed quote or more than %d arguments)%s", CMD_MAXARGS - 1, CFG_PRINTF_NEWLINE);
+    return false;
+  }
+  if (argc == 0)
+  {
+    // Empty statement
+    return true;
+  }
+
+  entry = cmdFind(argv[0]);
+  if (entry == NULL)
+  {
+    printf("Command not recognized: '%s'%s%s", argv[0], CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
+    #if CFG_INTERFACE_SILENTMODE == 0
+    printf("Type '?' for a list of all available commands%s", CFG_PRINTF_NEWLINE);
+    #endif
+    return false;
+  }
+
+  if ((argc == 2) && !strcmp (argv [1], "?"))
+  {
+    // Display parameter help menu on 'command ?'
+    printf ("%s%s%s", entry->description, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
+    printf ("%s%s", entry->parameters, CFG_PRINTF_NEWLINE);
+  }
+  else if ((argc - 1) < entry->minArgs)
+  {
+    // Too few arguments supplied
+    printf ("Too few arguments (%d expected)%s", entry->minArgs, CFG_PRINTF_NEWLINE);
+    printf ("%sType '%s ?' for more information%s%s", CFG_PRINTF_NEWLINE, entry->command, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
+    return false;
+  }
+  else if ((argc - 1) > entry->maxArgs)
+  {
+    // Too many arguments supplied
+    printf ("Too many arguments (%d maximum)%s", entry->maxArgs, CFG_PRINTF_NEWLINE);
+    printf ("%sType '%s ?' for more information%s%s", CFG_PRINTF_NEWLINE, entry->command, CFG_PRINTF_NEWLINE, CFG_PRINTF_NEWLINE);
+    return false;
+  }
+  else
+  {
+    #if CFG_INTERFACE_ENABLEIRQ != 0
+    // Set the IRQ pin high at start of a command
+    gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 1);
+    #endif
+    // Dispatch command to the appropriate function
+    TRACE2(TRACE_CMD_START, entry->command[0], argc - 1);
+    entry->func(argc - 1, &argv [1]);
+    TRACE1(TRACE_CMD_END, entry->command[0]);
+    #if CFG_INTERFACE_ENABLEIRQ  != 0
+    // Set the IRQ pin low to signal the end of a command
+    gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 0);
+    #endif
+  }
+
+  return true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Executes every ';' separated command in a line, without
+            echoing the line or displaying the command prompt.  This is
+            used for scripts as well as lines typed at the prompt.
+
+    @param[in]  line
+                The NULL-terminated line (modified in place)
+
+    @returns  The number of commands that were rejected
+*/
+/**************************************************************************/
+int cmdExecute(char *line)
+{
+  char *next;
+  int errors = 0;
+
+  while (line != NULL)
+  {
+    next = cmdSplitStatement(line);
+    if (!cmdDispatch(line))
+    {
+      errors++;
+    }
+    line = next;
+  }
+
+  return errors;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Parse the command line. Each ';' separated command is
+            tokenized and passed to the function registered for it in
+            the command table, after which the prompt is displayed.
+
+    @param[in]  cmd
+                The entire command string to be parsed
+*/
+/**************************************************************************/
+void cmdParse(char *cmd)
+{
+  cmdExecute(cmd);
+
+  // Refresh the command prompt
   cmdMenu();
 }
 
@@ -262,6 +646,9 @@ void cmdInit()
   // init the msg ptr
   msg_ptr = msg;
 
+  // Build the command lookup table
+  cmdBuildIndex();
+
   // Show the menu
   cmdMenu();
 
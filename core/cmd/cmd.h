@@ -41,6 +41,8 @@
 
 #include "projectconfig.h"
 
+#define CMD_MAXARGS   (30)    // Maximum number of tokens, including the command
+
 typedef struct
 {
   char *command;
@@ -55,6 +57,9 @@ typedef struct
 void cmdPoll();
 void cmdRx(uint8_t c);
 void cmdParse(char *cmd);
+int cmdExecute(char *line);
+cmd_t *cmdFind(const char *name);
+int cmdTokenize(char *line, char **argv, int maxArgs);
 void cmdInit();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,379 @@
+/**************************************************************************/
+/*! 
+    @file     cmdframe.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @section DESCRIPTION
+
+    Binary request/response protocol for machine clients, sharing the
+    UART or USB CDC link with the text command-line.  Frames are COBS
+    encoded, so they never contain a 0x00 byte, and are sent as:
+
+      0x00 <COBS encoded payload> 0x00
+
+    A text line never contains 0x00, so the command-line switches to
+    collecting a frame when it sees the first delimiter (throwing away
+    any partial text line) and passes the frame to cmdFrameProcess when
+    it sees the second.
+
+    Request payload:
+
+      Byte  0       Sequence number (echoed in the response)
+      Byte  1       Command name from cmd_tbl (e.g. 'p')
+      Bytes 2..n-3  Arguments, each one of:
+                      CMDFRAME_ARG_INT     <int32, little-endian>
+                      CMDFRAME_ARG_STRING  <length> <text>
+      Bytes n-2..   CRC-16/CCITT (0x1021, initial value 0xFFFF) of the
+                    preceding bytes, little-endian
+
+    Response payload:
+
+      Byte  0       Sequence number of the request
+      Byte  1       Status (cmdFrameStatus_t)
+      Bytes 2..n-3  Output of the command handler (the text it prints)
+      Bytes n-2..   CRC-16/CCITT of the preceding bytes
+
+    Arguments are converted to the strings the cmd_tbl handlers expect,
+    so every command is available without changes.  Requests are handled
+    in the order they arrive, so a client can send several before reading
+    the responses and match them up by sequence number.  No echo, prompt
+    or help text is sent for frames, and command output is COBS encoded
+    as it is printed, so there is no limit on its length.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cmdframe.h"
+
+#if CFG_INTERFACE_FRAMES == 1
+
+#include "cmd.h"
+#include "core/libc/printf.h"
+#include "core/trace/trace.h"
+
+#if CFG_INTERFACE_ENABLEIRQ == 1
+  #include "core/gpio/gpio.h"
+#endif
+
+// Sends a block of characters over the printf link (see sysinit.c)
+extern void __putdata(const char *data, uint32_t length);
+
+// CRC-16/CCITT lookup table, one entry per 4-bit nibble
+static const uint16_t cmdFrameCrcTable[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// Response encoder state: the COBS block being assembled (byte 0 is
+// reserved for its code) and the running CRC
+static uint8_t cmdFrameBlock[255];
+static uint32_t cmdFrameBlockLen;
+static uint16_t cmdFrameTxCrc;
+
+/**************************************************************************/
+/*! 
+    @brief  Updates a CRC-16/CCITT value with the supplied data.  Start
+            with a CRC of 0xFFFF.
+*/
+/**************************************************************************/
+uint16_t cmdFrameCrc(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+  while (length--)
+  {
+    crc = (crc << 4) ^ cmdFrameCrcTable[(crc >> 12) ^ (*data >> 4)];
+    crc = (crc << 4) ^ cmdFrameCrcTable[(crc >> 12) ^ (*data & 0x0F)];
+    data++;
+  }
+
+  return crc;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Decodes a COBS encoded frame in place.
+
+    @returns  The decoded length, or -1 if the encoding is invalid
+*/
+/**************************************************************************/
+static int32_t cmdFrameDecode(uint8_t *frame, uint32_t length)
+{
+  uint8_t *src = frame;
+  uint8_t *dst = frame;
+  uint8_t *end = frame + length;
+  uint8_t code, i;
+
+  while (src < end)
+  {
+    code = *src++;
+    if ((code == 0) || (code - 1 > end - src))
+    {
+      return -1;
+    }
+    for (i = 1; i < code; i++)
+    {
+      *dst++ = *src++;
+    }
+    // Every block except a full one ends with a zero, apart from the last
+    if ((code < 0xFF) && (src < end))
+    {
+      *dst++ = 0;
+    }
+  }
+
+  return dst - frame;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends the COBS block assembled so far
+*/
+/**************************************************************************/
+static void cmdFrameFlushBlock(void)
+{
+  cmdFrameBlock[0] = cmdFrameBlockLen;
+  __putdata((const char *)cmdFrameBlock, cmdFrameBlockLen);
+  cmdFrameBlockLen = 1;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Adds one byte to the response, COBS encoding it on the fly
+*/
+/**************************************************************************/
+static void cmdFramePutByte(uint8_t c)
+{
+  if (c == 0)
+  {
+    cmdFrameFlushBlock();
+    return;
+  }
+
+  cmdFrameBlock[cmdFrameBlockLen++] = c;
+  if (cmdFrameBlockLen == 0xFF)
+  {
+    cmdFrameFlushBlock();
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Adds payload data to the response and its CRC
+*/
+/**************************************************************************/
+static void cmdFramePut(const uint8_t *data, uint32_t length)
+{
+  cmdFrameTxCrc = cmdFrameCrc(cmdFrameTxCrc, data, length);
+  while (length--)
+  {
+    cmdFramePutByte(*data++);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  printf sink used while a command handler runs, which adds the
+            handler's output to the response frame
+*/
+/**************************************************************************/
+static void cmdFrameSink(void *context, const char *data, uint32_t length)
+{
+  cmdFramePut((const uint8_t *)data, length);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends the start of a response frame
+*/
+/**************************************************************************/
+static void cmdFrameBegin(uint8_t seq, uint8_t status)
+{
+  uint8_t header[2] = { seq, status };
+  uint8_t delimiter = CMDFRAME_DELIMITER;
+
+  __putdata((const char *)&delimiter, 1);
+  cmdFrameBlockLen = 1;
+  cmdFrameTxCrc = 0xFFFF;
+  cmdFramePut(header, 2);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends the CRC and the end of a response frame
+*/
+/**************************************************************************/
+static void cmdFrameEnd(void)
+{
+  uint16_t crc = cmdFrameTxCrc;
+  uint8_t delimiter = CMDFRAME_DELIMITER;
+
+  cmdFramePutByte(crc & 0xFF);
+  cmdFramePutByte(crc >> 8);
+  cmdFrameFlushBlock();
+  __putdata((const char *)&delimiter, 1);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends a response with no data
+*/
+/**************************************************************************/
+static void cmdFrameRespond(uint8_t seq, uint8_t status)
+{
+  cmdFrameBegin(seq, status);
+  cmdFrameEnd();
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Handles one request frame and sends the response.
+
+    @param[in]  frame
+                The COBS encoded frame, without the delimiters.  It is
+                decoded in place.
+    @param[in]  length
+                The length of the encoded frame in bytes
+*/
+/**************************************************************************/
+void cmdFrameProcess(uint8_t *frame, uint32_t length)
+{
+  char text[CFG_INTERFACE_MAXMSGSIZE];
+  char *argv[CMD_MAXARGS + 1];
+  char name[2];
+  char number[12];
+  uint8_t *arg, *end;
+  uint32_t used, n;
+  int32_t len, value;
+  uint8_t seq;
+  cmd_t *entry;
+  int argc;
+
+  len = cmdFrameDecode(frame, length);
+  if (len < CMDFRAME_MINSIZE)
+  {
+    cmdFrameRespond(len > 0 ? frame[0] : 0, CMDFRAME_STATUS_MALFORMED);
+    return;
+  }
+  seq = frame[0];
+
+  // Check the CRC
+  len -= 2;
+  if (cmdFrameCrc(0xFFFF, frame, len) != (frame[len] | (frame[len + 1] << 8)))
+  {
+    cmdFrameRespond(seq, CMDFRAME_STATUS_CRC);
+    return;
+  }
+
+  // Find the command
+  name[0] = frame[1];
+  name[1] = '\0';
+  entry = cmdFind(name);
+  if (entry == NULL)
+  {
+    cmdFrameRespond(seq, CMDFRAME_STATUS_UNKNOWN);
+    return;
+  }
+
+  // Convert the arguments to the strings the handler expects
+  arg = &frame[2];
+  end = &frame[len];
+  used = 0;
+  argc = 0;
+  while (arg < end)
+  {
+    if (argc == CMD_MAXARGS - 1)
+    {
+      cmdFrameRespond(seq, CMDFRAME_STATUS_ARGCOUNT);
+      return;
+    }
+    argv[argc++] = &text[used];
+    if ((*arg == CMDFRAME_ARG_INT) && (end - arg >= 5))
+    {
+      value = arg[1] | (arg[2] << 8) | (arg[3] << 16) | ((uint32_t)arg[4] << 24);
+      // snprintf only returns what fits, so format the whole number first
+      n = snprintf(number, sizeof(number), "%d", (int)value);
+      if (n < sizeof(text) - used)
+      {
+        memcpy(&text[used], number, n + 1);
+      }
+      arg += 5;
+    }
+    else if ((*arg == CMDFRAME_ARG_STRING) && (end - arg >= 2) && (arg[1] <= end - arg - 2))
+    {
+      n = arg[1];
+      if (n < sizeof(text) - used)
+      {
+        memcpy(&text[used], &arg[2], n);
+        text[used + n] = '\0';
+      }
+      arg += 2 + arg[1];
+    }
+    else
+    {
+      cmdFrameRespond(seq, CMDFRAME_STATUS_MALFORMED);
+      return;
+    }
+    used += n + 1;
+    if (used > sizeof(text))
+    {
+      // Arguments don't fit in the text buffer
+      cmdFrameRespond(seq, CMDFRAME_STATUS_MALFORMED);
+      return;
+    }
+  }
+  argv[argc] = NULL;
+
+  if ((argc < entry->minArgs) || (argc > entry->maxArgs))
+  {
+    cmdFrameRespond(seq, CMDFRAME_STATUS_ARGCOUNT);
+    return;
+  }
+
+  // Run the command, sending its output in the response
+  cmdFrameBegin(seq, CMDFRAME_STATUS_OK);
+  printfSetSink(cmdFrameSink, NULL);
+  #if CFG_INTERFACE_ENABLEIRQ != 0
+  gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 1);
+  #endif
+  TRACE2(TRACE_CMD_START, entry->command[0], argc);
+  entry->func(argc, argv);
+  TRACE1(TRACE_CMD_END, entry->command[0]);
+  #if CFG_INTERFACE_ENABLEIRQ != 0
+  gpioSetValue(CFG_INTERFACE_IRQPORT, CFG_INTERFACE_IRQPIN, 0);
+  #endif
+  printfSetSink(NULL, NULL);
+  cmdFrameEnd();
+}
+
+#endif
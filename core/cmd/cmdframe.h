@@ -0,0 +1,62 @@
+/**************************************************************************/
+/*! 
+    @file     cmdframe.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#ifndef __CMDFRAME_H__
+#define __CMDFRAME_H__
+
+#include "projectconfig.h"
+
+#define CMDFRAME_DELIMITER      (0x00)  // Starts and ends every frame
+#define CMDFRAME_MINSIZE        (4)     // Sequence, command and CRC
+
+// Argument types in request payloads
+#define CMDFRAME_ARG_INT        (0x01)  // Followed by a 32-bit signed value (little-endian)
+#define CMDFRAME_ARG_STRING     (0x02)  // Followed by a length byte and the text
+
+typedef enum
+{
+  CMDFRAME_STATUS_OK        = 0,    // Command executed, data is its output
+  CMDFRAME_STATUS_CRC       = 1,    // CRC didn't match
+  CMDFRAME_STATUS_MALFORMED = 2,    // Bad COBS encoding or argument list
+  CMDFRAME_STATUS_UNKNOWN   = 3,    // No such command in cmd_tbl
+  CMDFRAME_STATUS_ARGCOUNT  = 4     // Too few or too many arguments
+} 
+cmdFrameStatus_t;
+
+uint16_t cmdFrameCrc(uint16_t crc, const uint8_t *data, uint32_t length);
+void     cmdFrameProcess(uint8_t *frame, uint32_t length);
+
+#endif
@@ -76,9 +76,9 @@ void PIOINT1_IRQHandler(void)
   uint32_t regVal;
 
 #ifdef CFG_CHIBI
-  // Check for interrupt on 1.8
+  // Check for interrupt on 1.8, or one that had to wait for SSP0
   regVal = gpioIntStatus(1, 8);
-  if (regVal)
+  if (regVal || chb_ISR_Deferred())
   {
     chibi_counter++;
     chb_ISR_Handler();
@@ -13,24 +13,319 @@
  *                           - adding a return result to the I2CEngine()
  *
 *****************************************************************************/
+#include <string.h>
+
 #include "i2c.h"
+#include "core/systick/systick.h"
+#include "core/gpio/gpio.h"
 
 volatile uint32_t I2CMasterState = I2CSTATE_IDLE;
 volatile uint32_t I2CSlaveState = I2CSTATE_IDLE;
 
-volatile uint8_t I2CMasterBuffer[I2C_BUFSIZE];
-volatile uint8_t I2CSlaveBuffer[I2C_BUFSIZE];
-volatile uint32_t I2CReadLength;
-volatile uint32_t I2CWriteLength;
-
 volatile uint32_t RdIndex = 0;
 volatile uint32_t WrIndex = 0;
 
+/* Queue of submitted transfers, the head is the one on the bus */
+static i2cTransfer_t * volatile i2cHead = NULL;
+static i2cTransfer_t * volatile i2cTail = NULL;
+
+/* Slave mode register file (see i2cSlaveInit), one bit per register in the maps */
+static uint8_t *i2cSlaveRegisters = NULL;
+static uint32_t i2cSlaveSize = 0;
+static i2cSlaveCallback_t i2cSlaveCallback = NULL;
+static uint8_t i2cSlaveWritable[256 / 8];
+static uint8_t i2cSlaveChanged[256 / 8];
+static volatile bool i2cSlaveChangePending = false;
+static uint8_t i2cSlaveReg = 0;
+static bool i2cSlaveFirst = false;
+
+#define I2C_SLAVEBIT(map, reg)  ((map)[(reg) >> 3] & (1 << ((reg) & 7)))
+
+/* Number of times i2cRecoverBus found the bus held low */
+static volatile uint32_t i2cRecoveries = 0;
+
+#if CFG_I2C_STATS > 0
+static i2cStats_t i2cStats[CFG_I2C_STATS];
+static uint32_t i2cStatsUsed = 0;
+
+/*****************************************************************************
+** Function name:	i2cGetMicroseconds
+**
+** Descriptions:	Time since systick started in microseconds, from
+**					the tick count and the current systick counter.
+**					Only differences between two values are useful
+**					since the result wraps around.
+**
+** parameters:		None
+** Returned value:	Time in us
+** 
+*****************************************************************************/
+static uint32_t i2cGetMicroseconds( void )
+{
+  uint32_t ticks, current;
+
+  /* Read again if the systick interrupt happened in between */
+  do
+  {
+    ticks = systickGetTicks();
+    current = SYSTICK_STCURR;
+  } while (ticks != systickGetTicks());
+
+  return ticks * CFG_SYSTICK_DELAY_IN_MS * 1000 + 
+         (SYSTICK_STRELOAD - current) / (CFG_CPU_CCLK / 1000000);
+}
+
+/*****************************************************************************
+** Function name:	i2cUpdateStats
+**
+** Descriptions:	Add a finished transfer to the statistics of its
+**					slave address.  Must be called with the I2C
+**					interrupt masked or from the interrupt handler.
+**
+** parameters:		transfer - The transfer at the head of the queue
+**					state - Its final I2CSTATE_... value
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cUpdateStats( i2cTransfer_t *transfer, uint32_t state )
+{
+  i2cStats_t *stats = NULL;
+  uint8_t address = transfer->address & ~RD_BIT;
+  uint32_t i;
+
+  for (i = 0; i < i2cStatsUsed; i++)
+  {
+    if (i2cStats[i].address == address)
+    {
+      stats = &i2cStats[i];
+      break;
+    }
+  }
+  if (stats == NULL)
+  {
+    if (i2cStatsUsed == CFG_I2C_STATS)
+    {
+      /* No room for another address */
+      return;
+    }
+    stats = &i2cStats[i2cStatsUsed++];
+    stats->address = address;
+  }
+
+  stats->transfers++;
+  if ((state == I2CSTATE_NACK) || (state == I2CSTATE_SLA_NACK))
+  {
+    stats->nacks++;
+  }
+  if (state == I2CSTATE_TIMEOUT)
+  {
+    stats->timeouts++;
+  }
+  stats->arbLosses += transfer->retries;
+  stats->bytes += WrIndex + RdIndex;
+  stats->busTime += i2cGetMicroseconds() - transfer->startTime;
+}
+#endif
+
+/*****************************************************************************
+** Function name:	i2cStartHead
+**
+** Descriptions:	Request a (repeated) START for the transfer at the
+**					head of the queue. The rest of the transfer is
+**					handled by the interrupt handler.
+**
+** parameters:		None
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cStartHead( void )
+{
+  WrIndex = 0;
+  RdIndex = 0;
+  i2cHead->startTick = systickGetTicks();
+#if CFG_I2C_STATS > 0
+  i2cHead->startTime = i2cGetMicroseconds();
+#endif
+  I2C_I2CCONSET = I2CONSET_STA;
+}
+
+/*****************************************************************************
+** Function name:	i2cComplete
+**
+** Descriptions:	Finish the transfer at the head of the queue, start
+**					the next one (the START follows any STOP that was
+**					requested) and call the completion callback.
+**					Must be called with the I2C interrupt masked or
+**					from the interrupt handler.
+**
+** parameters:		state - The final I2CSTATE_... value
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cComplete( uint32_t state )
+{
+  i2cTransfer_t *transfer = i2cHead;
+  i2cCallback_t callback = transfer->callback;
+
+#if CFG_I2C_STATS > 0
+  i2cUpdateStats(transfer, state);
+#endif
+
+  i2cHead = transfer->next;
+  if (i2cHead == NULL)
+  {
+    i2cTail = NULL;
+  }
+  else
+  {
+    i2cStartHead();
+  }
+
+  /* Answer our own slave address again (master reads clear AA) */
+  if (i2cSlaveSize)
+  {
+    I2C_I2CCONSET = I2CONSET_AA;
+  }
+
+  /* The transfer belongs to the caller again once its state is final */
+  I2CMasterState = state;
+  transfer->state = state;
+  if (callback != NULL)
+  {
+    callback(transfer);
+  }
+}
+
+/*****************************************************************************
+** Function name:	i2cArbitrationLost
+**
+** Descriptions:	Restart the transfer at the head of the queue after
+**					it lost arbitration.  With a single master this is
+**					caused by a glitch on the bus, so a START is
+**					requested (which the I2C hardware sends once the
+**					bus is free) up to I2C_ARBLOSS_RETRIES times.
+**					After that the transfer is cancelled and any queued
+**					transfer will start once the bus is free again.
+**					Must be called from the interrupt handler.
+**
+** parameters:		transfer - The transfer at the head of the queue
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cArbitrationLost( i2cTransfer_t *transfer )
+{
+  if ( ++transfer->retries <= I2C_ARBLOSS_RETRIES )
+  {
+    I2C_I2CCONSET = I2CONSET_STA;
+  }
+  else
+  {
+    i2cComplete(I2CSTATE_ARB_LOSS);
+  }
+}
+
+/*****************************************************************************
+** Function name:	i2cSlaveService
+**
+** Descriptions:	Handle the slave states of the interrupt handler.
+**					The first byte written after our address is the
+**					register number, after which each byte read or
+**					written moves on to the next register.  Registers
+**					past the end of the map read as 0xFF, and writes
+**					to read-only registers are ACKed but ignored.
+**
+** parameters:		StatValue - The I2C status (0x60..0xC8)
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cSlaveService( uint8_t StatValue )
+{
+	uint8_t data;
+
+	switch ( StatValue )
+	{
+	case 0x60:
+	case 0x68:
+		/*
+		 * Own SLA+W has been received (0x68: after losing arbitration
+		 * as a master); ACK has been returned.  The register number
+		 * follows.
+		 */
+		i2cSlaveFirst = true;
+		I2CSlaveState = I2CSTATE_PENDING;
+		break;
+
+	case 0x80:
+		/*
+		 * Data byte has been received; ACK has been returned.
+		 * Store it in the next register if the register is writable,
+		 * and flag the register for i2cSlavePoll.
+		 */
+		data = I2C_I2CDAT;
+		if ( i2cSlaveFirst )
+		{
+			i2cSlaveReg = data;
+			i2cSlaveFirst = false;
+		}
+		else
+		{
+			if ( I2C_SLAVEBIT(i2cSlaveWritable, i2cSlaveReg) )
+			{
+				i2cSlaveRegisters[i2cSlaveReg] = data;
+				i2cSlaveChanged[i2cSlaveReg >> 3] |= 1 << (i2cSlaveReg & 7);
+				i2cSlaveChangePending = true;
+			}
+			i2cSlaveReg++;
+		}
+		break;
+
+	case 0xA8:
+	case 0xB0:
+		/*
+		 * Own SLA+R has been received (0xB0: after losing arbitration
+		 * as a master); ACK has been returned.  Send the first register.
+		 */
+		I2CSlaveState = I2CSTATE_PENDING;
+		/* fall through */
+	case 0xB8:
+		/*
+		 * Data byte has been transmitted; ACK has been received.
+		 * Send the next register.
+		 */
+		I2C_I2CDAT = i2cSlaveReg < i2cSlaveSize ? i2cSlaveRegisters[i2cSlaveReg] : 0xFF;
+		i2cSlaveReg++;
+		break;
+
+	case 0xA0:
+		/*
+		 * A STOP or repeated START has been received while addressed
+		 * as a slave receiver.
+		 */
+	case 0xC0:
+	case 0xC8:
+		/*
+		 * The master has NACKed a data byte, which ends the read.
+		 */
+		I2CSlaveState = I2CSTATE_IDLE;
+		break;
+
+	default:
+		break;
+	}
+
+	/* Keep answering our own address */
+	I2C_I2CCONSET = I2CONSET_AA;
+	I2C_I2CCONCLR = I2CONCLR_SIC;
+}
 
 /*****************************************************************************
 ** Function name:		I2C_IRQHandler
 **
-** Descriptions:		I2C interrupt handler, deal with master mode only.
+** Descriptions:		I2C interrupt handler.  In master mode the
+**						transfer at the head of the queue is
+**						processed, and the next one is started when it
+**						completes.  Slave states are passed on to
+**						i2cSlaveService.
 **
 ** parameters:			None
 ** Returned value:		None
@@ -39,20 +334,46 @@ volatile uint32_t WrIndex = 0;
 void I2C_IRQHandler(void) 
 {
 	uint8_t StatValue;
+	i2cTransfer_t *transfer = i2cHead;
 
-	/* this handler deals with master read and master write only */
 	StatValue = I2C_I2CSTAT;
+	if ( (StatValue >= 0x60) && (StatValue <= 0xC8) )
+	{
+		/* Addressed as a slave, which also ends a master transfer */
+		if ( ((StatValue == 0x68) || (StatValue == 0xB0)) && (transfer != NULL) )
+		{
+			i2cArbitrationLost(transfer);
+		}
+		i2cSlaveService(StatValue);
+		return;
+	}
+
+	if ( transfer == NULL )
+	{
+		/* The transfer was aborted by i2cPoll, release the bus */
+		I2C_I2CCONSET = I2CONSET_STO;
+		I2C_I2CCONCLR = (I2CONCLR_SIC | I2CONCLR_STAC);
+		return;
+	}
+
 	switch ( StatValue )
 	{
 	case 0x08:
 		/*
 		 * A START condition has been transmitted.
-		 * We now send the slave address and initialize
-		 * the write buffer
-		 * (we always start with a write after START+SLA)
+		 * We now send the slave address, with the R bit set
+		 * only if the transfer has nothing to write.
 		 */
 		WrIndex = 0;
-		I2C_I2CDAT = I2CMasterBuffer[WrIndex++];
+		RdIndex = 0;
+		if ( transfer->regLength || transfer->writeLength || !transfer->readLength )
+		{
+			I2C_I2CDAT = transfer->address & ~RD_BIT;
+		}
+		else
+		{
+			I2C_I2CDAT = transfer->address | RD_BIT;
+		}
 		I2C_I2CCONCLR = (I2CONCLR_SIC | I2CONCLR_STAC);
 		I2CMasterState = I2CSTATE_PENDING;
 		break;
@@ -60,83 +381,78 @@ void I2C_IRQHandler(void)
 	case 0x10:
 		/*
 		 * A repeated START condition has been transmitted.
-		 * Now a second, read, transaction follows so we
-		 * initialize the read buffer.
+		 * Now a second, read, transaction follows.
 		 */
 		RdIndex = 0;
 		/* Send SLA with R bit set, */
-		I2C_I2CDAT = I2CMasterBuffer[WrIndex++];
+		I2C_I2CDAT = transfer->address | RD_BIT;
 		I2C_I2CCONCLR = (I2CONCLR_SIC | I2CONCLR_STAC);
 	break;
 	
 	case 0x18:
+	case 0x28:
 		/*
-		 * SLA+W has been transmitted; ACK has been received.
-		 * We now start writing bytes.
+		 * SLA+W or a data byte has been transmitted; ACK has been
+		 * received. Send the register address, then the data bytes
+		 * from the caller's buffer, and after this check if a read
+		 * transaction should follow.
 		 */
-		I2C_I2CDAT = I2CMasterBuffer[WrIndex++];
+		if ( WrIndex < transfer->regLength )
+		{
+			/* Register address, most significant byte first */
+			I2C_I2CDAT = transfer->reg >> (8 * (transfer->regLength - 1 - WrIndex));
+			WrIndex++;
+		}
+		else if ( WrIndex < transfer->regLength + transfer->writeLength )
+		{
+			/* Keep writing as long as bytes avail */
+			I2C_I2CDAT = transfer->writeBuffer[WrIndex - transfer->regLength];
+			WrIndex++;
+		}
+		else if ( transfer->readLength != 0 )
+		{
+			/* Send a Repeated START to initialize a read transaction */
+			/* (handled in state 0x10)                                */
+			I2C_I2CCONSET = I2CONSET_STA;	/* Set Repeated-start flag */
+		}
+		else
+		{
+			I2C_I2CCONSET = I2CONSET_STO;      /* Set Stop flag */
+			i2cComplete(I2CSTATE_ACK);
+		}
 		I2C_I2CCONCLR = I2CONCLR_SIC;
 		break;
 
 	case 0x20:
+	case 0x48:
 		/*
-		 * SLA+W has been transmitted; NOT ACK has been received.
+		 * SLA+W or SLA+R has been transmitted; NOT ACK has been received.
 		 * Send a stop condition to terminate the transaction
-		 * and signal I2CEngine the transaction is aborted.
+		 * and signal the transfer is aborted.
 		 */
 		I2C_I2CCONSET = I2CONSET_STO;
-		I2C_I2CCONCLR = I2CONCLR_SIC;
-		I2CMasterState = I2CSTATE_SLA_NACK;
-		break;
-
-	case 0x28:
-		/*
-		 * Data in I2DAT has been transmitted; ACK has been received.
-		 * Continue sending more bytes as long as there are bytes to send
-		 * and after this check if a read transaction should follow.
-		 */
-		if ( WrIndex < I2CWriteLength )
-		{
-			/* Keep writing as long as bytes avail */
-			I2C_I2CDAT = I2CMasterBuffer[WrIndex++];
-		}
-		else
-		{
-			if ( I2CReadLength != 0 )
-			{
-				/* Send a Repeated START to initialize a read transaction */
-				/* (handled in state 0x10)                                */
-				I2C_I2CCONSET = I2CONSET_STA;	/* Set Repeated-start flag */
-			}
-			else
-			{
-				I2CMasterState = I2CSTATE_ACK;
-				I2C_I2CCONSET = I2CONSET_STO;      /* Set Stop flag */
-			}
-		}
+		i2cComplete(I2CSTATE_SLA_NACK);
 		I2C_I2CCONCLR = I2CONCLR_SIC;
 		break;
 
 	case 0x30:
 		/*
 		 * Data byte in I2DAT has been transmitted; NOT ACK has been received
-		 * Send a STOP condition to terminate the transaction and inform the
-		 * I2CEngine that the transaction failed.
+		 * Send a STOP condition to terminate the transaction and signal
+		 * that the transfer failed.
 		 */
 		I2C_I2CCONSET = I2CONSET_STO;
+		i2cComplete(I2CSTATE_NACK);
 		I2C_I2CCONCLR = I2CONCLR_SIC;
-		I2CMasterState = I2CSTATE_NACK;
 		break;
 
 	case 0x38:
 		/*
 		 * Arbitration loss in SLA+R/W or Data bytes.
-		 * This is a fatal condition, the transaction did not complete due
-		 * to external reasons (e.g. hardware system failure).
-		 * Inform the I2CEngine of this and cancel the transaction
-		 * (this is automatically done by the I2C hardware)
+		 * The transfer is retried or cancelled (the bus is released
+		 * automatically by the I2C hardware).
 		 */
-		I2CMasterState = I2CSTATE_ARB_LOSS;
+		i2cArbitrationLost(transfer);
 		I2C_I2CCONCLR = I2CONCLR_SIC;
 		break;
 
@@ -147,7 +463,7 @@ void I2C_IRQHandler(void)
 		 * Since a NOT ACK is sent after reading the last byte,
 		 * we need to prepare a NOT ACK in case we only read 1 byte.
 		 */
-		if ( I2CReadLength == 1 )
+		if ( transfer->readLength == 1 )
 		{
 			/* last (and only) byte: send a NACK after data is received */
 			I2C_I2CCONCLR = I2CONCLR_AAC;
@@ -160,27 +476,16 @@ void I2C_IRQHandler(void)
 		I2C_I2CCONCLR = I2CONCLR_SIC;
 		break;
 
-	case 0x48:
-		/*
-		 * SLA+R has been transmitted; NOT ACK has been received.
-		 * Send a stop condition to terminate the transaction
-		 * and signal I2CEngine the transaction is aborted.
-		 */
-		I2C_I2CCONSET = I2CONSET_STO;
-		I2C_I2CCONCLR = I2CONCLR_SIC;
-		I2CMasterState = I2CSTATE_SLA_NACK;
-		break;
-
 	case 0x50:
 		/*
 		 * Data byte has been received; ACK has been returned.
 		 * Read the byte and check for more bytes to read.
 		 * Send a NOT ACK after the last byte is received
 		 */
-		I2CSlaveBuffer[RdIndex++] = I2C_I2CDAT;
-		if ( RdIndex < (I2CReadLength-1) )
+		transfer->readBuffer[RdIndex++] = I2C_I2CDAT;
+		if ( RdIndex < (transfer->readLength-1) )
 		{
-			/* lmore bytes to follow: send an ACK after data is received */
+			/* more bytes to follow: send an ACK after data is received */
 			I2C_I2CCONSET = I2CONSET_AA;
 		}
 		else
@@ -195,12 +500,11 @@ void I2C_IRQHandler(void)
 		/*
 		 * Data byte has been received; NOT ACK has been returned.
 		 * This is the last byte to read.
-		 * Generate a STOP condition and flag the I2CEngine that the
-		 * transaction is finished.
+		 * Generate a STOP condition and complete the transfer.
 		 */
-		I2CSlaveBuffer[RdIndex++] = I2C_I2CDAT;
-		I2CMasterState = I2CSTATE_ACK;
+		transfer->readBuffer[RdIndex++] = I2C_I2CDAT;
 		I2C_I2CCONSET = I2CONSET_STO;	/* Set Stop flag */
+		i2cComplete(I2CSTATE_ACK);
 		I2C_I2CCONCLR = I2CONCLR_SIC;	/* Clear SI flag */
 		break;
 
@@ -212,56 +516,6 @@ void I2C_IRQHandler(void)
   return;
 }
 
-/*****************************************************************************
-** Function name:	I2CStart
-**
-** Descriptions:	Create I2C start condition, a timeout
-**					value is set if the I2C never gets started,
-**					and timed out. It's a fatal error.
-**
-** parameters:		None
-** Returned value:	true or false, return false if timed out
-** 
-*****************************************************************************/
-static uint32_t I2CStart( void )
-{
-	uint32_t timeout = 0;
-
-	/*--- Issue a start condition ---*/
-	I2C_I2CCONSET = I2CONSET_STA;	/* Set Start flag */
-    
-	while((I2CMasterState != I2CSTATE_PENDING) && (timeout < MAX_TIMEOUT))
-	{
-		timeout++;
-	}
-
-	return (timeout < MAX_TIMEOUT);
-}
-
-/*****************************************************************************
-** Function name:	I2CStop
-**
-** Descriptions:	Set the I2C stop condition
-**
-** parameters:		None
-** Returned value:	true or never return
-** 
-*****************************************************************************/
-static uint32_t I2CStop( void )
-{
-	uint32_t timeout = 0;
-
-	I2C_I2CCONSET = I2CONSET_STO;      /* Set Stop flag */
-	I2C_I2CCONCLR = I2CONCLR_SIC;  /* Clear SI flag */
-
-	/*--- Wait for STOP detected ---*/
-	while((I2C_I2CCONSET & I2CONSET_STO) && (timeout < MAX_TIMEOUT))
-	{
-		timeout++;
-	}
-	return (timeout >= MAX_TIMEOUT);
-}
-
 /*****************************************************************************
 ** Function name:	I2CInit
 **
@@ -287,6 +541,9 @@ uint32_t i2cInit( uint32_t I2cMode )
   IOCON_PIO0_5 &= ~(IOCON_PIO0_5_FUNC_MASK | IOCON_PIO0_5_I2CMODE_MASK);
   IOCON_PIO0_5 |= IOCON_PIO0_5_FUNC_I2CSDA;
 
+  // Free the bus if a slave was left holding SDA by a reset
+  i2cRecoverBus();
+
   // Clear flags
   I2C_I2CCONCLR = I2C_I2CCONCLR_AAC | 
                   I2C_I2CCONCLR_SIC | 
@@ -313,38 +570,505 @@ uint32_t i2cInit( uint32_t I2cMode )
   NVIC_EnableIRQ(I2C_IRQn);
   I2C_I2CCONSET = I2C_I2CCONSET_I2EN;
 
+  /* Keep answering our own address if slave mode is in use */
+  if ( i2cSlaveSize )
+  {
+    I2C_I2CCONSET = I2CONSET_AA;
+  }
+
   return( TRUE );
 }
 
 /*****************************************************************************
-** Function name:	I2CEngine
+** Function name:	i2cSubmit
 **
-** Descriptions:	The routine to complete a I2C transaction
-**					from start to stop. All the intermitten
-**					steps are handled in the interrupt handler.
-**					Before this routine is called, the read
-**					length, write length and I2C master buffer
-**					need to be filled.
+** Descriptions:	Queue a transfer without waiting for it to finish.
+**					The transfer writes the regLength byte register
+**					address in reg and writeLength bytes from
+**					writeBuffer, then (after a repeated START) reads
+**					readLength bytes into readBuffer.  Any of the
+**					lengths can be zero, and a transfer with none just
+**					checks that the slave ACKs its address.  The data
+**					goes directly to and from the caller's buffers, so
+**					there is no limit on the length.
+**
+**					The transfer and its buffers belong to the I2C
+**					driver until its state is no longer
+**					I2CSTATE_PENDING.  The callback, if any, is then
+**					called from the I2C interrupt handler (or from
+**					i2cPoll on a timeout) and may submit new transfers.
+**
+** parameters:		transfer - The transfer to queue
+** Returned value:	true or false, return false if the transfer is
+**					invalid
+** 
+*****************************************************************************/
+bool i2cSubmit( i2cTransfer_t *transfer )
+{
+  if ((transfer == NULL) ||
+      (transfer->writeLength && (transfer->writeBuffer == NULL)) ||
+      (transfer->readLength && (transfer->readBuffer == NULL)))
+  {
+    return false;
+  }
+
+  transfer->state = I2CSTATE_PENDING;
+  transfer->retries = 0;
+  transfer->next = NULL;
+
+  NVIC_DisableIRQ(I2C_IRQn);
+  if (i2cTail == NULL)
+  {
+    /* The bus is idle so start straight away */
+    i2cHead = i2cTail = transfer;
+    i2cStartHead();
+  }
+  else
+  {
+    i2cTail->next = transfer;
+    i2cTail = transfer;
+  }
+  NVIC_EnableIRQ(I2C_IRQn);
+
+  return true;
+}
+
+/*****************************************************************************
+** Function name:	i2cPoll
+**
+** Descriptions:	Abort the transfer on the bus if it has taken
+**					longer than its timeout, recovering the bus (see
+**					i2cRecoverBus), completing the transfer with
+**					I2CSTATE_TIMEOUT and starting the next one.  This
+**					should be called regularly from the main loop, and
+**					is called by i2cTransfer while it waits.
 **
 ** parameters:		None
+** Returned value:	None
+** 
+*****************************************************************************/
+void i2cPoll( void )
+{
+  i2cTransfer_t *transfer;
+  uint32_t timeout;
+
+  if (i2cHead == NULL)
+  {
+    return;
+  }
+
+  NVIC_DisableIRQ(I2C_IRQn);
+  transfer = i2cHead;
+  if (transfer != NULL)
+  {
+    timeout = transfer->timeout;
+    if (timeout == 0)
+    {
+      /* Allow for the length of the transfer */
+      timeout = I2C_TIMEOUT_MS + (transfer->regLength + transfer->writeLength + 
+                                  transfer->readLength) / I2C_BYTES_PER_MS;
+    }
+    if ((systickGetTicks() - transfer->startTick) * CFG_SYSTICK_DELAY_IN_MS > timeout)
+    {
+      /* A slave holding SDA low would block every later transfer too */
+      i2cRecoverBus();
+      i2cComplete(I2CSTATE_TIMEOUT);
+    }
+  }
+  NVIC_EnableIRQ(I2C_IRQn);
+}
+
+/*****************************************************************************
+** Function name:	i2cTransfer
+**
+** Descriptions:	Queue a transfer and wait for it to finish (see
+**					i2cSubmit).  Must not be called from an interrupt
+**					handler or with interrupts disabled.
+**
+** parameters:		transfer - The transfer to perform
 ** Returned value:	Any of the I2CSTATE_... values. See i2c.h
 ** 
 *****************************************************************************/
-uint32_t i2cEngine( void ) 
+uint32_t i2cTransfer( i2cTransfer_t *transfer )
 {
-  I2CMasterState = I2CSTATE_IDLE;
-  RdIndex = 0;
-  WrIndex = 0;
-  if ( I2CStart() != TRUE )
+  if (!i2cSubmit(transfer))
   {
-	I2CStop();
-	return ( FALSE );
+    return ( FALSE );
   }
 
   /* wait until the state is a terminal state */
-  while (I2CMasterState < 0x100);
+  while (transfer->state < 0x100)
+  {
+    i2cPoll();
+  }
+
+  return ( transfer->state );
+}
+
+/*****************************************************************************
+** Function name:	i2cWriteReg
+**
+** Descriptions:	Write length bytes from buffer to a slave, after
+**					the regLength byte register address in reg (most
+**					significant byte first), and wait for the transfer
+**					to finish.
+**
+** parameters:		address - 8-bit slave address
+**					reg, regLength - Register address and its size in
+**					bytes (0..4)
+**					buffer, length - Data to write (buffer may be NULL
+**					if length is 0)
+** Returned value:	Any of the I2CSTATE_... values. See i2c.h
+** 
+*****************************************************************************/
+uint32_t i2cWriteReg( uint8_t address, uint32_t reg, uint8_t regLength, const uint8_t *buffer, uint32_t length )
+{
+  i2cTransfer_t transfer = { 0 };
+
+  transfer.address = address;
+  transfer.reg = reg;
+  transfer.regLength = regLength;
+  transfer.writeBuffer = buffer;
+  transfer.writeLength = length;
 
-  return ( I2CMasterState );
+  return ( i2cTransfer(&transfer) );
+}
+
+/*****************************************************************************
+** Function name:	i2cReadReg
+**
+** Descriptions:	Write the regLength byte register address in reg
+**					(most significant byte first) to a slave, then read
+**					length bytes into buffer after a repeated START, and
+**					wait for the transfer to finish.  With a regLength
+**					of 0 the slave is read straight away.
+**
+** parameters:		address - 8-bit slave address
+**					reg, regLength - Register address and its size in
+**					bytes (0..4)
+**					buffer, length - Buffer for the data read
+** Returned value:	Any of the I2CSTATE_... values. See i2c.h
+** 
+*****************************************************************************/
+uint32_t i2cReadReg( uint8_t address, uint32_t reg, uint8_t regLength, uint8_t *buffer, uint32_t length )
+{
+  i2cTransfer_t transfer = { 0 };
+
+  transfer.address = address;
+  transfer.reg = reg;
+  transfer.regLength = regLength;
+  transfer.readBuffer = buffer;
+  transfer.readLength = length;
+
+  return ( i2cTransfer(&transfer) );
+}
+
+/*****************************************************************************
+** Function name:	i2cRecoveryDelay
+**
+** Descriptions:	Busy wait for about half an SCL period at 100kHz
+**
+** parameters:		None
+** Returned value:	None
+** 
+*****************************************************************************/
+static void i2cRecoveryDelay( void )
+{
+  volatile uint32_t i;
+
+  for (i = 0; i < I2C_RECOVERY_DELAY; i++);
+}
+
+/*****************************************************************************
+** Function name:	i2cRecoverBus
+**
+** Descriptions:	Free the bus after a slave was left driving SDA
+**					low, e.g. by a reset or a glitch in the middle of
+**					a read.  SCL (pin 0.4) is clocked as a GPIO until
+**					the slave releases SDA (pin 0.5), at most 9 times,
+**					then a START and a STOP reset any slave state
+**					machine.  Both pins are open drain in every mode,
+**					so a 1 just releases the line.  The I2C block is
+**					disabled while this happens, so this must not be
+**					called while a transfer is on the bus.  i2cInit
+**					and i2cPoll (after a timeout) call it.
+**
+** parameters:		None
+** Returned value:	true or false, return false if SDA or SCL is
+**					still low (e.g. a slave holding SCL)
+** 
+*****************************************************************************/
+bool i2cRecoverBus( void )
+{
+  uint32_t i;
+  bool released;
+
+  /* Disable the I2C block and take over both pins */
+  I2C_I2CCONCLR = I2CONCLR_I2ENC | I2CONCLR_STAC | I2CONCLR_SIC | I2CONCLR_AAC;
+  gpioSetValue(0, 4, 1);
+  gpioSetValue(0, 5, 1);
+  gpioSetDir(0, 4, gpioDirection_Output);
+  gpioSetDir(0, 5, gpioDirection_Output);
+  IOCON_PIO0_4 &= ~IOCON_PIO0_4_FUNC_MASK;
+  IOCON_PIO0_5 &= ~IOCON_PIO0_5_FUNC_MASK;
+  i2cRecoveryDelay();
+
+  if (!gpioGetValue(0, 4) || !gpioGetValue(0, 5))
+  {
+    i2cRecoveries++;
+  }
+
+  /* Clock out the rest of whatever byte the slave is sending */
+  for (i = 0; (i < 9) && !gpioGetValue(0, 5); i++)
+  {
+    gpioSetValue(0, 4, 0);
+    i2cRecoveryDelay();
+    gpioSetValue(0, 4, 1);
+    i2cRecoveryDelay();
+  }
+
+  /* START then STOP, with SCL high */
+  gpioSetValue(0, 5, 0);
+  i2cRecoveryDelay();
+  gpioSetValue(0, 5, 1);
+  i2cRecoveryDelay();
+  released = gpioGetValue(0, 4) && gpioGetValue(0, 5);
+
+  /* Give the pins back to the I2C block */
+  gpioSetDir(0, 4, gpioDirection_Input);
+  gpioSetDir(0, 5, gpioDirection_Input);
+  IOCON_PIO0_4 |= IOCON_PIO0_4_FUNC_I2CSCL;
+  IOCON_PIO0_5 |= IOCON_PIO0_5_FUNC_I2CSDA;
+  I2C_I2CCONSET = I2CONSET_I2EN;
+
+  /* Any slave transaction was cut off by the recovery */
+  I2CSlaveState = I2CSTATE_IDLE;
+  if (i2cSlaveSize)
+  {
+    I2C_I2CCONSET = I2CONSET_AA;
+  }
+
+  return released;
+}
+
+/*****************************************************************************
+** Function name:	i2cGetRecoveries
+**
+** Descriptions:	Number of times i2cRecoverBus found SDA or SCL
+**					held low
+**
+** parameters:		None
+** Returned value:	The number of recoveries
+** 
+*****************************************************************************/
+uint32_t i2cGetRecoveries( void )
+{
+  return i2cRecoveries;
+}
+
+#if CFG_I2C_STATS > 0
+/*****************************************************************************
+** Function name:	i2cGetStats
+**
+** Descriptions:	Copy the transfer statistics of each slave address
+**					seen so far (in the order they were first used).
+**
+** parameters:		stats - Buffer for up to count entries
+**					count - Size of the buffer in entries
+** Returned value:	The number of entries copied
+** 
+*****************************************************************************/
+uint32_t i2cGetStats( i2cStats_t *stats, uint32_t count )
+{
+  NVIC_DisableIRQ(I2C_IRQn);
+  if (count > i2cStatsUsed)
+  {
+    count = i2cStatsUsed;
+  }
+  memcpy(stats, i2cStats, count * sizeof(i2cStats_t));
+  NVIC_EnableIRQ(I2C_IRQn);
+
+  return count;
+}
+
+/*****************************************************************************
+** Function name:	i2cResetStats
+**
+** Descriptions:	Clear the statistics of all slave addresses and
+**					the recovery count
+**
+** parameters:		None
+** Returned value:	None
+** 
+*****************************************************************************/
+void i2cResetStats( void )
+{
+  NVIC_DisableIRQ(I2C_IRQn);
+  memset(i2cStats, 0, sizeof(i2cStats));
+  i2cStatsUsed = 0;
+  i2cRecoveries = 0;
+  NVIC_EnableIRQ(I2C_IRQn);
+}
+#endif
+
+/*****************************************************************************
+** Function name:	i2cSlaveInit
+**
+** Descriptions:	Answer the 8-bit slave address with the register
+**					file in map, which is served directly from the I2C
+**					interrupt handler.  A master writes the register
+**					number first, then reads or writes any number of
+**					registers from there (the register number
+**					increments after each byte).  Registers are
+**					read-only unless they are in an I2CSLAVE_RW region;
+**					later regions override earlier ones.  Master
+**					transfers can still be made, and i2cInit can be
+**					called again by other drivers.
+**
+**					Registers written by the master are passed to the
+**					map's callback by i2cSlavePoll, and the
+**					application changes registers with i2cSlaveUpdate.
+**
+** parameters:		address - 8-bit slave address (R/W bit ignored)
+**					map - Register file (size 1..256).  The register
+**					storage must stay valid, the map itself is not
+**					used after this call.
+** Returned value:	true or false, return false if the map is invalid
+** 
+*****************************************************************************/
+bool i2cSlaveInit( uint8_t address, const i2cSlaveMap_t *map )
+{
+  const i2cSlaveRegion_t *region;
+  uint32_t i, reg;
+
+  if ((map == NULL) || (map->registers == NULL) ||
+      (map->size == 0) || (map->size > 256) ||
+      (map->regionCount && (map->regions == NULL)))
+  {
+    return false;
+  }
+
+  i2cInit(I2CSLAVE);
+
+  NVIC_DisableIRQ(I2C_IRQn);
+  memset(i2cSlaveWritable, 0, sizeof(i2cSlaveWritable));
+  memset(i2cSlaveChanged, 0, sizeof(i2cSlaveChanged));
+  for (i = 0; i < map->regionCount; i++)
+  {
+    region = &map->regions[i];
+    for (reg = region->first; (reg < region->first + region->count) && (reg < map->size); reg++)
+    {
+      if (region->access == I2CSLAVE_RW)
+      {
+        i2cSlaveWritable[reg >> 3] |= 1 << (reg & 7);
+      }
+      else
+      {
+        i2cSlaveWritable[reg >> 3] &= ~(1 << (reg & 7));
+      }
+    }
+  }
+  i2cSlaveRegisters = map->registers;
+  i2cSlaveSize = map->size;
+  i2cSlaveCallback = map->callback;
+  i2cSlaveChangePending = false;
+  I2CSlaveState = I2CSTATE_IDLE;
+
+  I2C_I2CADR0 = address & ~I2C_I2CADR0_GC_MASK;
+  I2C_I2CCONSET = I2CONSET_AA;
+  NVIC_EnableIRQ(I2C_IRQn);
+
+  return true;
+}
+
+/*****************************************************************************
+** Function name:	i2cSlaveUpdate
+**
+** Descriptions:	Copy new values into the slave register file.  The
+**					copy is refused while a master is reading or
+**					writing registers, so that a multi-byte value is
+**					never seen half updated; try again later.
+**
+** parameters:		reg - First register to update
+**					buffer, length - New register values
+** Returned value:	true or false, return false if the registers
+**					were not updated
+** 
+*****************************************************************************/
+bool i2cSlaveUpdate( uint8_t reg, const uint8_t *buffer, uint32_t length )
+{
+  bool updated = false;
+
+  if (reg + length > i2cSlaveSize)
+  {
+    return false;
+  }
+
+  NVIC_DisableIRQ(I2C_IRQn);
+  if (I2CSlaveState == I2CSTATE_IDLE)
+  {
+    memcpy(&i2cSlaveRegisters[reg], buffer, length);
+    updated = true;
+  }
+  NVIC_EnableIRQ(I2C_IRQn);
+
+  return updated;
+}
+
+/*****************************************************************************
+** Function name:	i2cSlavePoll
+**
+** Descriptions:	Pass the registers written by a master since the
+**					last call to the register map's callback, once per
+**					run of consecutive registers.  Nothing is reported
+**					until the master has finished writing.  This should
+**					be called regularly from the main loop.
+**
+** parameters:		None
+** Returned value:	None
+** 
+*****************************************************************************/
+void i2cSlavePoll( void )
+{
+  uint8_t changed[sizeof(i2cSlaveChanged)];
+  uint32_t reg, first;
+
+  if (!i2cSlaveChangePending)
+  {
+    return;
+  }
+
+  NVIC_DisableIRQ(I2C_IRQn);
+  if (I2CSlaveState != I2CSTATE_IDLE)
+  {
+    NVIC_EnableIRQ(I2C_IRQn);
+    return;
+  }
+  memcpy(changed, i2cSlaveChanged, sizeof(changed));
+  memset(i2cSlaveChanged, 0, sizeof(i2cSlaveChanged));
+  i2cSlaveChangePending = false;
+  NVIC_EnableIRQ(I2C_IRQn);
+
+  if (i2cSlaveCallback == NULL)
+  {
+    return;
+  }
+
+  reg = 0;
+  while (reg < i2cSlaveSize)
+  {
+    if (!I2C_SLAVEBIT(changed, reg))
+    {
+      reg++;
+      continue;
+    }
+    first = reg;
+    while ((reg < i2cSlaveSize) && I2C_SLAVEBIT(changed, reg))
+    {
+      reg++;
+    }
+    i2cSlaveCallback(first, reg - first);
+  }
 }
 
 /******************************************************************************
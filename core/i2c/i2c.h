@@ -26,9 +26,12 @@
  * SLA_NACK - The transaction is aborted since the slave returned a NACK on the SLA
  *            this can be intentional (e.g. an 24LC08 EEPROM states it is busy)
  *            or the slave is not available/accessible at all.
- * ARB_LOSS - Arbitration loss during any part of the transaction.
+ * ARB_LOSS - Arbitration loss during any part of the transaction, after
+ *            I2C_ARBLOSS_RETRIES retries.
  *            This could only happen in a multi master system or could also
  *            identify a hardware problem in the system.
+ * TIMEOUT  - The transaction didn't finish within its timeout and was
+ *            aborted by i2cPoll, which then recovers the bus.
  */
 #define I2CSTATE_IDLE     0x000
 #define I2CSTATE_PENDING  0x001
@@ -36,11 +39,15 @@
 #define I2CSTATE_NACK     0x102
 #define I2CSTATE_SLA_NACK 0x103
 #define I2CSTATE_ARB_LOSS 0x104
+#define I2CSTATE_TIMEOUT  0x105
 
 #define FAST_MODE_PLUS    0
 
-#define I2C_BUFSIZE       6
 #define MAX_TIMEOUT       0x00FFFFFF
+#define I2C_TIMEOUT_MS    CFG_I2C_TIMEOUT_MS  /* Default transfer timeout ... */
+#define I2C_BYTES_PER_MS  10          /* ... plus 1ms per 10 bytes (100kHz) */
+#define I2C_ARBLOSS_RETRIES 2         /* Restarts after an arbitration loss */
+#define I2C_RECOVERY_DELAY (CFG_CPU_CCLK / 1000000) /* ~5us, half a 100kHz SCL period */
 
 #define I2CMASTER         0x01
 #define I2CSLAVE          0x02
@@ -69,13 +76,89 @@
 #define I2SCLL_HS_SCLL    0x00000020  /* Fast Plus I2C SCL Duty Cycle Low Reg */
 
 
-extern volatile uint8_t I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t I2CReadLength, I2CWriteLength;
+/*
+ * A queued I2C transfer (see i2cSubmit).  The caller owns the transfer
+ * and its buffers, which must stay valid until the state is final.
+ */
+typedef struct i2cTransfer_s i2cTransfer_t;
+typedef void (*i2cCallback_t)( i2cTransfer_t *transfer );
+
+struct i2cTransfer_s
+{
+  uint8_t           address;      /* 8-bit slave address (R/W bit ignored) */
+  uint8_t           regLength;    /* Size of reg in bytes (0..4) */
+  uint32_t          reg;          /* Register address, sent MSB first before writeBuffer */
+  const uint8_t    *writeBuffer;  /* Bytes to write, may be NULL if writeLength is 0 */
+  uint32_t          writeLength;
+  uint8_t          *readBuffer;   /* Bytes read after a repeated START */
+  uint32_t          readLength;
+  uint32_t          timeout;      /* Timeout in ms, 0 for a default based on the length */
+  i2cCallback_t     callback;     /* Called on completion, may be NULL */
+  void             *context;      /* Not used by the driver */
+  volatile uint32_t state;        /* I2CSTATE_PENDING until completed */
+  uint32_t          startTick;    /* Used internally */
+  uint32_t          startTime;    /* Used internally */
+  uint8_t           retries;      /* Used internally */
+  i2cTransfer_t    *next;         /* Used internally */
+};
+
+/*
+ * Transfer statistics for one slave address (see i2cGetStats).  The
+ * first CFG_I2C_STATS addresses used get an entry.
+ */
+typedef struct
+{
+  uint8_t           address;      /* 8-bit slave address (R/W bit cleared) */
+  uint32_t          transfers;    /* Completed transfers, including failed ones */
+  uint32_t          nacks;        /* Transfers NACKed on the address or data */
+  uint32_t          timeouts;     /* Transfers aborted by i2cPoll */
+  uint32_t          arbLosses;    /* Arbitration losses, including retried ones */
+  uint32_t          bytes;        /* Bytes sent or received, including reg */
+  uint32_t          busTime;      /* Time in us from START to completion */
+} i2cStats_t;
+
+/*
+ * The register file served in slave mode (see i2cSlaveInit).  Registers
+ * are read-only unless they are in an I2CSLAVE_RW region.
+ */
+#define I2CSLAVE_RO       0x00
+#define I2CSLAVE_RW       0x01
+
+typedef struct
+{
+  uint8_t           first;        /* First register in the region */
+  uint16_t          count;        /* Number of registers (up to 256) */
+  uint8_t           access;       /* I2CSLAVE_RO or I2CSLAVE_RW */
+} i2cSlaveRegion_t;
+
+/* Called by i2cSlavePoll with each run of registers written by the master */
+typedef void (*i2cSlaveCallback_t)( uint8_t reg, uint32_t count );
+
+typedef struct
+{
+  uint8_t          *registers;    /* Register storage, served by the ISR */
+  uint32_t          size;         /* Number of registers (1..256) */
+  const i2cSlaveRegion_t *regions;
+  uint32_t          regionCount;
+  i2cSlaveCallback_t callback;    /* May be NULL */
+} i2cSlaveMap_t;
 
 extern void I2C_IRQHandler( void );
 extern uint32_t i2cInit( uint32_t I2cMode );
-extern uint32_t i2cEngine( void );
+extern bool i2cSubmit( i2cTransfer_t *transfer );
+extern uint32_t i2cTransfer( i2cTransfer_t *transfer );
+extern void i2cPoll( void );
+extern uint32_t i2cWriteReg( uint8_t address, uint32_t reg, uint8_t regLength, const uint8_t *buffer, uint32_t length );
+extern uint32_t i2cReadReg( uint8_t address, uint32_t reg, uint8_t regLength, uint8_t *buffer, uint32_t length );
+extern bool i2cRecoverBus( void );
+extern bool i2cSlaveInit( uint8_t address, const i2cSlaveMap_t *map );
+extern bool i2cSlaveUpdate( uint8_t reg, const uint8_t *buffer, uint32_t length );
+extern void i2cSlavePoll( void );
+extern uint32_t i2cGetRecoveries( void );
+#if CFG_I2C_STATS > 0
+extern uint32_t i2cGetStats( i2cStats_t *stats, uint32_t count );
+extern void i2cResetStats( void );
+#endif
 
 #endif /* end __I2C_H */
 /****************************************************************************
@@ -0,0 +1,59 @@
+/**************************************************************************/
+/*! 
+    @file     printf.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#ifndef __PRINTF_H__
+#define __PRINTF_H__
+
+#include <stdarg.h>
+#include <stdint.h>
+
+/**************************************************************************/
+/*! 
+    @brief  Output sink for the printf engine in core/libc/stdio.c.
+
+    Formatted text is passed to the sink in short runs as it is generated,
+    rather than being assembled into one string first.  'data' is not
+    NULL-terminated, and is only valid until the sink returns.
+*/
+/**************************************************************************/
+typedef void (*printfSink_t)(void *context, const char *data, uint32_t length);
+
+void       printfSetSink(printfSink_t sink, void *context);
+void       printfWrite(const char *data, uint32_t length);
+signed int vprintfSink(printfSink_t sink, void *context, const char *pFormat, va_list ap);
+signed int printfSink(printfSink_t sink, void *context, const char *pFormat, ...);
+
+#endif
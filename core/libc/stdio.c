@@ -38,14 +38,41 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <string.h>
+
+#include "core/libc/printf.h"
 
 //------------------------------------------------------------------------------
 //         Local Definitions
 //------------------------------------------------------------------------------
 
-// Maximum string size allowed (in bytes).
+// Maximum string size allowed (in bytes) for vsprintf and sprintf.
 #define MAX_STRING_SIZE         255
 
+// Number of formatted characters collected before they are handed to the
+// output sink.  Literal text from the format string is passed on directly.
+#define PRINTF_CHUNK_SIZE       32
+
+// Enough digits for the largest 64-bit value in decimal.
+#define PRINTF_DIGITS_SIZE      20
+
+// State of one formatted output stream.
+typedef struct {
+
+    printfSink_t  sink;
+    void          *context;
+    signed int    count;
+    unsigned int  used;
+    char          chunk[PRINTF_CHUNK_SIZE];
+} PrintfStream;
+
+// Destination of the memory sink used by vsnprintf.
+typedef struct {
+
+    char    *pStr;
+    size_t  left;
+} PrintfBuffer;
+
 //------------------------------------------------------------------------------
 //         Global Variables
 //------------------------------------------------------------------------------
@@ -54,331 +81,464 @@
 //struct _reent r = {0, (FILE*) 0, (FILE*) 1, (FILE*) 0};
 //struct _reent *_impure_ptr = &r;
 
+// Sends a block of characters to the stdout end point (see sysinit.c).
+extern void __putdata(const char *data, uint32_t length);
+
+static void StdoutSink(void *context, const char *data, uint32_t length);
+
+// Current printf output sink.
+static printfSink_t stdoutSink = StdoutSink;
+static void *stdoutContext = 0;
+
 //------------------------------------------------------------------------------
 //         Local Functions
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-// Writes a character inside the given string. Returns 1.
-// \param pStr  Storage string.
-// \param c  Character to write.
+// Default printf sink, which writes to the UART or USB CDC end point.
 //------------------------------------------------------------------------------
-signed int append_char(char *pStr, char c)
+static void StdoutSink(void *context, const char *data, uint32_t length)
 {
-    *pStr = c;
-    return 1;
+    __putdata(data, length);
 }
 
 //------------------------------------------------------------------------------
-// Writes a string inside the given string.
-// Returns the size of the written
-// string.
-// \param pStr  Storage string.
-// \param pSource  Source string.
+// Memory sink, which stores as much of the output as fits in the buffer.
+// \param context  PrintfBuffer instance.
 //------------------------------------------------------------------------------
-signed int PutString(char *pStr, char fill, signed int width, const char *pSource)
+static void BufferSink(void *context, const char *data, uint32_t length)
 {
-    signed int num = 0;
+    PrintfBuffer *pBuffer = (PrintfBuffer *) context;
 
-    while (*pSource != 0) {
+    if (length > pBuffer->left) {
 
-        *pStr++ = *pSource++;
-        num++;
+        length = pBuffer->left;
     }
+    memcpy(pBuffer->pStr, data, length);
+    pBuffer->pStr += length;
+    pBuffer->left -= length;
+}
 
-	width -= num;
-	while (width > 0) {
-
-        *pStr++ = fill;
-		num++;
-		width--;
-	}
+//------------------------------------------------------------------------------
+// Passes any characters collected in the stream to its sink.
+// \param pStream  Output stream.
+//------------------------------------------------------------------------------
+static void Flush(PrintfStream *pStream)
+{
+    if (pStream->used > 0) {
 
-    return num;
+        pStream->sink(pStream->context, pStream->chunk, pStream->used);
+        pStream->used = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
-// Writes an unsigned int inside the given string, using the provided fill &
-// width parameters.
-// Returns the size in characters of the written integer.
-// \param pStr  Storage string.
-// \param fill  Fill character.
-// \param width  Minimum integer width.
-// \param value  Integer value.
+// Writes a character to the given stream.
+// \param pStream  Output stream.
+// \param c  Character to write.
 //------------------------------------------------------------------------------
-signed int PutUnsignedInt(
-    char *pStr,
-    char fill,
-    signed int width,
-    unsigned int value)
+static void PutChar(PrintfStream *pStream, char c)
 {
-    signed int num = 0;
+    if (pStream->used == PRINTF_CHUNK_SIZE) {
 
-    // Take current digit into account when calculating width
-    width--;
+        Flush(pStream);
+    }
+    pStream->chunk[pStream->used++] = c;
+    pStream->count++;
+}
 
-    // Recursively write upper digits
-    if ((value / 10) > 0) {
+//------------------------------------------------------------------------------
+// Writes a block of characters to the given stream.  Short blocks are
+// collected with the surrounding output, longer ones are passed straight
+// to the sink.
+// \param pStream  Output stream.
+// \param pData  Characters to write.
+// \param length  Number of characters.
+//------------------------------------------------------------------------------
+static void PutData(PrintfStream *pStream, const char *pData, unsigned int length)
+{
+    if (length <= PRINTF_CHUNK_SIZE - pStream->used) {
 
-        num = PutUnsignedInt(pStr, fill, width, value / 10);
-        pStr += num;
+        memcpy(&pStream->chunk[pStream->used], pData, length);
+        pStream->used += length;
     }
-    // Write filler characters
     else {
 
-        while (width > 0) {
-
-            append_char(pStr, fill);
-            pStr++;
-            num++;
-            width--;
-        }
+        Flush(pStream);
+        pStream->sink(pStream->context, pData, length);
     }
+    pStream->count += length;
+}
 
-    // Write lower digit
-    num += append_char(pStr, (value % 10) + '0');
+//------------------------------------------------------------------------------
+// Writes width copies of the fill character to the given stream.
+// \param pStream  Output stream.
+// \param fill  Fill character.
+// \param width  Number of characters to write (may be negative).
+//------------------------------------------------------------------------------
+static void PutFill(PrintfStream *pStream, char fill, signed int width)
+{
+    while (width > 0) {
 
-    return num;
+        PutChar(pStream, fill);
+        width--;
+    }
 }
 
 //------------------------------------------------------------------------------
-// Writes a signed int inside the given string, using the provided fill & width
-// parameters.
-// Returns the size of the written integer.
-// \param pStr  Storage string.
+// Writes a string to the given stream, padded to the given width.
+// \param pStream  Output stream.
 // \param fill  Fill character.
-// \param width  Minimum integer width.
-// \param value  Signed integer value.
+// \param width  Minimum string width.
+// \param left  Pad on the right instead of the left.
+// \param pSource  Source string.
 //------------------------------------------------------------------------------
-signed int PutSignedInt(
-    char *pStr,
+static void PutString(
+    PrintfStream *pStream,
     char fill,
     signed int width,
-    signed int value)
+    unsigned char left,
+    const char *pSource)
 {
-    signed int num = 0;
-    unsigned int absolute;
+    signed int length = strlen(pSource);
 
-    // Compute absolute value
-    if (value < 0) {
+    if (!left) {
 
-        absolute = -value;
+        PutFill(pStream, fill, width - length);
     }
-    else {
+    PutData(pStream, pSource, length);
+    if (left) {
 
-        absolute = value;
+        PutFill(pStream, ' ', width - length);
     }
+}
 
-    // Take current digit into account when calculating width
-    width--;
-
-    // Recursively write upper digits
-    if ((absolute / 10) > 0) {
+//------------------------------------------------------------------------------
+// Converts an unsigned value to digits, stored backwards from the end of the
+// given buffer.  64-bit division is only used while the value needs it.
+// Returns a pointer to the first digit.
+// \param pEnd  End of the digit buffer.
+// \param value  Value to convert.
+// \param base  10 or 16.
+// \param maj  Indicates if the letters must be printed in lower- or upper-case.
+//------------------------------------------------------------------------------
+static char *FormatUnsigned(
+    char *pEnd,
+    unsigned long long value,
+    unsigned int base,
+    unsigned char maj)
+{
+    const char *pDigits = maj ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned int low;
 
-        if (value < 0) {
-        
-            num = PutSignedInt(pStr, fill, width, -(absolute / 10));
-        }
-        else {
+    while ((value >> 32) > 0) {
 
-            num = PutSignedInt(pStr, fill, width, absolute / 10);
-        }
-        pStr += num;
+        *--pEnd = pDigits[value % base];
+        value /= base;
     }
-    else {
 
-        // Reserve space for sign
-        if (value < 0) {
+    low = (unsigned int) value;
+    do {
 
-            width--;
-        }
+        *--pEnd = pDigits[low % base];
+        low /= base;
+    } while (low > 0);
 
-        // Write filler characters
-        while (width > 0) {
-
-            append_char(pStr, fill);
-            pStr++;
-            num++;
-            width--;
-        }
-
-        // Write sign
-        if (value < 0) {
-
-            num += append_char(pStr, '-');
-            pStr++;
-        }
-    }
-
-    // Write lower digit
-    num += append_char(pStr, (absolute % 10) + '0');
-
-    return num;
+    return pEnd;
 }
 
 //------------------------------------------------------------------------------
-// Writes an hexadecimal value into a string, using the given fill, width &
-// capital parameters.
-// Returns the number of char written.
-// \param pStr  Storage string.
+// Writes the digits of a number to the given stream, using the provided fill
+// & width parameters.  Zero filling goes after the sign, space filling
+// before it.
+// \param pStream  Output stream.
 // \param fill  Fill character.
-// \param width  Minimum integer width.
-// \param maj  Indicates if the letters must be printed in lower- or upper-case.
-// \param value  Hexadecimal value.
-//------------------------------------------------------------------------------
-signed int PutHexa(
-    char *pStr,
+// \param width  Minimum number width.
+// \param left  Pad on the right instead of the left.
+// \param negative  Write a minus sign.
+// \param pDigits  Digits to write.
+// \param pEnd  End of the digits.
+//------------------------------------------------------------------------------
+static void PutNumber(
+    PrintfStream *pStream,
     char fill,
     signed int width,
-    unsigned char maj,
-    unsigned int value)
+    unsigned char left,
+    unsigned char negative,
+    const char *pDigits,
+    const char *pEnd)
 {
-    signed int num = 0;
+    width -= (pEnd - pDigits) + negative;
 
-    // Decrement width
-    width--;
+    if (negative && (fill == '0')) {
 
-    // Recursively output upper digits
-    if ((value >> 4) > 0) {
+        PutChar(pStream, '-');
+    }
+    if (!left) {
 
-        num += PutHexa(pStr, fill, width, maj, value >> 4);
-        pStr += num;
+        PutFill(pStream, fill, width);
     }
-    // Write filler chars
-    else {
+    if (negative && (fill != '0')) {
 
-        while (width > 0) {
+        PutChar(pStream, '-');
+    }
+    PutData(pStream, pDigits, pEnd - pDigits);
+    if (left) {
 
-            append_char(pStr, fill);
-            pStr++;
-            num++;
-            width--;
-        }
+        PutFill(pStream, ' ', width);
     }
+}
 
-    // Write current digit
-    if ((value & 0xF) < 10) {
+//------------------------------------------------------------------------------
+//         Global Functions
+//------------------------------------------------------------------------------
 
-        append_char(pStr, (value & 0xF) + '0');
-    }
-    else if (maj) {
+//------------------------------------------------------------------------------
+/// Selects where printf, vprintf and puts-style output is sent.  Passing a
+/// NULL sink restores the default UART or USB CDC output.
+/// \param sink     Output sink.
+/// \param context  Value passed to the sink with each block of output.
+//------------------------------------------------------------------------------
+void printfSetSink(printfSink_t sink, void *context)
+{
+    if (sink) {
 
-        append_char(pStr, (value & 0xF) - 10 + 'A');
+        stdoutSink = sink;
+        stdoutContext = context;
     }
     else {
 
-        append_char(pStr, (value & 0xF) - 10 + 'a');
+        stdoutSink = StdoutSink;
+        stdoutContext = 0;
     }
-    num++;
-
-    return num;
 }
 
 //------------------------------------------------------------------------------
-//         Global Functions
+/// Sends a block of text, unformatted, to the current printf sink (see
+/// printfSetSink).  This is how puts output follows printf.
+/// \param data    Characters to send (not NULL-terminated).
+/// \param length  Number of characters to send.
 //------------------------------------------------------------------------------
+void printfWrite(const char *data, uint32_t length)
+{
+    stdoutSink(stdoutContext, data, length);
+}
 
 //------------------------------------------------------------------------------
-/// Stores the result of a formatted string into another string. Format
-/// arguments are given in a va_list instance.
-/// Return the number of characters written.
-/// \param pStr    Destination string.
-/// \param length  Length of Destination string.
-/// \param pFormat Format string.
-/// \param ap      Argument list.
+/// Formats a string directly into the given sink, without an intermediate
+/// buffer. Format arguments are given in a va_list instance.  Supports the
+/// d, i, u, x, X, s, c and % conversions with '0' and '-' flags, a width and
+/// the l and ll (64-bit) length modifiers.
+/// Return the number of characters written, or EOF on an unknown conversion.
+/// \param sink     Output sink.
+/// \param context  Value passed to the sink with each block of output.
+/// \param pFormat  Format string.
+/// \param ap       Argument list.
 //------------------------------------------------------------------------------
-signed int vsnprintf(char *pStr, size_t length, const char *pFormat, va_list ap)
+signed int vprintfSink(printfSink_t sink, void *context, const char *pFormat, va_list ap)
 {
-    char          fill;
-    unsigned char width;
-    signed int    num = 0;
-    signed int    size = 0;
-
-    // Clear the string
-    if (pStr) {
-
-        *pStr = 0;
-    }
+    PrintfStream       stream;
+    char               digits[PRINTF_DIGITS_SIZE];
+    char               *pEnd = digits + PRINTF_DIGITS_SIZE;
+    char               *pDigits;
+    const char         *pStart;
+    char               fill;
+    signed int         width;
+    unsigned char      left;
+    unsigned char      longs;
+    unsigned long long value;
+    signed long long   signedValue;
+
+    stream.sink = sink;
+    stream.context = context;
+    stream.count = 0;
+    stream.used = 0;
 
     // Phase string
-    while (*pFormat != 0 && size < length) {
+    while (*pFormat != 0) {
 
-        // Normal character
+        // Normal characters are passed on as one block
         if (*pFormat != '%') {
 
-            *pStr++ = *pFormat++;
-            size++;
-        }
-        // Escaped '%'
-        else if (*(pFormat+1) == '%') {
+            pStart = pFormat;
+            while ((*pFormat != 0) && (*pFormat != '%')) {
 
-            *pStr++ = '%';
-            pFormat += 2;
-            size++;
+                pFormat++;
+            }
+            PutData(&stream, pStart, pFormat - pStart);
+            continue;
         }
-        // Token delimiter
-        else {
 
-            fill = ' ';
-            width = 0;
+        fill = ' ';
+        width = 0;
+        left = 0;
+        longs = 0;
+        pFormat++;
+
+        // Fast path for conversions without flags, width or length, which
+        // covers most of the output in this code base
+        switch (*pFormat) {
+        case 'd':
+        case 'i':
+            signedValue = va_arg(ap, signed int);
+            value = (signedValue < 0) ? 0 - (unsigned long long) signedValue : signedValue;
+            pDigits = FormatUnsigned(pEnd, value, 10, 0);
+            if (signedValue < 0) {
+
+                PutChar(&stream, '-');
+            }
+            PutData(&stream, pDigits, pEnd - pDigits);
+            pFormat++;
+            continue;
+        case 'u':
+            pDigits = FormatUnsigned(pEnd, va_arg(ap, unsigned int), 10, 0);
+            PutData(&stream, pDigits, pEnd - pDigits);
+            pFormat++;
+            continue;
+        case 'x':
+        case 'X':
+            pDigits = FormatUnsigned(pEnd, va_arg(ap, unsigned int), 16, *pFormat == 'X');
+            PutData(&stream, pDigits, pEnd - pDigits);
+            pFormat++;
+            continue;
+        case 's':
+            pStart = va_arg(ap, char *);
+            PutData(&stream, pStart, strlen(pStart));
             pFormat++;
+            continue;
+        case '%':
+            PutChar(&stream, '%');
+            pFormat++;
+            continue;
+        }
+
+        // Parse flags
+        while ((*pFormat == '0') || (*pFormat == '-')) {
 
-            // Parse filler
             if (*pFormat == '0') {
 
                 fill = '0';
-                pFormat++;
             }
+            else {
 
-            // Ignore justifier
-            if (*pFormat == '-') {
-                pFormat++;
+                left = 1;
             }
+            pFormat++;
+        }
 
-            // Parse width
-            while ((*pFormat >= '0') && (*pFormat <= '9')) {
-        
-                width = (width*10) + *pFormat-'0';
-                pFormat++;
-            }
+        // Parse width
+        while ((*pFormat >= '0') && (*pFormat <= '9')) {
 
-            // Check if there is enough space
-            if (size + width > length) {
+            width = (width*10) + *pFormat-'0';
+            pFormat++;
+        }
+
+        // Parse length ('l' is the same size as int, 'll' is 64-bit)
+        while (*pFormat == 'l') {
+
+            longs++;
+            pFormat++;
+        }
+
+        // Parse type
+        switch (*pFormat) {
+        case 'd':
+        case 'i':
+            if (longs > 1) {
+
+                signedValue = va_arg(ap, signed long long);
+            }
+            else {
 
-                width = length - size;
+                signedValue = va_arg(ap, signed int);
             }
-        
-            // Parse type
-            switch (*pFormat) {
-            case 'd': 
-            case 'i': num = PutSignedInt(pStr, fill, width, va_arg(ap, signed int)); break;
-            case 'u': num = PutUnsignedInt(pStr, fill, width, va_arg(ap, unsigned int)); break;
-            case 'x': num = PutHexa(pStr, fill, width, 0, va_arg(ap, unsigned int)); break;
-            case 'X': num = PutHexa(pStr, fill, width, 1, va_arg(ap, unsigned int)); break;
-            case 's': num = PutString(pStr, fill, width, va_arg(ap, char *)); break;
-            case 'c': num = append_char(pStr, va_arg(ap, unsigned int)); break;
-            default:
-                return EOF;
+            value = (signedValue < 0) ? 0 - (unsigned long long) signedValue : signedValue;
+            pDigits = FormatUnsigned(pEnd, value, 10, 0);
+            PutNumber(&stream, fill, width, left, signedValue < 0, pDigits, pEnd);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+            if (longs > 1) {
+
+                value = va_arg(ap, unsigned long long);
             }
+            else {
 
-            pFormat++;
-            pStr += num;
-            size += num;
+                value = va_arg(ap, unsigned int);
+            }
+            pDigits = FormatUnsigned(pEnd, value, (*pFormat == 'u') ? 10 : 16, *pFormat == 'X');
+            PutNumber(&stream, fill, width, left, 0, pDigits, pEnd);
+            break;
+        case 's':
+            PutString(&stream, fill, width, left, va_arg(ap, char *));
+            break;
+        case 'c':
+            PutChar(&stream, va_arg(ap, unsigned int));
+            break;
+        default:
+            Flush(&stream);
+            return EOF;
         }
+
+        pFormat++;
     }
 
-    // NULL-terminated (final \0 is not counted)
-    if (size < length) {
+    Flush(&stream);
+
+    return stream.count;
+}
+
+//------------------------------------------------------------------------------
+/// Formats a string directly into the given sink, using a variable number of
+/// arguments.
+/// Return the number of characters written.
+/// \param sink     Output sink.
+/// \param context  Value passed to the sink with each block of output.
+/// \param pFormat  Format string.
+/// \param ...      Other arguments
+//------------------------------------------------------------------------------
+signed int printfSink(printfSink_t sink, void *context, const char *pFormat, ...)
+{
+    va_list    ap;
+    signed int rc;
+
+    va_start(ap, pFormat);
+    rc = vprintfSink(sink, context, pFormat, ap);
+    va_end(ap);
+
+    return rc;
+}
+
+//------------------------------------------------------------------------------
+/// Stores the result of a formatted string into another string. Format
+/// arguments are given in a va_list instance.
+/// Return the number of characters written.
+/// \param pStr    Destination string.
+/// \param length  Length of Destination string.
+/// \param pFormat Format string.
+/// \param ap      Argument list.
+//------------------------------------------------------------------------------
+signed int vsnprintf(char *pStr, size_t length, const char *pFormat, va_list ap)
+{
+    PrintfBuffer buffer;
 
-        *pStr = 0;
+    if (length == 0) {
+
+        return 0;
     }
-    else {
 
-        *(--pStr) = 0;
-        size--;
+    // Leave room for the final \0 (which is not counted)
+    buffer.pStr = pStr;
+    buffer.left = length - 1;
+    if (vprintfSink(BufferSink, &buffer, pFormat, ap) == EOF) {
+
+        *buffer.pStr = 0;
+        return EOF;
     }
+    *buffer.pStr = 0;
 
-    return size;
+    return buffer.pStr - pStr;
 }
 
 //------------------------------------------------------------------------------
@@ -416,30 +576,20 @@ signed int vsprintf(char *pString, const char *pFormat, va_list ap)
 }
 
 //------------------------------------------------------------------------------
-/// Outputs a formatted string on the DBGU stream. Format arguments are given
-/// in a va_list instance.
+/// Outputs a formatted string on the current printf sink (see printfSetSink).
+/// Format arguments are given in a va_list instance.  Characters are sent as
+/// they are formatted, so there is no limit on the length of the output.
 /// \param pFormat  Format string
 /// \param ap  Argument list.
 //------------------------------------------------------------------------------
 signed int vprintf(const char *pFormat, va_list ap)
 {
-  char pStr[MAX_STRING_SIZE];
-  char pError[] = "stdio.c: increase MAX_STRING_SIZE\r\n";
-  
-  // Write formatted string in buffer
-  if (vsprintf(pStr, pFormat, ap) >= MAX_STRING_SIZE) {
-    
-    puts(pError);
-    while (1); // Increase MAX_STRING_SIZE
-  }
-  
-  // Display string
-  return puts(pStr);
+    return vprintfSink(stdoutSink, stdoutContext, pFormat, ap);
 }
 
 //------------------------------------------------------------------------------
-/// Outputs a formatted string on the DBGU stream, using a variable number of
-/// arguments.
+/// Outputs a formatted string on the current printf sink, using a variable
+/// number of arguments.
 /// \param pFormat  Format string.
 //------------------------------------------------------------------------------
 signed int printf(const char *pFormat, ...)
@@ -0,0 +1,276 @@
+/**************************************************************************/
+/*! 
+    @file     ringbuf.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @section DESCRIPTION
+
+    Lock-free single-producer/single-consumer byte FIFO used by the UART,
+    USB CDC and Chibi drivers.  The producer only ever advances 'head'
+    and the consumer only ever advances 'tail', so there is no shared
+    counter to corrupt when an ISR and the main loop access the buffer
+    at the same time.  The span functions expose the contiguous region
+    behind each index, so that data can be copied in or out with a
+    single memcpy (or handed straight to a peripheral) instead of one
+    byte at a time.
+
+    @section Example
+
+    @code
+    #include "core/ringbuf/ringbuf.h"
+
+    static uint8_t storage[256];     // Size must be a power of two
+    static ringbuf_t fifo;
+
+    ringbufInit(&fifo, storage, sizeof(storage));
+
+    // In the ISR (producer)
+    ringbufPut(&fifo, data);
+
+    // In the main loop (consumer)
+    uint8_t *span;
+    uint32_t len;
+    while ((len = ringbufReadSpan(&fifo, &span)))
+    {
+      process(span, len);
+      ringbufSkip(&fifo, len);
+    }
+    @endcode
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#include <string.h>
+
+#include "ringbuf.h"
+
+/**************************************************************************/
+/*! 
+    @brief  Initialises an empty FIFO on top of the supplied storage
+
+    @param[in]  rb
+                FIFO control block
+    @param[in]  storage
+                Buffer that will hold the queued bytes
+    @param[in]  size
+                Size of 'storage' in bytes, which must be a power of two
+*/
+/**************************************************************************/
+void ringbufInit(ringbuf_t *rb, uint8_t *storage, uint32_t size)
+{
+  rb->buf = storage;
+  rb->mask = size - 1;
+  rb->head = 0;
+  rb->tail = 0;
+  rb->overflow = 0;
+  rb->highwater = 0;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Discards everything waiting in the FIFO.  This is a consumer
+            operation, so it can safely be called while the producer is
+            still adding data.
+*/
+/**************************************************************************/
+void ringbufClear(ringbuf_t *rb)
+{
+  rb->tail = rb->head;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Appends up to 'len' bytes (producer side).  Anything that
+            doesn't fit is counted in 'overflow' and discarded.
+
+    @returns  The number of bytes actually written
+*/
+/**************************************************************************/
+uint32_t ringbufWrite(ringbuf_t *rb, const uint8_t *data, uint32_t len)
+{
+  uint32_t head = rb->head;
+  uint32_t count = head - rb->tail;
+  uint32_t space = rb->mask + 1 - count;
+  uint32_t offset = head & rb->mask;
+  uint32_t chunk;
+
+  if (len > space)
+  {
+    rb->overflow += len - space;
+    len = space;
+  }
+
+  // Copy in at most two contiguous runs
+  chunk = rb->mask + 1 - offset;
+  if (chunk > len)
+  {
+    chunk = len;
+  }
+  memcpy(&rb->buf[offset], data, chunk);
+  memcpy(rb->buf, data + chunk, len - chunk);
+
+  RINGBUF_BARRIER();
+  rb->head = head + len;
+  if (count + len > rb->highwater)
+  {
+    rb->highwater = count + len;
+  }
+  return len;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Gets the largest contiguous free region after 'head', so the
+            producer can fill it in place (producer side).  Call
+            ringbufWriteCommit once the data has been written.
+
+    @param[out] data
+                Set to the start of the free region
+
+    @returns  The size of the region in bytes (0 if the FIFO is full)
+*/
+/**************************************************************************/
+uint32_t ringbufWriteSpan(ringbuf_t *rb, uint8_t **data)
+{
+  uint32_t head = rb->head;
+  uint32_t space = rb->mask + 1 - (head - rb->tail);
+  uint32_t chunk = rb->mask + 1 - (head & rb->mask);
+
+  *data = &rb->buf[head & rb->mask];
+  return chunk < space ? chunk : space;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Publishes 'len' bytes written through ringbufWriteSpan
+            (producer side)
+*/
+/**************************************************************************/
+void ringbufWriteCommit(ringbuf_t *rb, uint32_t len)
+{
+  uint32_t count;
+
+  RINGBUF_BARRIER();
+  rb->head += len;
+  count = rb->head - rb->tail;
+  if (count > rb->highwater)
+  {
+    rb->highwater = count;
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Copies bytes starting 'offset' bytes into the FIFO without
+            removing them (consumer side)
+
+    @returns  The number of bytes copied, which is less than 'len' if the
+              FIFO doesn't hold that many
+*/
+/**************************************************************************/
+uint32_t ringbufPeek(ringbuf_t *rb, uint8_t *data, uint32_t offset, uint32_t len)
+{
+  uint32_t tail = rb->tail;
+  uint32_t count = rb->head - tail;
+  uint32_t start, chunk;
+
+  if (offset >= count)
+  {
+    return 0;
+  }
+  if (len > count - offset)
+  {
+    len = count - offset;
+  }
+
+  // Copy out in at most two contiguous runs
+  start = (tail + offset) & rb->mask;
+  chunk = rb->mask + 1 - start;
+  if (chunk > len)
+  {
+    chunk = len;
+  }
+  memcpy(data, &rb->buf[start], chunk);
+  memcpy(data + chunk, rb->buf, len - chunk);
+  return len;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Removes up to 'len' bytes from the FIFO (consumer side)
+
+    @returns  The number of bytes actually read
+*/
+/**************************************************************************/
+uint32_t ringbufRead(ringbuf_t *rb, uint8_t *data, uint32_t len)
+{
+  len = ringbufPeek(rb, data, 0, len);
+  RINGBUF_BARRIER();
+  rb->tail += len;
+  return len;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Gets the largest contiguous run of queued bytes at 'tail', so
+            the consumer can use them in place (consumer side).  Call
+            ringbufSkip once they have been processed.
+
+    @param[out] data
+                Set to the first queued byte
+
+    @returns  The length of the run in bytes (0 if the FIFO is empty)
+*/
+/**************************************************************************/
+uint32_t ringbufReadSpan(ringbuf_t *rb, uint8_t **data)
+{
+  uint32_t tail = rb->tail;
+  uint32_t count = rb->head - tail;
+  uint32_t chunk = rb->mask + 1 - (tail & rb->mask);
+
+  *data = &rb->buf[tail & rb->mask];
+  return chunk < count ? chunk : count;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Discards up to 'len' bytes from the front of the FIFO, for
+            example after processing them through ringbufReadSpan
+            (consumer side)
+*/
+/**************************************************************************/
+void ringbufSkip(ringbuf_t *rb, uint32_t len)
+{
+  uint32_t count = rb->head - rb->tail;
+
+  RINGBUF_BARRIER();
+  rb->tail += len < count ? len : count;
+}
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/*! 
+    @file     ringbuf.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#ifndef __RINGBUF_H__
+#define __RINGBUF_H__
+
+#include "projectconfig.h"
+
+// Compiler barrier: the Cortex-M3 doesn't reorder normal memory
+// accesses, so keeping the compiler from doing so is sufficient
+#define RINGBUF_BARRIER()   __asm volatile ("" ::: "memory")
+
+/**************************************************************************/
+/*! 
+    Single-producer/single-consumer byte FIFO.  'head' is only written
+    by the producer and 'tail' only by the consumer, so one side can run
+    in an ISR and the other in the main loop without disabling
+    interrupts.  Both indices run freely and are masked on access, which
+    requires the storage size to be a power of two.
+*/
+/**************************************************************************/
+typedef struct _ringbuf_t
+{
+  uint8_t *buf;                 // Storage (size bytes)
+  uint32_t mask;                // size - 1
+  volatile uint32_t head;       // Next write position (producer)
+  volatile uint32_t tail;       // Next read position (consumer)
+  uint32_t overflow;            // Bytes rejected because the FIFO was full
+  uint32_t highwater;           // Highest fill level since init
+} ringbuf_t;
+
+void     ringbufInit(ringbuf_t *rb, uint8_t *storage, uint32_t size);
+void     ringbufClear(ringbuf_t *rb);
+
+// Producer side
+uint32_t ringbufWrite(ringbuf_t *rb, const uint8_t *data, uint32_t len);
+uint32_t ringbufWriteSpan(ringbuf_t *rb, uint8_t **data);
+void     ringbufWriteCommit(ringbuf_t *rb, uint32_t len);
+
+// Consumer side
+uint32_t ringbufRead(ringbuf_t *rb, uint8_t *data, uint32_t len);
+uint32_t ringbufPeek(ringbuf_t *rb, uint8_t *data, uint32_t offset, uint32_t len);
+uint32_t ringbufReadSpan(ringbuf_t *rb, uint8_t **data);
+void     ringbufSkip(ringbuf_t *rb, uint32_t len);
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the number of bytes waiting to be read
+*/
+/**************************************************************************/
+static inline uint32_t ringbufCount(ringbuf_t *rb)
+{
+  return rb->head - rb->tail;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the number of bytes that can be written
+*/
+/**************************************************************************/
+static inline uint32_t ringbufFree(ringbuf_t *rb)
+{
+  return rb->mask + 1 - (rb->head - rb->tail);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Appends one byte (producer side)
+
+    @returns  false if the FIFO was full and the byte was dropped
+*/
+/**************************************************************************/
+static inline bool ringbufPut(ringbuf_t *rb, uint8_t data)
+{
+  uint32_t head = rb->head;
+  uint32_t count = head - rb->tail;
+
+  if (count > rb->mask)
+  {
+    rb->overflow++;
+    return false;
+  }
+  rb->buf[head & rb->mask] = data;
+  RINGBUF_BARRIER();
+  rb->head = head + 1;
+  if (count >= rb->highwater)
+  {
+    rb->highwater = count + 1;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Removes one byte (consumer side)
+
+    @returns  false if the FIFO was empty
+*/
+/**************************************************************************/
+static inline bool ringbufGet(ringbuf_t *rb, uint8_t *data)
+{
+  uint32_t tail = rb->tail;
+
+  if (tail == rb->head)
+  {
+    return false;
+  }
+  *data = rb->buf[tail & rb->mask];
+  RINGBUF_BARRIER();
+  rb->tail = tail + 1;
+  return true;
+}
+
+#endif
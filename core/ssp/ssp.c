@@ -19,21 +19,29 @@
     cpuInit();
     sspInit(0, sspClockPolarity_High, sspClockPhase_RisingEdge);
     ...
+    // CS on 0.2, 4MHz, clock high between frames, leading edge
+    const sspDevice_t device = { 0, 2, 8, sspClockPolarity_High, sspClockPhase_RisingEdge };
+    sspDeviceInit(&device);
+
     uint8_t request[SSP_FIFOSIZE];
     uint8_t response[SSP_FIFOSIZE];
   
     // Send 0x9C to the slave device and wait for a response
     request[0] = 0x80 | 0x1C;
-    // Toggle the select pin
-    ssp0Select();
+    // Select the device (this also loads its bus settings)
+    sspSelect(&device);
     // Send 1 byte from the request buffer
     sspSend(0, (uint8_t *)&request, 1);
     // Receive 1 byte into the response buffer
     sspReceive(0, (uint8_t *)&response, 1);
-    // Reset the select pin
-    ssp0Deselect();
+    // Deselect the device
+    sspDeselect(&device);
     // Print the results
     debug_printf("Ox%x ", response[0]);
+
+    // Or read 512 bytes in the background, calling blockRead when done
+    sspJob_t job = { &device, NULL, buffer, 512, 0, blockRead };
+    sspSubmit(&job);
     @endcode
 	
     @section LICENSE
@@ -74,6 +82,235 @@ volatile uint32_t interruptRxStat = 0;
 volatile uint32_t interruptOverRunStat = 0;
 volatile uint32_t interruptRxTimeoutStat = 0;
 
+/* Queue of submitted jobs, the head is the one on the bus */
+static sspJob_t * volatile sspHead = NULL;
+static sspJob_t * volatile sspTail = NULL;
+
+/* The device whose chip select is currently held low */
+static const sspDevice_t * volatile sspSelected = NULL;
+
+/* Bus lock (see sspLock) */
+static const sspDevice_t * volatile sspOwner = NULL;
+static volatile uint8_t sspLockDepth = 0;
+static volatile bool sspSelectLocked = false;
+
+static bool _sspInitialised = false;
+
+/* Interrupts waiting for the bus to be released (see sspDefer), laid
+   out like the NVIC set pending registers */
+static volatile uint32_t sspDeferred[2];
+
+/* Interrupts enabled while no job is in progress */
+#define SSP_IMSC_IDLE   (SSP_SSP0IMSC_RORIM_ENBL | SSP_SSP0IMSC_RTIM_ENBL)
+
+/**************************************************************************/
+/*! 
+    @brief Loads the clock and frame settings for a device, unless they
+           are already loaded.  The bus must be idle.
+*/
+/**************************************************************************/
+static void sspSetup (const sspDevice_t *device)
+{
+  uint32_t configReg = SSP_SSP0CR0_DSS_8BIT 
+                     | SSP_SSP0CR0_FRF_SPI 
+                     | ((uint32_t)device->clockDivider << 8)
+                     | (device->polarity == sspClockPolarity_High ? SSP_SSP0CR0_CPOL_HIGH : SSP_SSP0CR0_CPOL_LOW)
+                     | (device->phase == sspClockPhase_FallingEdge ? SSP_SSP0CR0_CPHA_SECOND : SSP_SSP0CR0_CPHA_FIRST);
+
+  if (SSP_SSP0CR0 != configReg)
+  {
+    SSP_SSP0CR0 = configReg;
+    SSP_SSP0CPSR = SSP_SSP0CPSR_CPSDVSR_DIV2;
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Disables interrupts, returning the previous PRIMASK so that
+           this can also be used when interrupts are already off
+*/
+/**************************************************************************/
+static inline uint32_t sspEnterCritical (void)
+{
+  uint32_t primask;
+
+  __asm volatile ("mrs %0, primask" : "=r" (primask));
+  __disable_irq();
+  return primask;
+}
+
+static inline void sspLeaveCritical (uint32_t primask)
+{
+  if (!primask)
+  {
+    __enable_irq();
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Drives the chip select for a device high
+*/
+/**************************************************************************/
+static void sspReleaseCS (const sspDevice_t *device)
+{
+  if (sspSelected == device)
+  {
+    gpioSetValue(device->csPort, device->csPin, 1);
+    sspSelected = NULL;
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Drives the chip select for a device low, first releasing any
+           other device that was left selected
+*/
+/**************************************************************************/
+static void sspAssertCS (const sspDevice_t *device)
+{
+  if (sspSelected != device)
+  {
+    if (sspSelected != NULL)
+    {
+      gpioSetValue(sspSelected->csPort, sspSelected->csPin, 1);
+    }
+    sspSetup(device);
+    gpioSetValue(device->csPort, device->csPin, 0);
+    sspSelected = device;
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Moves the job at the head of the queue as far along as the
+           FIFOs allow, completing it (and starting the next one) when
+           every byte has been received.  Must be called with the SSP
+           interrupt masked or from the interrupt handler.
+*/
+/**************************************************************************/
+static void sspService (void)
+{
+  sspJob_t *job;
+  sspCallback_t callback;
+  uint8_t data;
+
+  while ((job = sspHead) != NULL)
+  {
+    if (job->txCount == 0)
+    {
+      /* Jobs for other devices wait until the bus is unlocked */
+      if ((sspOwner != NULL) && (sspOwner != job->device))
+      {
+        break;
+      }
+      sspAssertCS(job->device);
+    }
+
+    /* Drain whatever has arrived */
+    while (SSP_SSP0SR & SSP_SSP0SR_RNE_NOTEMPTY)
+    {
+      data = SSP_SSP0DR;
+      if (job->rxBuffer)
+      {
+        job->rxBuffer[job->rxCount] = data;
+      }
+      job->rxCount++;
+    }
+
+    /* Top up the TX FIFO, never with more than SSP_FIFOSIZE outstanding */
+    while ((job->txCount < job->length) && 
+           (job->txCount - job->rxCount < SSP_FIFOSIZE) && 
+           (SSP_SSP0SR & SSP_SSP0SR_TNF_NOTFULL))
+    {
+      SSP_SSP0DR = job->txBuffer ? job->txBuffer[job->txCount] : 0xFF;
+      job->txCount++;
+    }
+
+    if (job->rxCount < job->length)
+    {
+      /* Wait for the RX FIFO to fill (or time out on the last few
+         bytes), and for TX space while there is more to send */
+      SSP_SSP0IMSC = SSP_IMSC_IDLE | SSP_SSP0IMSC_RXIM_ENBL | 
+                     (job->txCount < job->length ? SSP_SSP0IMSC_TXIM_ENBL : 0);
+      return;
+    }
+
+    /* Finished, so release the device and start on the next job */
+    sspHead = job->next;
+    if (sspHead == NULL)
+    {
+      sspTail = NULL;
+    }
+    if (!(job->flags & SSPJOB_HOLDCS))
+    {
+      sspReleaseCS(job->device);
+    }
+
+    /* The job belongs to the caller again once its state is final */
+    callback = job->callback;
+    job->state = SSPJOB_DONE;
+    if (callback != NULL)
+    {
+      callback(job);
+    }
+  }
+
+  SSP_SSP0IMSC = SSP_IMSC_IDLE;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sets any interrupts deferred with sspDefer pending again if
+           the bus is free, so that their handlers run at their own
+           priority as soon as the NVIC allows
+*/
+/**************************************************************************/
+static void sspPendDeferred (void)
+{
+  uint32_t primask, i, pending;
+
+  primask = sspEnterCritical();
+  if ((sspOwner == NULL) && (sspHead == NULL))
+  {
+    for (i = 0; i < 2; i++)
+    {
+      pending = sspDeferred[i];
+      sspDeferred[i] = 0;
+      NVIC->ISPR[i] = pending;
+    }
+  }
+  sspLeaveCritical(primask);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Takes the bus lock for a device once any queued jobs have
+           finished
+*/
+/**************************************************************************/
+static void sspAcquire (const sspDevice_t *device)
+{
+  uint32_t primask;
+
+  while (1)
+  {
+    primask = sspEnterCritical();
+    if ((sspOwner == device) || ((sspOwner == NULL) && (sspHead == NULL)))
+    {
+      sspOwner = device;
+      sspLeaveCritical(primask);
+      return;
+    }
+    if (primask && (sspOwner == NULL))
+    {
+      /* With interrupts off the queue has to be moved along here */
+      sspService();
+    }
+    sspLeaveCritical(primask);
+  }
+}
+
 /**************************************************************************/
 /*! 
     @brief SSP0 interrupt handler for SPI communication
@@ -107,9 +344,18 @@ void SSP_IRQHandler (void)
   /* Check if Rx buffer is at least half-full */
   if ( regValue & SSP_SSP0MIS_RXMIS_HALFFULL )
   {
-    // ToDo: Receive until it's empty
     interruptRxStat++;
   }
+
+  /* Move the current job along */
+  if (sspHead != NULL)
+  {
+    sspService();
+    if (sspHead == NULL)
+    {
+      sspPendDeferred();
+    }
+  }
   return;
 }
 
@@ -122,6 +368,12 @@ void SSP_IRQHandler (void)
     GPIO to allow manual control of when the SPI port is enabled or
     disabled.  Overrun and timeout interrupts are both enabled.
 
+    SSP0 is only set up by the first call, since the bus may already
+    be in use by another device, so drivers sharing it can all call
+    this from their own init functions.  The clock polarity and phase
+    set here are only used until the first device is selected, which
+    loads its own settings (see sspDevice_t).
+
     @param[in]  portNum
                 The SPI port to use (0..1)
     @param[in]  polarity
@@ -133,17 +385,17 @@ void SSP_IRQHandler (void)
                 (sspClockPhase_RisingEdge) or falling
                 (sspClockPhase_FallingEdge) edge of clock transitions.
 
-    @note   sspSelect() and sspDeselect() macros have been defined in 
-            ssp.h to control the SSEL line without having to know the 
-            specific pin being used.
+    @note   Each device on the bus must then be set up with
+            sspDeviceInit, and sspSelect()/sspDeselect() drive the
+            chip select of the sspDevice_t passed to them.
 */
 /**************************************************************************/
 void sspInit (uint8_t portNum, sspClockPolarity_t polarity, sspClockPhase_t phase)
 {
-  gpioInit();
-
-  if (portNum == 0)
+  if ((portNum == 0) && !_sspInitialised)
   {
+    gpioInit();
+
     /* Reset SSP */
     SCB_PRESETCTRL &= ~SCB_PRESETCTRL_SSP0_MASK;
     SCB_PRESETCTRL |= SCB_PRESETCTRL_SSP0_RESETDISABLED;
@@ -221,6 +473,8 @@ void sspInit (uint8_t portNum, sspClockPolarity_t polarity, sspClockPhase_t phas
   
     /* Enable device and set it to master mode, no loopback */
     SSP_SSP0CR1 = SSP_SSP0CR1_SSE_ENABLED | SSP_SSP0CR1_MS_MASTER | SSP_SSP0CR1_LBM_NORMAL;
+
+    _sspInitialised = true;
   }
 
   return;
@@ -228,44 +482,185 @@ void sspInit (uint8_t portNum, sspClockPolarity_t polarity, sspClockPhase_t phas
 
 /**************************************************************************/
 /*! 
-    @brief Sends a block of data to the SSP0 port
+    @brief Exchanges a block of 8-bit frames with SSP0, keeping the TX
+           FIFO full while the RX FIFO is drained
+
+    No more than SSP_FIFOSIZE frames are ever outstanding, so the RX
+    FIFO can not overrun even if this is interrupted.
+
+    @param[in]  tx
+                The frames to send, or NULL to send fillValue
+    @param[out] rx
+                Receives the frames read back, or NULL to discard them
+    @param[in]  length
+                The number of frames to exchange
+    @param[in]  fillValue
+                The frame to send when tx is NULL
+*/
+/**************************************************************************/
+static void sspExchange (const uint8_t *tx, uint8_t *rx, uint32_t length, uint8_t fillValue)
+{
+  uint32_t txRemaining = length;
+  uint32_t rxRemaining = length;
+  uint8_t data;
+
+  while (rxRemaining)
+  {
+    /* Top up the TX FIFO */
+    while (txRemaining && 
+           (rxRemaining - txRemaining < SSP_FIFOSIZE) && 
+           (SSP_SSP0SR & SSP_SSP0SR_TNF_NOTFULL))
+    {
+      SSP_SSP0DR = tx ? *tx++ : fillValue;
+      txRemaining--;
+    }
+
+    /* Drain whatever has arrived */
+    while (SSP_SSP0SR & SSP_SSP0SR_RNE_NOTEMPTY)
+    {
+      data = SSP_SSP0DR;
+      if (rx)
+      {
+        *rx++ = data;
+      }
+      rxRemaining--;
+    }
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sends and receives a block of data on the SSP0 port at the
+           same time (full duplex)
 
     @param[in]  portNum
                 The SPI port to use (0..1)
-    @param[in]  buf
-                Pointer to the data buffer
+    @param[in]  tx
+                Pointer to the data to send, or NULL to send 0xFF
+    @param[out] rx
+                Pointer to the buffer for the received data (which may
+                be the same as tx), or NULL to discard it
     @param[in]  length
-                Block length of the data buffer
+                Number of bytes to transfer
+*/
+/**************************************************************************/
+void sspTransfer (uint8_t portNum, const uint8_t *tx, uint8_t *rx, uint32_t length)
+{
+  if (portNum == 0)
+  {
+    sspExchange(tx, rx, length, 0xFF);
+  }
+
+  return;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sends and receives a block of 16-bit frames on the SSP0 port
+
+    The port is switched to 16-bit frames for the duration of the
+    transfer, and restored to 8-bit frames afterwards.
+
+    @param[in]  portNum
+                The SPI port to use (0..1)
+    @param[in]  tx
+                Pointer to the frames to send, or NULL to send 0xFFFF
+    @param[out] rx
+                Pointer to the buffer for the received frames, or NULL
+                to discard them
+    @param[in]  length
+                Number of 16-bit frames to transfer
 */
 /**************************************************************************/
-void sspSend (uint8_t portNum, uint8_t *buf, uint32_t length)
+void sspTransfer16 (uint8_t portNum, const uint16_t *tx, uint16_t *rx, uint32_t length)
 {
-  uint32_t i;
-  uint8_t Dummy = Dummy;
+  uint32_t txRemaining = length;
+  uint32_t rxRemaining = length;
+  uint16_t data;
 
   if (portNum == 0)
   {
-    for (i = 0; i < length; i++)
+    /* The frame size can only be changed while the port is idle */
+    while (SSP_SSP0SR & SSP_SSP0SR_BSY_BUSY);
+    SSP_SSP0CR0 = (SSP_SSP0CR0 & ~SSP_SSP0CR0_DSS_MASK) | SSP_SSP0CR0_DSS_16BIT;
+
+    while (rxRemaining)
     {
-      /* Move on only if NOT busy and TX FIFO not full. */
-      while ((SSP_SSP0SR & (SSP_SSP0SR_TNF_NOTFULL | SSP_SSP0SR_BSY_BUSY)) != SSP_SSP0SR_TNF_NOTFULL);
-      SSP_SSP0DR = *buf;
-      buf++;
-  
-      while ( (SSP_SSP0SR & (SSP_SSP0SR_BSY_BUSY|SSP_SSP0SR_RNE_NOTEMPTY)) != SSP_SSP0SR_RNE_NOTEMPTY );
-      /* Whenever a byte is written, MISO FIFO counter increments, Clear FIFO 
-      on MISO. Otherwise, when SSP0Receive() is called, previous data byte
-      is left in the FIFO. */
-      Dummy = SSP_SSP0DR;
+      while (txRemaining && 
+             (rxRemaining - txRemaining < SSP_FIFOSIZE) && 
+             (SSP_SSP0SR & SSP_SSP0SR_TNF_NOTFULL))
+      {
+        SSP_SSP0DR = tx ? *tx++ : 0xFFFF;
+        txRemaining--;
+      }
+
+      while (SSP_SSP0SR & SSP_SSP0SR_RNE_NOTEMPTY)
+      {
+        data = SSP_SSP0DR;
+        if (rx)
+        {
+          *rx++ = data;
+        }
+        rxRemaining--;
+      }
     }
+
+    /* Every frame has been received, so the port is idle again */
+    SSP_SSP0CR0 = (SSP_SSP0CR0 & ~SSP_SSP0CR0_DSS_MASK) | SSP_SSP0CR0_DSS_8BIT;
   }
 
-  return; 
+  return;
 }
 
 /**************************************************************************/
 /*! 
-    @brief Receives a block of data from the SSP0 port
+    @brief Sends the same byte repeatedly to the SSP0 port, discarding
+           anything received
+
+    This is typically used to generate clock cycles with MOSI held
+    high, such as the 74+ clocks an SD card needs at power up, or to
+    skip over unwanted data.
+
+    @param[in]  portNum
+                The SPI port to use (0..1)
+    @param[in]  value
+                The byte to send
+    @param[in]  length
+                Number of times to send it
+*/
+/**************************************************************************/
+void sspFill (uint8_t portNum, uint8_t value, uint32_t length)
+{
+  if (portNum == 0)
+  {
+    sspExchange(NULL, NULL, length, value);
+  }
+
+  return;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sends a block of data to the SSP0 port, discarding anything
+           received
+
+    @param[in]  portNum
+                The SPI port to use (0..1)
+    @param[in]  buf
+                Pointer to the data buffer
+    @param[in]  length
+                Block length of the data buffer
+*/
+/**************************************************************************/
+void sspSend (uint8_t portNum, const uint8_t *buf, uint32_t length)
+{
+  sspTransfer(portNum, buf, NULL, length);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Receives a block of data from the SSP0 port (sending 0xFF
+           for each byte)
 
     @param[in]  portNum
                 The SPI port to use (0..1)
@@ -277,23 +672,295 @@ void sspSend (uint8_t portNum, uint8_t *buf, uint32_t length)
 /**************************************************************************/
 void sspReceive(uint8_t portNum, uint8_t *buf, uint32_t length)
 {
-  uint32_t i;
+  sspTransfer(portNum, NULL, buf, length);
+}
 
-  if (portNum == 0)
+/**************************************************************************/
+/*! 
+    @brief Sets up the chip select pin for a device on SSP0 and leaves
+           it deselected.  sspInit must already have been called.
+
+    @param[in]  device
+                The device, which must stay valid while it is in use
+*/
+/**************************************************************************/
+void sspDeviceInit (const sspDevice_t *device)
+{
+  gpioSetDir(device->csPort, device->csPin, gpioDirection_Output);
+  gpioSetValue(device->csPort, device->csPin, 1);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Locks the bus for a device and loads its bus settings
+
+    SSP0 is shared by the SD card, the Chibi radio and the AT25040, so
+    each transaction must hold the lock.  The lock may be taken more
+    than once by the same device and is released by the matching
+    number of calls to sspUnlock.  Jobs queued for other devices are
+    held back until then.  sspSelect takes the lock automatically.
+
+    This may be called with interrupts disabled, but not from an
+    interrupt handler, which should use sspDefer instead.
+
+    @param[in]  device
+                The device that will use the bus
+*/
+/**************************************************************************/
+void sspLock (const sspDevice_t *device)
+{
+  sspAcquire(device);
+  sspLockDepth++;
+
+  /* The bus is idle, so the device's settings can be loaded */
+  sspSetup(device);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Releases the bus lock taken by sspLock
+
+    When the lock is finally released, any jobs held back are started.
+    If the bus is then free, any interrupts deferred by sspDefer are
+    set pending again.
+
+    @param[in]  device
+                The device that locked the bus
+*/
+/**************************************************************************/
+void sspUnlock (const sspDevice_t *device)
+{
+  uint32_t primask;
+
+  primask = sspEnterCritical();
+  if ((sspOwner == device) && sspLockDepth && (--sspLockDepth == 0))
   {
-    for ( i = 0; i < length; i++ )
+    sspOwner = NULL;
+    if (sspHead != NULL)
     {
-      /* As long as the receive FIFO is not empty, data can be received. */
-      SSP_SSP0DR = 0xFF;
-  
-      /* Wait until the Busy bit is cleared */
-      while ( (SSP_SSP0SR & (SSP_SSP0SR_BSY_BUSY|SSP_SSP0SR_RNE_NOTEMPTY)) != SSP_SSP0SR_RNE_NOTEMPTY );
-      
-      *buf = SSP_SSP0DR;
-      buf++;
+      sspService();
     }
   }
+  sspLeaveCritical(primask);
+
+  sspPendDeferred();
+}
+
+/**************************************************************************/
+/*! 
+    @brief Checks from an interrupt handler whether the bus is free
+
+    If the bus is locked, or jobs are in progress, the interrupt is
+    recorded and set pending again once the bus is free.  This happens
+    when the lock is released, from the SSP interrupt when the queue
+    drains, or at a boundary where the lock holder calls sspYield.
+    The handler therefore always runs in its own interrupt context,
+    and must remember that it has work to do, since the peripheral's
+    own interrupt flag has usually been cleared by then.
+
+    @param[in]  irq
+                The interrupt to set pending later if the bus is busy,
+                which is typically the one being handled
+
+    @return     true if the bus is busy and the interrupt was deferred,
+                false if the caller can use the bus straight away
+*/
+/**************************************************************************/
+bool sspDefer (IRQn_t irq)
+{
+  uint32_t primask;
+  bool busy;
+
+  primask = sspEnterCritical();
+  busy = (sspOwner != NULL) || (sspHead != NULL);
+  if (busy)
+  {
+    sspDeferred[(uint32_t)irq >> 5] |= 1 << ((uint32_t)irq & 0x1F);
+  }
+  sspLeaveCritical(primask);
 
-  return; 
+  return busy;
 }
 
+/**************************************************************************/
+/*! 
+    @brief Lets any deferred interrupts use the bus
+
+    This should be called by long running bus users at points where
+    they can safely be interrupted, such as between SD card blocks.  If
+    any work is waiting, the device is deselected (followed by one
+    byte of clocks so that it releases MISO) and the lock is given up
+    while it runs, then both are restored.
+
+    @param[in]  device
+                The device holding the lock
+*/
+/**************************************************************************/
+void sspYield (const sspDevice_t *device)
+{
+  uint8_t depth;
+  bool selected, selectLocked;
+
+  if ((sspOwner != device) || (sspHead != NULL))
+  {
+    return;
+  }
+  if ((sspDeferred[0] | sspDeferred[1]) == 0)
+  {
+    return;
+  }
+
+  /* Give up the bus */
+  selected = (sspSelected == device);
+  selectLocked = sspSelectLocked;
+  depth = sspLockDepth;
+  sspReleaseCS(device);
+  if (selected)
+  {
+    /* An SD card keeps driving MISO until it is clocked with CS high */
+    sspExchange(NULL, NULL, 1, 0xFF);
+  }
+  sspSelectLocked = false;
+  sspLockDepth = 0;
+  sspOwner = NULL;
+
+  /* The deferred handlers run as soon as they are pending, unless
+     interrupts are disabled (in which case they wait for the next
+     release) */
+  sspPendDeferred();
+  __asm volatile ("dsb");
+  __asm volatile ("isb");
+
+  /* And take it back */
+  sspAcquire(device);
+  sspLockDepth = depth;
+  sspSelectLocked = selectLocked;
+  sspSetup(device);
+  if (selected)
+  {
+    sspAssertCS(device);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Selects a device for synchronous transfers (sspTransfer etc.)
+
+    The bus is locked for the device (see sspLock), which loads its
+    bus settings, and its chip select is driven low.  Selecting a
+    device that is already selected has no effect.
+
+    @param[in]  device
+                The device to select
+*/
+/**************************************************************************/
+void sspSelect (const sspDevice_t *device)
+{
+  sspLock(device);
+  if ((sspSelected == device) && sspSelectLocked)
+  {
+    sspUnlock(device);
+    return;
+  }
+
+  sspAssertCS(device);
+  sspSelectLocked = true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Deselects a device, including one left selected by a job
+           with SSPJOB_HOLDCS, and releases the lock taken by sspSelect
+
+    @param[in]  device
+                The device to deselect
+*/
+/**************************************************************************/
+void sspDeselect (const sspDevice_t *device)
+{
+  sspReleaseCS(device);
+  if (sspSelectLocked && (sspOwner == device))
+  {
+    sspSelectLocked = false;
+    sspUnlock(device);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Queues a transfer to run in the background
+
+    The job's device is selected and its bus settings are loaded when
+    the job reaches the head of the queue, and the transfer is then
+    carried out by the SSP interrupt handler.  The device is deselected
+    at the end unless SSPJOB_HOLDCS is set, in which case following jobs
+    for the same device continue the same transaction.
+
+    The job and its buffers belong to the SSP driver until its state
+    is SSPJOB_DONE.  The callback, if any, is then called from the SSP
+    interrupt handler and may submit new jobs.
+
+    @param[in]  job
+                The job to queue
+
+    @return     false if the job is invalid
+*/
+/**************************************************************************/
+bool sspSubmit (sspJob_t *job)
+{
+  if ((job == NULL) || (job->device == NULL))
+  {
+    return false;
+  }
+
+  job->state = SSPJOB_PENDING;
+  job->txCount = 0;
+  job->rxCount = 0;
+  job->next = NULL;
+
+  NVIC_DisableIRQ(SSP_IRQn);
+  if (sspTail == NULL)
+  {
+    /* The bus is idle so start straight away */
+    sspHead = sspTail = job;
+    sspService();
+  }
+  else
+  {
+    sspTail->next = job;
+    sspTail = job;
+  }
+  NVIC_EnableIRQ(SSP_IRQn);
+
+  return true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Queues a transfer and waits for it to finish (see sspSubmit).
+           Must not be called from an interrupt handler or with
+           interrupts disabled.
+
+    @param[in]  job
+                The job to run
+*/
+/**************************************************************************/
+void sspRun (sspJob_t *job)
+{
+  if (sspSubmit(job))
+  {
+    while (job->state == SSPJOB_PENDING);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief Indicates whether any queued jobs have still to finish
+
+    @return     true if a job is queued or in progress
+*/
+/**************************************************************************/
+bool sspIsBusy (void)
+{
+  return (sspHead != NULL);
+}
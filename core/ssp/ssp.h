@@ -77,9 +77,68 @@ typedef enum sspClockPhase_e
 } 
 sspClockPhase_t;
 
+/**************************************************************************/
+/*! 
+    A device on the SPI bus.  The chip select pin and bus settings are
+    applied by the SSP driver whenever the device is selected, so
+    several devices with different settings can share SSP0.
+*/
+/**************************************************************************/
+typedef struct sspDevice_s
+{
+  uint8_t               csPort;         // Chip select (active low)
+  uint8_t               csPin;
+  uint8_t               clockDivider;   // SCR: SCK = PCLK / (2 * (clockDivider + 1))
+  sspClockPolarity_t    polarity;
+  sspClockPhase_t       phase;
+} 
+sspDevice_t;
+
+#define SSPJOB_PENDING          (0)     // Queued or in progress
+#define SSPJOB_DONE             (1)     // Completed
+
+#define SSPJOB_HOLDCS           (0x01)  // Leave the device selected afterwards
+
+/**************************************************************************/
+/*! 
+    A queued SSP transfer (see sspSubmit).  The caller owns the job and
+    its buffers, which must stay valid until the state is SSPJOB_DONE.
+*/
+/**************************************************************************/
+typedef struct sspJob_s sspJob_t;
+typedef void (*sspCallback_t)(sspJob_t *job);
+
+struct sspJob_s
+{
+  const sspDevice_t    *device;         // Device to select for the transfer
+  const uint8_t        *txBuffer;       // Bytes to send, or NULL to send 0xFF
+  uint8_t              *rxBuffer;       // Bytes received, or NULL to discard them
+  uint32_t              length;
+  uint8_t               flags;          // SSPJOB_HOLDCS
+  sspCallback_t         callback;       // Called on completion, may be NULL
+  void                 *context;        // Not used by the driver
+  volatile uint8_t      state;          // SSPJOB_PENDING until completed
+  uint32_t              txCount;        // Used internally
+  uint32_t              rxCount;        // Used internally
+  sspJob_t             *next;           // Used internally
+};
+
 extern void SSP_IRQHandler (void);
 void sspInit (uint8_t portNum, sspClockPolarity_t polarity, sspClockPhase_t phase);
-void sspSend (uint8_t portNum, uint8_t *buf, uint32_t length);
+void sspDeviceInit (const sspDevice_t *device);
+void sspLock (const sspDevice_t *device);
+void sspUnlock (const sspDevice_t *device);
+bool sspDefer (IRQn_t irq);
+void sspYield (const sspDevice_t *device);
+void sspSelect (const sspDevice_t *device);
+void sspDeselect (const sspDevice_t *device);
+bool sspSubmit (sspJob_t *job);
+void sspRun (sspJob_t *job);
+bool sspIsBusy (void);
+void sspTransfer (uint8_t portNum, const uint8_t *tx, uint8_t *rx, uint32_t length);
+void sspTransfer16 (uint8_t portNum, const uint16_t *tx, uint16_t *rx, uint32_t length);
+void sspFill (uint8_t portNum, uint8_t value, uint32_t length);
+void sspSend (uint8_t portNum, const uint8_t *buf, uint32_t length);
 void sspReceive (uint8_t portNum, uint8_t *buf, uint32_t length);
 
 #endif
@@ -0,0 +1,206 @@
+/**************************************************************************/
+/*! 
+    @file     trace.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @section DESCRIPTION
+
+    Deferred binary trace log.  Instead of formatting text on the target,
+    each TRACEn() call stores a small binary record in a RAM ring buffer:
+
+      Byte  0     TRACE_SYNC (0xA5)
+      Byte  1     Number of arguments (0..4)
+      Bytes 2-3   Message ID from project/trace_tbl.h (little-endian)
+      Bytes 4-7   systick tick count
+      Bytes 8..   Arguments, 32-bits each (little-endian)
+      Last byte   8-bit sum of every byte after the sync byte
+
+    tracePoll drains complete records over the printf link (UART or USB
+    CDC) from the main loop, but only when they fit in the output buffer
+    without waiting, and tools/tracedec turns them back into text on the
+    host.  Records can be written from interrupts as well as from the
+    main loop.
+
+    @code
+    TRACE2(TRACE_CMD_START, cmd[0], argc);
+    @endcode
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#include <string.h>
+
+#include "trace.h"
+
+#ifdef CFG_TRACE
+
+#include "core/ringbuf/ringbuf.h"
+#include "core/systick/systick.h"
+
+#ifdef CFG_PRINTF_USBCDC
+  #include "core/usbcdc/cdc_buf.h"
+#endif
+
+#ifdef CFG_PRINTF_UART
+  #include "core/uart/uart.h"
+#endif
+
+// Sends a block of characters over the printf link (see sysinit.c)
+extern void __putdata(const char *data, uint32_t length);
+
+static uint8_t traceStorage[CFG_TRACE_BUFSIZE];
+static ringbuf_t traceFifo;
+static uint32_t traceDropped = 0;
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the number of bytes that can be queued on the printf
+            link without blocking.
+*/
+/**************************************************************************/
+static uint32_t traceOutputFree(void)
+{
+  #if defined CFG_PRINTF_USBCDC
+    return ringbufFree(cdcGetBuffer());
+  #elif defined CFG_PRINTF_UART
+    return ringbufFree(&uartGetPCB()->txfifo);
+  #else
+    return 0;
+  #endif
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Initialises the trace buffer
+*/
+/**************************************************************************/
+void traceInit(void)
+{
+  ringbufInit(&traceFifo, traceStorage, CFG_TRACE_BUFSIZE);
+  traceDropped = 0;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Stores one trace record.  Use the TRACEn() macros rather than
+            calling this directly.
+
+    The record is only written if it fits completely, otherwise it is
+    counted as dropped.  Interrupts are disabled while the record is
+    copied so that records from different contexts don't interleave.
+
+    @param[in]  id
+                Message ID (see project/trace_tbl.h)
+    @param[in]  argc
+                Number of arguments that follow (0..TRACE_MAXARGS,
+                any more are ignored)
+*/
+/**************************************************************************/
+void traceRecord(uint16_t id, uint32_t argc, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+  uint32_t record[(TRACE_RECORDSIZE(TRACE_MAXARGS) + 3) / 4];
+  uint8_t *bytes = (uint8_t *)record;
+  uint32_t length;
+  uint32_t primask, i;
+  uint8_t sum = 0;
+
+  if (argc > TRACE_MAXARGS)
+  {
+    argc = TRACE_MAXARGS;
+  }
+  length = TRACE_RECORDSIZE(argc);
+
+  record[0] = TRACE_SYNC | (argc << 8) | ((uint32_t)id << 16);
+  record[1] = systickGetTicks();
+  record[2] = a0;
+  record[3] = a1;
+  record[4] = a2;
+  record[5] = a3;
+  for (i = 1; i < length - 1; i++)
+  {
+    sum += bytes[i];
+  }
+  bytes[length - 1] = sum;
+
+  // Save PRIMASK so that records can also be written with interrupts off
+  __asm volatile ("mrs %0, primask" : "=r" (primask));
+  __disable_irq();
+  if (ringbufFree(&traceFifo) >= length)
+  {
+    ringbufWrite(&traceFifo, bytes, length);
+  }
+  else
+  {
+    traceDropped++;
+  }
+  if (!primask)
+  {
+    __enable_irq();
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends any complete trace records that fit in the output
+            buffer.  Call this regularly from the main loop.
+*/
+/**************************************************************************/
+void tracePoll(void)
+{
+  uint8_t record[TRACE_RECORDSIZE(TRACE_MAXARGS)];
+  uint8_t argc;
+  uint32_t length;
+
+  // Whole records are sent at once so printf text can't end up inside one
+  while (ringbufPeek(&traceFifo, &argc, 1, 1) == 1)
+  {
+    length = TRACE_RECORDSIZE(argc);
+    if (traceOutputFree() < length)
+    {
+      return;
+    }
+    ringbufRead(&traceFifo, record, length);
+    __putdata((const char *)record, length);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the number of records dropped because the trace
+            buffer was full
+*/
+/**************************************************************************/
+uint32_t traceGetDropped(void)
+{
+  return traceDropped;
+}
+
+#endif
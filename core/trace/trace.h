@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*! 
+    @file     trace.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include "projectconfig.h"
+
+/**************************************************************************/
+/*! 
+    Trace message IDs, generated from the format table in
+    project/trace_tbl.h.  The host decoder (tools/tracedec) includes the
+    same table to turn the IDs back into text.
+*/
+/**************************************************************************/
+typedef enum
+{
+  #define TRACE_MSG(id, format) id,
+  #include "project/trace_tbl.h"
+  #undef TRACE_MSG
+  TRACE_COUNT
+} 
+traceId_t;
+
+#define TRACE_SYNC          (0xA5)    // First byte of every record
+#define TRACE_MAXARGS       (4)       // Maximum number of 32-bit arguments
+#define TRACE_HEADERSIZE    (8)       // Sync, arg count, ID and timestamp
+#define TRACE_RECORDSIZE(argc)  (TRACE_HEADERSIZE + 4 * (argc) + 1)
+
+#ifdef CFG_TRACE
+  void     traceInit(void);
+  void     traceRecord(uint16_t id, uint32_t argc, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+  void     tracePoll(void);
+  uint32_t traceGetDropped(void);
+
+  #define TRACE0(id)                  traceRecord((id), 0, 0, 0, 0, 0)
+  #define TRACE1(id, a0)              traceRecord((id), 1, (uint32_t)(a0), 0, 0, 0)
+  #define TRACE2(id, a0, a1)          traceRecord((id), 2, (uint32_t)(a0), (uint32_t)(a1), 0, 0)
+  #define TRACE3(id, a0, a1, a2)      traceRecord((id), 3, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), 0)
+  #define TRACE4(id, a0, a1, a2, a3)  traceRecord((id), 4, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3))
+#else
+  // Trace calls compile to nothing (and their arguments aren't evaluated)
+  #define TRACE0(id)                  do { } while (0)
+  #define TRACE1(id, a0)              do { } while (0)
+  #define TRACE2(id, a0, a1)          do { } while (0)
+  #define TRACE3(id, a0, a1, a2)      do { } while (0)
+  #define TRACE4(id, a0, a1, a2, a3)  do { } while (0)
+#endif
+
+#endif
@@ -94,6 +94,7 @@
 #include <string.h>
 
 #include "uart.h"
+#include "core/systick/systick.h"
 
 #ifdef CFG_INTERFACE_UART
   #include "core/cmd/cmd.h"
@@ -108,6 +109,148 @@
 /**************************************************************************/
 static uart_pcb_t pcb;
 
+/**************************************************************************/
+/*!
+    @brief  Moves as many queued bytes as will fit into the hardware TX
+            FIFO, and enables the THRE interrupt while anything is left
+            in the TX buffer.
+
+    @note   This must be called from UART_IRQHandler or with the UART
+            interrupt disabled, since the TX buffer only supports one
+            consumer at a time.
+*/
+/**************************************************************************/
+static void uartTxFill(void)
+{
+  uint8_t *span;
+  uint32_t count, room, i;
+
+  // Only load the FIFO once it has emptied, which is when THRE is set
+  if (UART_U0LSR & UART_U0LSR_THRE)
+  {
+    room = UART_TXFIFO_DEPTH;
+    while (room && (count = ringbufReadSpan(&pcb.txfifo, &span)))
+    {
+      if (count > room)
+      {
+        count = room;
+      }
+      room -= count;
+      for (i = 0; i < count; i++)
+      {
+        UART_U0THR = span[i];
+      }
+      // Only release the bytes once they have been copied out
+      ringbufSkip(&pcb.txfifo, count);
+    }
+  }
+
+  // Keep THRE enabled until the buffer is drained
+  if (ringbufCount(&pcb.txfifo))
+  {
+    UART_U0IER |= UART_U0IER_THRE_Interrupt_Enabled;
+  }
+  else
+  {
+    UART_U0IER &= ~UART_U0IER_THRE_Interrupt_MASK;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Drains the TX buffer by polling, which allows blocking writes
+            to make progress even when called with interrupts disabled.
+*/
+/**************************************************************************/
+static void uartTxPoll(void)
+{
+  NVIC_DisableIRQ(UART_IRQn);
+  uartTxFill();
+  NVIC_EnableIRQ(UART_IRQn);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Moves everything waiting in the hardware RX FIFO into the RX
+            buffer in one pass.  Bytes that don't fit are discarded so
+            that the RDA/CTI interrupt is cleared.
+*/
+/**************************************************************************/
+static void uartRxDrain(void)
+{
+  uint8_t *span;
+  uint32_t room, count;
+  uint8_t Dummy = Dummy;
+
+  do
+  {
+    // Fill the contiguous free space, then publish it at once
+    room = ringbufWriteSpan(&pcb.rxfifo, &span);
+    count = 0;
+    while ((count < room) && (UART_U0LSR & UART_U0LSR_RDR_DATA))
+    {
+      span[count++] = UART_U0RBR;
+    }
+    ringbufWriteCommit(&pcb.rxfifo, count);
+  } while (count && (count == room));
+
+  while (UART_U0LSR & UART_U0LSR_RDR_DATA)
+  {
+    Dummy = UART_U0RBR;
+    pcb.rxfifo.overflow++;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets the divisor latch and fractional divider for the
+            closest achievable baud rate.
+
+    The UART runs at PCLK / (16 * DL * (1 + DIVADDVAL / MULVAL)).  Every
+    MULVAL/DIVADDVAL pair is tried with the nearest divisor, which gives
+    exact results for rates such as 1000000 at 72MHz and keeps 460800
+    and 921600 within 0.2%, where the integer divisor alone is off by
+    more than 20%.
+
+    @note   DLAB must already be set in U0LCR.
+*/
+/**************************************************************************/
+static void uartSetDivisors(uint32_t baudrate)
+{
+  uint32_t pclk, mul, divadd, dl, actual, err;
+  uint32_t bestErr = 0xFFFFFFFF;
+  uint32_t bestDl = 1, bestMul = 1, bestDivadd = 0;
+
+  pclk = (CFG_CPU_CCLK * SCB_SYSAHBCLKDIV) / SCB_UARTCLKDIV;
+
+  for (mul = 1; mul <= 15; mul++)
+  {
+    for (divadd = 0; divadd < mul; divadd++)
+    {
+      // Nearest divisor for this fraction
+      dl = (pclk * mul + 8 * baudrate * (mul + divadd)) / (16 * baudrate * (mul + divadd));
+      // DL must be at least 3 once the fractional divider is in use
+      if ((dl == 0) || (dl > 0xFFFF) || (divadd && (dl < 3)))
+      {
+        continue;
+      }
+      actual = (pclk * mul) / (16 * dl * (mul + divadd));
+      err = actual > baudrate ? actual - baudrate : baudrate - actual;
+      if (err < bestErr)
+      {
+        bestErr = err;
+        bestDl = dl;
+        bestMul = mul;
+        bestDivadd = divadd;
+      }
+    }
+  }
+
+  UART_U0DLM = bestDl / 256;
+  UART_U0DLL = bestDl % 256;
+  UART_U0FDR = (bestMul << 4) | bestDivadd;
+}
+
 /**************************************************************************/
 /*!
     IRQ to handle incoming data, etc.
@@ -140,37 +283,23 @@ void UART_IRQHandler(void)
     {
       /* If no error on RLS, normal ready, save into the data buffer. */
       /* Note: read RBR will clear the interrupt */
-      uartRxBufferWrite(UART_U0RBR);
+      uartRxDrain();
     }
   }
 
-  // 2.) Check receive data available
-  else if (IIRValue == UART_U0IIR_IntId_RDA)
-  {
-    // Add incoming text to UART buffer
-    uartRxBufferWrite(UART_U0RBR);
-  }
-
-  // 3.) Check character timeout indicator
-  else if (IIRValue == UART_U0IIR_IntId_CTI)
+  // 2.) Check receive data available (RX FIFO reached its trigger level)
+  //     or character timeout (fewer bytes than that left sitting in it)
+  else if ((IIRValue == UART_U0IIR_IntId_RDA) || (IIRValue == UART_U0IIR_IntId_CTI))
   {
-    /* Bit 9 as the CTI error */
-    pcb.status |= 0x100;
+    // Move the whole FIFO into the UART buffer
+    uartRxDrain();
   }
 
-  // 4.) Check THRE (transmit holding register empty)
+  // 3.) Check THRE (transmit holding register empty)
   else if (IIRValue == UART_U0IIR_IntId_THRE)
   {
-    /* Check status in the LSR to see if valid data in U0THR or not */
-    LSRValue = UART_U0LSR;
-    if (LSRValue & UART_U0LSR_THRE)
-    {
-      pcb.pending_tx_data = 0;
-    }
-    else
-    {
-      pcb.pending_tx_data= 1;
-    }
+    // Refill the hardware FIFO from the TX buffer
+    uartTxFill();
   }
   return;
 }
@@ -204,20 +333,25 @@ uart_pcb_t *uartGetPCB()
     @brief Initialises UART at the specified baud rate.
 
     @param[in]  baudRate
-                The baud rate to use when configuring the UART.
+                The baud rate to use when configuring the UART, up to
+                UART_BAUDRATE_MAX.  Non-standard rates are generated
+                with the fractional divider.
 */
 /**************************************************************************/
 void uartInit(uint32_t baudrate)
 {
-  uint32_t fDiv;
-  uint32_t regVal;
+  // Let any queued output go out at the old baud rate first
+  if (pcb.initialised)
+  {
+    uartTxFlush();
+  }
 
   NVIC_DisableIRQ(UART_IRQn);
 
   // Clear protocol control blocks
   memset(&pcb, 0, sizeof(uart_pcb_t));
-  pcb.pending_tx_data = 0;
   uartRxBufferInit();
+  uartTxBufferInit();
 
   /* Set 1.6 UART RXD */
   IOCON_PIO1_6 &= ~IOCON_PIO1_6_FUNC_MASK;
@@ -240,11 +374,7 @@ void uartInit(uint32_t baudrate)
                 UART_U0LCR_Divisor_Latch_Access_Enabled);
 
   /* Baud rate */
-  regVal = SCB_UARTCLKDIV;
-  fDiv = (((CFG_CPU_CCLK * SCB_SYSAHBCLKDIV)/regVal)/16)/baudrate;
-
-  UART_U0DLM = fDiv / 256;
-  UART_U0DLL = fDiv % 256;
+  uartSetDivisors(baudrate);
   
   /* Set DLAB back to 0 */
   UART_U0LCR = (UART_U0LCR_Word_Length_Select_8Chars |
@@ -254,20 +384,29 @@ void uartInit(uint32_t baudrate)
                 UART_U0LCR_Break_Control_Disabled |
                 UART_U0LCR_Divisor_Latch_Access_Disabled);
   
-  /* Enable and reset TX and RX FIFO. */
+  /* Enable and reset TX and RX FIFO, and set the RX trigger level. */
   UART_U0FCR = (UART_U0FCR_FIFO_Enabled | 
                 UART_U0FCR_Rx_FIFO_Reset | 
-                UART_U0FCR_Tx_FIFO_Reset); 
+                UART_U0FCR_Tx_FIFO_Reset |
+                #if CFG_UART_RXTRIGGER == 14
+                  UART_U0FCR_Rx_Trigger_Level_Select_12Char);
+                #elif CFG_UART_RXTRIGGER == 8
+                  UART_U0FCR_Rx_Trigger_Level_Select_8Char);
+                #elif CFG_UART_RXTRIGGER == 4
+                  UART_U0FCR_Rx_Trigger_Level_Select_4Char);
+                #else
+                  UART_U0FCR_Rx_Trigger_Level_Select_1Char);
+                #endif
 
   /* Read to clear the line status. */
-  regVal = UART_U0LSR;
+  (void)UART_U0LSR;
 
   /* Ensure a clean start, no data in either TX or RX FIFO. */
   while (( UART_U0LSR & (UART_U0LSR_THRE|UART_U0LSR_TEMT)) != (UART_U0LSR_THRE|UART_U0LSR_TEMT) );
   while ( UART_U0LSR & UART_U0LSR_RDR_DATA )
   {
     /* Dump data from RX FIFO */
-    regVal = UART_U0RBR;
+    (void)UART_U0RBR;
   }
 
   /* Set the initialised flag in the protocol control block */
@@ -281,10 +420,175 @@ void uartInit(uint32_t baudrate)
   return;
 }
 
+/**************************************************************************/
+/*! 
+    @brief Detects the baud rate of the remote device from a sync
+           character using the UART's auto-baud unit.
+
+    The remote device must send 'A' or 'a' (any character with bit 0
+    set, such as 'U', also works).  The divisor is measured from the
+    length of its start bit (auto-baud mode 1) and loaded into the
+    UART, after which the sync character is discarded.  UART must
+    already be initialised.
+
+    @param[in]  timeoutMs
+                Time to wait for the sync character in milliseconds
+
+    @returns    The detected baud rate, or 0 if no sync character was
+                received in time (the previous baud rate is restored)
+
+    @section Example
+
+    @code
+    printf("Send 'A' at any speed to continue%s", CFG_PRINTF_NEWLINE);
+    if (uartAutoBaud(10000))
+    {
+      printf("Detected %d baud%s", pcb->baudrate, CFG_PRINTF_NEWLINE);
+    }
+    @endcode
+*/
+/**************************************************************************/
+uint32_t uartAutoBaud(uint32_t timeoutMs)
+{
+  uint32_t start, dl, baudrate;
+
+  if (!pcb.initialised)
+  {
+    return 0;
+  }
+  uartTxFlush();
+
+  // Auto-baud only measures the integer divisor
+  NVIC_DisableIRQ(UART_IRQn);
+  UART_U0FDR = 0x10;
+  UART_U0ACR = UART_U0ACR_Start | UART_U0ACR_Mode_Mode1 | UART_U0ACR_AutoRestart_Restart;
+
+  // The start bit clears itself once the measurement is complete
+  start = systickGetTicks();
+  while (UART_U0ACR & UART_U0ACR_Start)
+  {
+    if ((systickGetTicks() - start) > timeoutMs)
+    {
+      UART_U0ACR = UART_U0ACR_ABEOIntClr | UART_U0ACR_ABTOIntClr;
+      NVIC_EnableIRQ(UART_IRQn);
+      uartInit(pcb.baudrate);
+      return 0;
+    }
+  }
+  UART_U0ACR = UART_U0ACR_ABEOIntClr | UART_U0ACR_ABTOIntClr;
+
+  // Read back the measured divisor
+  UART_U0LCR |= UART_U0LCR_Divisor_Latch_Access_Enabled;
+  dl = UART_U0DLM * 256 + UART_U0DLL;
+  UART_U0LCR &= ~UART_U0LCR_Divisor_Latch_Access_Enabled;
+  baudrate = ((CFG_CPU_CCLK * SCB_SYSAHBCLKDIV) / SCB_UARTCLKDIV) / (16 * (dl ? dl : 1));
+
+  // Drop the sync character and anything else received during detection
+  uartRxDrain();
+  uartRxBufferClearFIFO();
+  pcb.baudrate = baudrate;
+  NVIC_EnableIRQ(UART_IRQn);
+
+  return baudrate;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Queues the supplied buffer for transmission without waiting
+           for it to go out on the wire.
+
+    The bytes are copied into the TX buffer and sent by the THRE
+    interrupt.  When the buffer is full, CFG_UART_TXPOLICY decides
+    whether to wait for space (UART_TXPOLICY_BLOCK), discard the bytes
+    that don't fit (UART_TXPOLICY_DROP), or discard the oldest queued
+    bytes to make room (UART_TXPOLICY_OVERWRITE).  Discarded bytes are
+    counted in 'txfifo.overflow' in the protocol control block.
+
+    @param[in]  buffer
+                Pointer to the data to send
+    @param[in]  length
+                The number of bytes to send
+
+    @returns    The number of bytes from 'buffer' that were queued, which
+                is less than 'length' only with UART_TXPOLICY_DROP.
+*/
+/**************************************************************************/
+uint32_t uartWrite(const uint8_t *buffer, uint32_t length)
+{
+  uint32_t queued = 0;
+  uint32_t count;
+
+  if (!pcb.initialised)
+  {
+    return 0;
+  }
+
+  while (queued < length)
+  {
+    // The ISR only ever frees space, so this is a safe lower bound
+    count = ringbufFree(&pcb.txfifo);
+    if (count == 0)
+    {
+      #if CFG_UART_TXPOLICY == UART_TXPOLICY_DROP
+        pcb.txfifo.overflow += length - queued;
+        break;
+      #elif CFG_UART_TXPOLICY == UART_TXPOLICY_OVERWRITE
+        // Act as the consumer with the ISR held off to drop the oldest byte
+        NVIC_DisableIRQ(UART_IRQn);
+        if (ringbufFree(&pcb.txfifo) == 0)
+        {
+          ringbufSkip(&pcb.txfifo, 1);
+          pcb.txfifo.overflow++;
+        }
+        NVIC_EnableIRQ(UART_IRQn);
+      #else
+        uartTxPoll();
+      #endif
+      continue;
+    }
+    if (count > length - queued)
+    {
+      count = length - queued;
+    }
+
+    queued += ringbufWrite(&pcb.txfifo, &buffer[queued], count);
+
+    // Start transmission if the FIFO has already drained
+    NVIC_DisableIRQ(UART_IRQn);
+    uartTxFill();
+    NVIC_EnableIRQ(UART_IRQn);
+  }
+
+  return queued;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Waits until every queued byte has left the transmitter, which
+           is required before changing the baud rate or powering down.
+*/
+/**************************************************************************/
+void uartTxFlush(void)
+{
+  if (!pcb.initialised)
+  {
+    return;
+  }
+
+  while (ringbufCount(&pcb.txfifo))
+  {
+    uartTxPoll();
+  }
+  while (!(UART_U0LSR & UART_U0LSR_TEMT));
+}
+
 /**************************************************************************/
 /*! 
     @brief Sends the contents of supplied text buffer over UART.
 
+    The data is queued through uartWrite, so this only waits when the
+    TX buffer is full and CFG_UART_TXPOLICY is UART_TXPOLICY_BLOCK.
+
     @param[in]  bufferPtr
                 Pointer to the text buffer
     @param[in]  bufferPtr
@@ -303,15 +607,7 @@ void uartInit(uint32_t baudrate)
 /**************************************************************************/
 void uartSend (uint8_t *bufferPtr, uint32_t length)
 {
-  while (length != 0)
-  {
-    /* THRE status, contain valid data */
-    while ( !(UART_U0LSR & UART_U0LSR_THRE) );
-    UART_U0THR = *bufferPtr;
-
-    bufferPtr++;
-    length--;
-  }
+  uartWrite(bufferPtr, length);
 
   return;
 }
@@ -336,9 +632,7 @@ void uartSend (uint8_t *bufferPtr, uint32_t length)
 /**************************************************************************/
 void uartSendByte (uint8_t byte)
 {
-  /* THRE status, contain valid data */
-  while ( !(UART_U0LSR & UART_U0LSR_THRE) );
-  UART_U0THR = byte;
+  uartWrite(&byte, 1);
 
   return;
 }
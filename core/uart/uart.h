@@ -40,16 +40,18 @@
 #define __UART_H__
 
 #include "projectconfig.h"
+#include "core/ringbuf/ringbuf.h"
 
-// Buffer used for circular fifo
-typedef struct _uart_buffer_t
-{
-  uint8_t ep_dir;
-  volatile uint8_t len;
-  volatile uint8_t wr_ptr;
-  volatile uint8_t rd_ptr;
-  uint8_t buf[CFG_UART_BUFSIZE];
-} uart_buffer_t;
+// Full TX buffer policies (see CFG_UART_TXPOLICY)
+#define UART_TXPOLICY_BLOCK       (0)   // Wait for the THRE interrupt to free space
+#define UART_TXPOLICY_DROP        (1)   // Discard the bytes that don't fit
+#define UART_TXPOLICY_OVERWRITE   (2)   // Discard the oldest queued bytes
+
+// Depth of the hardware TX FIFO
+#define UART_TXFIFO_DEPTH         (16)
+
+// Highest baud rate the fractional divider can generate accurately
+#define UART_BAUDRATE_MAX         (1000000)
 
 // UART Protocol control block
 typedef struct _uart_pcb_t
@@ -57,15 +59,18 @@ typedef struct _uart_pcb_t
   BOOL initialised;
   uint32_t baudrate;
   uint32_t status;
-  uint32_t pending_tx_data;
-  uart_buffer_t rxfifo;
+  ringbuf_t rxfifo;
+  ringbuf_t txfifo;
 } uart_pcb_t;
 
 void UART_IRQHandler(void);
 uart_pcb_t *uartGetPCB();
 void uartInit(uint32_t Baudrate);
+uint32_t uartAutoBaud(uint32_t timeoutMs);
 void uartSend(uint8_t *BufferPtr, uint32_t Length);
 void uartSendByte (uint8_t byte);
+uint32_t uartWrite(const uint8_t *buffer, uint32_t length);
+void uartTxFlush(void);
 
 // Rx Buffer access control
 void uartRxBufferInit();
@@ -75,4 +80,8 @@ void uartRxBufferClearFIFO();
 uint8_t uartRxBufferDataPending();
 bool uartRxBufferReadArray(byte_t* rx, size_t* len);
 
+// Tx Buffer access control
+void uartTxBufferInit();
+uint32_t uartTxBufferDataPending();
+
 #endif
@@ -50,6 +50,9 @@
 
 #include "uart.h"
 
+static uint8_t uartRxStorage[CFG_UART_BUFSIZE];
+static uint8_t uartTxStorage[CFG_UART_TXBUFSIZE];
+
 /**************************************************************************/
 /*!
   Initialises the RX FIFO buffer
@@ -58,25 +61,21 @@
 void uartRxBufferInit()
 {
   uart_pcb_t *pcb = uartGetPCB();
-  pcb->rxfifo.len = 0;
+  ringbufInit(&pcb->rxfifo, uartRxStorage, CFG_UART_BUFSIZE);
 }
 
 /**************************************************************************/
 /*!
-  Read one byte out of the RX buffer. This function will return the byte
-  located at the array index of the read pointer, and then increment the
-  read pointer index.  If the read pointer exceeds the maximum buffer
-  size, it will roll over to zero.
+  Read one byte out of the RX buffer.  Returns 0 if the buffer is empty,
+  so check uartRxBufferDataPending first.
 */
 /**************************************************************************/
 uint8_t uartRxBufferRead()
 {
   uart_pcb_t *pcb = uartGetPCB();
-  uint8_t data;
+  uint8_t data = 0;
 
-  data = pcb->rxfifo.buf[pcb->rxfifo.rd_ptr];
-  pcb->rxfifo.rd_ptr = (pcb->rxfifo.rd_ptr + 1) % CFG_UART_BUFSIZE;
-  pcb->rxfifo.len--;
+  ringbufGet(&pcb->rxfifo, &data);
   return data;
 }
 
@@ -88,47 +87,35 @@ uint8_t uartRxBufferRead()
 bool uartRxBufferReadArray(byte_t* rx, size_t* len)
 {
   uart_pcb_t *pcb = uartGetPCB();
-  *len = 0;
-  
-  while(pcb->rxfifo.len != 0)
-  {
-    (*rx) = uartRxBufferRead();
-    (*len)++;
-    rx++;
-  }
+
+  *len = ringbufRead(&pcb->rxfifo, rx, ringbufCount(&pcb->rxfifo));
   
   return (*len != 0);
 }
 
 /**************************************************************************/
 /*!
-  Write one byte into the RX buffer. This function will write one
-  byte into the array index specified by the write pointer and increment
-  the write index. If the write index exceeds the max buffer size, then it
-  will roll over to zero.
+  Write one byte into the RX buffer.  If the buffer is full the byte is
+  dropped and counted in 'rxfifo.overflow'.
 */
 /**************************************************************************/
 void uartRxBufferWrite(uint8_t data)
 {
   uart_pcb_t *pcb = uartGetPCB();
 
-  pcb->rxfifo.buf[pcb->rxfifo.wr_ptr] = data;
-  pcb->rxfifo.wr_ptr = (pcb->rxfifo.wr_ptr + 1) % CFG_UART_BUFSIZE;
-  pcb->rxfifo.len++;
+  ringbufPut(&pcb->rxfifo, data);
 }
 
 /**************************************************************************/
 /*!
-    Clear the fifo read and write pointers and set the length to zero.
+    Discard any data waiting in the RX buffer.
 */
 /**************************************************************************/
 void uartRxBufferClearFIFO()
 {
   uart_pcb_t *pcb = uartGetPCB();
 
-  pcb->rxfifo.rd_ptr = 0;
-  pcb->rxfifo.wr_ptr = 0;
-  pcb->rxfifo.len = 0;
+  ringbufClear(&pcb->rxfifo);
 }
 
 /**************************************************************************/
@@ -140,10 +127,36 @@ uint8_t uartRxBufferDataPending()
 {
   uart_pcb_t *pcb = uartGetPCB();
 
-  if (pcb->rxfifo.len != 0)
+  if (ringbufCount(&pcb->rxfifo) != 0)
   {
     return 1;
   }
 
   return 0;
 }
+
+/**************************************************************************/
+/*!
+    Initialises the TX buffer.  Any bytes still queued for transmission
+    are discarded.
+*/
+/**************************************************************************/
+void uartTxBufferInit()
+{
+  uart_pcb_t *pcb = uartGetPCB();
+
+  ringbufInit(&pcb->txfifo, uartTxStorage, CFG_UART_TXBUFSIZE);
+}
+
+/**************************************************************************/
+/*!
+    Returns the number of bytes waiting in the TX buffer (not counting
+    the bytes already moved into the hardware FIFO).
+*/
+/**************************************************************************/
+uint32_t uartTxBufferDataPending()
+{
+  uart_pcb_t *pcb = uartGetPCB();
+
+  return ringbufCount(&pcb->txfifo);
+}
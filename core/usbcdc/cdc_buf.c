@@ -50,14 +50,15 @@
 
 #include "cdc_buf.h"
 
-static cdc_buffer_t cdcfifo;
+static uint8_t cdcStorage[CFG_USBCDC_BUFFERSIZE];
+static ringbuf_t cdcfifo;
 
 /**************************************************************************/
 /*!
   Gets a pointer to the fifo buffer
 */
 /**************************************************************************/
-cdc_buffer_t *cdcGetBuffer()
+ringbuf_t *cdcGetBuffer()
 {
   return &cdcfifo;
 }
@@ -69,80 +70,62 @@ cdc_buffer_t *cdcGetBuffer()
 /**************************************************************************/
 void cdcBufferInit()
 {
-  cdcfifo.len = 0;
+  ringbufInit(&cdcfifo, cdcStorage, CFG_USBCDC_BUFFERSIZE);
 }
 
 /**************************************************************************/
 /*!
-  Read one byte out of the RX buffer. This function will return the byte
-  located at the array index of the read pointer, and then increment the
-  read pointer index.  If the read pointer exceeds the maximum buffer
-  size, it will roll over to zero.
+  Read one byte out of the buffer.  Returns 0 if the buffer is empty, so
+  check cdcBufferDataPending first.
 */
 /**************************************************************************/
 uint8_t cdcBufferRead()
 {
-  uint8_t data;
+  uint8_t data = 0;
 
-  data = cdcfifo.buf[cdcfifo.rd_ptr];
-  cdcfifo.rd_ptr = (cdcfifo.rd_ptr + 1) % CFG_USBCDC_BUFFERSIZE;
-  cdcfifo.len--;
+  ringbufGet(&cdcfifo, &data);
   return data;
 }
 
 /**************************************************************************/
 /*!
-  Reads x bytes from cdc buffer
+  Reads up to x bytes from cdc buffer, returning the number actually read
  */
 /**************************************************************************/
 uint32_t cdcBufferReadLen(uint8_t* buf, uint32_t len)
 {
-  uint32_t counter, actual;
-  counter = actual = 0;
-
-  while(counter != len)
-  {
-    // Make sure we don't exceed buffer limits
-    if (cdcfifo.len > 0)
-    {
-      buf[counter] = cdcBufferRead();
-      actual++;
-      counter++;
-    }
-    else
-    {
-      return actual;
-    }
-  }
-
-  return actual;
+  return ringbufRead(&cdcfifo, buf, len);
 }
 
 /**************************************************************************/
 /*!
-  Write one byte into the RX buffer. This function will write one
-  byte into the array index specified by the write pointer and increment
-  the write index. If the write index exceeds the max buffer size, then it
-  will roll over to zero.
+  Write one byte into the buffer.  If the buffer is full the byte is
+  dropped and counted in the buffer's overflow statistics.
 */
 /**************************************************************************/
 void cdcBufferWrite(uint8_t data)
 {
-  cdcfifo.buf[cdcfifo.wr_ptr] = data;
-  cdcfifo.wr_ptr = (cdcfifo.wr_ptr + 1) % CFG_USBCDC_BUFFERSIZE;
-  cdcfifo.len++;
+  ringbufPut(&cdcfifo, data);
+}
+
+/**************************************************************************/
+/*!
+  Writes up to x bytes into the buffer, returning the number that fit
+*/
+/**************************************************************************/
+uint32_t cdcBufferWriteLen(const uint8_t* buf, uint32_t len)
+{
+  return ringbufWrite(&cdcfifo, buf, len);
 }
 
 /**************************************************************************/
 /*!
-    Clear the fifo read and write pointers and set the length to zero.
+    Discard any data waiting in the buffer.
 */
 /**************************************************************************/
 void cdcBufferClearFIFO()
 {
-  cdcfifo.rd_ptr = 0;
-  cdcfifo.wr_ptr = 0;
-  cdcfifo.len = 0;
+  ringbufClear(&cdcfifo);
 }
 
 /**************************************************************************/
@@ -152,7 +135,7 @@ void cdcBufferClearFIFO()
 /**************************************************************************/
 uint8_t cdcBufferDataPending()
 {
-  if (cdcfifo.len != 0)
+  if (ringbufCount(&cdcfifo) != 0)
   {
     return 1;
   }
@@ -16,93 +16,113 @@
  * Copyright (c) 2009 Keil - An ARM Company. All rights reserved.
  *---------------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "projectconfig.h"
 
 #include "usb.h"
 #include "usbhw.h"
 #include "usbcfg.h"
 #include "usbcore.h"
+#include "usbreg.h"
 #include "cdc.h"
 #include "cdcuser.h"
 #include "cdc_buf.h"
+#include "core/systick/systick.h"
+
+#define CDC_BULK_PACKET     (64)    // wMaxPacketSize of the data endpoints (see usbdesc.c)
+#define CDC_IN_TIMEOUT      (50)    // ms without a completed IN packet before output is dropped
 
-// unsigned char BulkBufIn  [64];            // Buffer to store USB IN  packet
-unsigned char BulkBufOut [64];            // Buffer to store USB OUT packet
+unsigned char BulkBufIn  [CDC_BULK_PACKET];   // Buffer to store USB IN  packet
 unsigned char NotificationBuf [10];
 
 CDC_LINE_CODING CDC_LineCoding  = {CFG_USBCDC_BAUDRATE, 0, 0, 8};
 unsigned short  CDC_SerialState = 0x0000;
 unsigned short  CDC_DepInEmpty  = 1;                   // Data IN EP is empty
+volatile unsigned char CDC_DepInStalled = 0;           // Host stopped taking IN packets
+static unsigned char CDC_DepInFull = 0;                // Last IN packet was full size
 
 /*----------------------------------------------------------------------------
   We need a buffer for incoming data on USB port because USB receives
-  much faster than  UART transmits
+  much faster than the data can be processed.  OUT packets are read straight
+  from the endpoint into a linear buffer, which the command parser works on
+  in place (see 'cmdPoll' in core/cmd/cmd.c), so it holds a full command line
+  plus room for the packets that follow it.  When there isn't room for
+  another packet, the packet is left in the endpoint and the hardware NAKs
+  the host until CDC_OutBufConsume frees some space.
  *---------------------------------------------------------------------------*/
-/* Buffer masks */
-#define CDC_BUF_SIZE               (64)   // Output buffer in bytes (power 2)
-                                                       // large enough for file transfer
-#define CDC_BUF_MASK               (CDC_BUF_SIZE-1ul)
+#ifdef CFG_INTERFACE_MAXMSGSIZE
+  #define CDC_BUF_SIZE             (CFG_INTERFACE_MAXMSGSIZE + 2 * CDC_BULK_PACKET)
+#else
+  #define CDC_BUF_SIZE             (2 * CDC_BULK_PACKET)
+#endif
 
-/* Buffer read / write macros */
-#define CDC_BUF_RESET(cdcBuf)      (cdcBuf.rdIdx = cdcBuf.wrIdx = 0)
-#define CDC_BUF_WR(cdcBuf, dataIn) (cdcBuf.data[CDC_BUF_MASK & cdcBuf.wrIdx++] = (dataIn))
-#define CDC_BUF_RD(cdcBuf)         (cdcBuf.data[CDC_BUF_MASK & cdcBuf.rdIdx++])   
-#define CDC_BUF_EMPTY(cdcBuf)      (cdcBuf.rdIdx == cdcBuf.wrIdx)
-#define CDC_BUF_FULL(cdcBuf)       (cdcBuf.rdIdx == cdcBuf.wrIdx+1)
-#define CDC_BUF_COUNT(cdcBuf)      (CDC_BUF_MASK & (cdcBuf.wrIdx - cdcBuf.rdIdx))
+/* Buffer macros */
+#define CDC_BUF_RESET(cdcBuf)      (cdcBuf.wrIdx = 0)
+#define CDC_BUF_COUNT(cdcBuf)      (cdcBuf.wrIdx)
+#define CDC_BUF_FREE(cdcBuf)       (CDC_BUF_SIZE - cdcBuf.wrIdx)
 
 
 // CDC output buffer
 typedef struct __CDC_BUF_T 
 {
   unsigned char data[CDC_BUF_SIZE];
-  volatile unsigned int wrIdx;
-  volatile unsigned int rdIdx;
+  volatile unsigned int wrIdx;                         // only grows in the USB ISR
 } CDC_BUF_T;
 
 CDC_BUF_T  CDC_OutBuf;                                 // buffer for all CDC Out data
+static volatile unsigned char CDC_DepOutNak = 0;       // Data OUT EP is being NAKed
 
 /*----------------------------------------------------------------------------
   read data from CDC_OutBuf
  *---------------------------------------------------------------------------*/
 int CDC_RdOutBuf (char *buffer, const int *length) 
 {
-  int bytesToRead, bytesRead;
+  int bytesRead;
   
-  /* Read *length bytes, block if *bytes are not avaialable	*/
-  bytesToRead = *length;
-  bytesToRead = (bytesToRead < (*length)) ? bytesToRead : (*length);
-  bytesRead = bytesToRead;
-
+  /* Read up to *length bytes */
+  bytesRead = CDC_BUF_COUNT(CDC_OutBuf);
+  bytesRead = (bytesRead < (*length)) ? bytesRead : (*length);
 
-  // ... add code to check for underrun
+  memcpy(buffer, CDC_OutBuf.data, bytesRead);
+  CDC_OutBufConsume(bytesRead);
 
-  while (bytesToRead--) {
-    *buffer++ = CDC_BUF_RD(CDC_OutBuf);
-  }
   return (bytesRead);  
 }
 
 /*----------------------------------------------------------------------------
-  write data to CDC_OutBuf
+  get direct access to the data in CDC_OutBuf.  The returned bytes belong to
+  the caller until they are released with CDC_OutBufConsume, and may be
+  modified in place (the ISR only ever appends after them).
  *---------------------------------------------------------------------------*/
-int CDC_WrOutBuf (const char *buffer, int *length) 
+char *CDC_OutBufData (int *length) 
 {
-  int bytesToWrite, bytesWritten;
-
-  // Write *length bytes
-  bytesToWrite = *length;
-  bytesWritten = bytesToWrite;
+  *length = CDC_BUF_COUNT(CDC_OutBuf);
 
+  return ((char *)CDC_OutBuf.data);
+}
 
-  // ... add code to check for overwrite
-
-  while (bytesToWrite) {
-      CDC_BUF_WR(CDC_OutBuf, *buffer++);           // Copy Data to buffer  
-      bytesToWrite--;
-  }     
+/*----------------------------------------------------------------------------
+  release the first length bytes of CDC_OutBuf, and collect any packet held
+  back in the endpoint while the buffer was full
+ *---------------------------------------------------------------------------*/
+void CDC_OutBufConsume (int length) 
+{
+  NVIC_DisableIRQ(USB_IRQn);
+
+  memmove(CDC_OutBuf.data, &CDC_OutBuf.data[length], CDC_OutBuf.wrIdx - length);
+  CDC_OutBuf.wrIdx -= length;
+
+  while (CDC_DepOutNak && (CDC_BUF_FREE(CDC_OutBuf) >= CDC_BULK_PACKET)) {
+    if (USB_SelectEP(CDC_DEP_OUT) & EP_SEL_F) {
+      CDC_OutBuf.wrIdx += USB_ReadEP(CDC_DEP_OUT, &CDC_OutBuf.data[CDC_OutBuf.wrIdx]);
+    }
+    else {
+      CDC_DepOutNak = 0;
+    }
+  }
 
-  return (bytesWritten); 
+  NVIC_EnableIRQ(USB_IRQn);
 }
 
 /*----------------------------------------------------------------------------
@@ -114,6 +134,77 @@ int CDC_OutBufAvailChar (int *availChar)
 
   return (0);
 }
+
+/*----------------------------------------------------------------------------
+  get the capacity of CDC_OutBuf, which is the longest line it can hold
+  while still accepting packets
+ *---------------------------------------------------------------------------*/
+int CDC_OutBufSize (void) 
+{
+  return (CDC_BUF_SIZE - CDC_BULK_PACKET);
+}
+
+/*----------------------------------------------------------------------------
+  write data to the IN buffer (see 'cdc_buf.c'), which CDC_BulkIn sends to
+  the host one packet per IN interrupt.  If the buffer is full this waits
+  for space for as long as the host keeps accepting packets, and drops the
+  rest if it stops reading for CDC_IN_TIMEOUT ms (port not open, etc.)
+  After that, output is dropped straight away until the host takes the
+  next packet, so printf doesn't hold up the main loop every time.
+  Return Value: number of bytes queued
+ *---------------------------------------------------------------------------*/
+int CDC_WrInBuf (const char *buffer, int length) 
+{
+  ringbuf_t *fifo = cdcGetBuffer();
+  uint32_t count, tail, start;
+  int queued = 0;
+
+  start = systickGetTicks();
+  tail = fifo->tail;
+  while (queued < length) 
+  {
+    count = ringbufFree(fifo);
+    if (count == 0) 
+    {
+      // Restart the timeout each time the host takes a packet
+      if (fifo->tail != tail) 
+      {
+        tail = fifo->tail;
+        start = systickGetTicks();
+      }
+      else if (CDC_DepInStalled || !USB_Configuration || (systickGetTicks() - start) > CDC_IN_TIMEOUT) 
+      {
+        CDC_DepInStalled = 1;
+        fifo->overflow += length - queued;
+        break;
+      }
+      continue;
+    }
+    if (count > (uint32_t)(length - queued)) 
+    {
+      count = length - queued;
+    }
+    queued += ringbufWrite(fifo, (const uint8_t *)&buffer[queued], count);
+    CDC_BulkInStart();
+  }
+
+  return (queued);
+}
+
+/*----------------------------------------------------------------------------
+  start sending the IN buffer if the IN endpoint is idle.  Once started,
+  CDC_BulkIn keeps refilling the endpoint from the IN complete interrupt.
+ *---------------------------------------------------------------------------*/
+void CDC_BulkInStart (void) 
+{
+  NVIC_DisableIRQ(USB_IRQn);
+  if (CDC_DepInEmpty && ringbufCount(cdcGetBuffer())) 
+  {
+    CDC_DepInEmpty = 0;
+    CDC_BulkIn();
+  }
+  NVIC_EnableIRQ(USB_IRQn);
+}
 /* end Buffer handling */
 
 
@@ -126,14 +217,17 @@ int CDC_OutBufAvailChar (int *availChar)
 void CDC_Init (void) 
 {
   CDC_DepInEmpty  = 1;
+  CDC_DepInFull   = 0;
+  CDC_DepInStalled = 0;
   CDC_SerialState = CDC_GetSerialState();
 
   CDC_BUF_RESET(CDC_OutBuf);
+  CDC_DepOutNak = 0;
 
   // Initialise the CDC buffer.   This is required to buffer outgoing
-  // data (MCU to PC) since data can only be sent 64 bytes per frame
-  // with at least 1ms between frames.  To see how the buffer is used,
-  // see 'puts' in systeminit.c
+  // data (MCU to PC) until the IN endpoint interrupt can send it to
+  // the host.  To see how the buffer is filled, see 'puts' in
+  // systeminit.c and CDC_WrInBuf.
   cdcBufferInit();
 }
 
@@ -272,30 +366,30 @@ uint32_t CDC_SendBreak (unsigned short wDurationOfBreak) {
 
 /*----------------------------------------------------------------------------
   CDC_BulkIn call on DataIn Request
+  Also called by CDC_BulkInStart (with the USB interrupt disabled) to send
+  the first packet when the endpoint is idle.
   Parameters:   none
   Return Value: none
  *---------------------------------------------------------------------------*/
 void CDC_BulkIn(void) 
 {
-//  int numBytesRead, numBytesAvail;
-//
-//  // ToDo: Modify BulkIn to send incoming data to USB
-//        
-//  ser_AvailChar (&numBytesAvail);
-//
-//  // ... add code to check for overwrite
-//
-//  numBytesRead = ser_Read ((char *)&BulkBufIn[0], &numBytesAvail);
-//
-//  // send over USB
-//  if (numBytesRead > 0) {
-//	USB_WriteEP (CDC_DEP_IN, &BulkBufIn[0], numBytesRead);
-//  }
-//  else {
-//    CDC_DepInEmpty = 1;
-//  }
-//
-//
+  int numBytesRead;
+
+  // the host is reading again
+  CDC_DepInStalled = 0;
+
+  // get the next packet from the IN buffer
+  numBytesRead = ringbufRead(cdcGetBuffer(), &BulkBufIn[0], CDC_BULK_PACKET);
+
+  // send over USB, ending a run of full packets with a zero-length
+  // packet so the host doesn't wait for more data
+  if ((numBytesRead > 0) || CDC_DepInFull) {
+    USB_WriteEP (CDC_DEP_IN, &BulkBufIn[0], numBytesRead);
+    CDC_DepInFull = (numBytesRead == CDC_BULK_PACKET);
+  }
+  else {
+    CDC_DepInEmpty = 1;
+  }
 } 
 
 
@@ -306,15 +400,15 @@ void CDC_BulkIn(void)
  *---------------------------------------------------------------------------*/
 void CDC_BulkOut(void) 
 {
-  int numBytesRead;
-
-  // get data from USB into intermediate buffer
-  numBytesRead = USB_ReadEP(CDC_DEP_OUT, &BulkBufOut[0]);
-
-  // ... add code to check for overwrite
+  // leave the packet in the endpoint (which NAKs the host) until there
+  // is room for it, see CDC_OutBufConsume
+  if (CDC_BUF_FREE(CDC_OutBuf) < CDC_BULK_PACKET) {
+    CDC_DepOutNak = 1;
+    return;
+  }
 
-  // store data in a buffer to transmit it over serial interface
-  CDC_WrOutBuf ((char *)&BulkBufOut[0], &numBytesRead);
+  // read the packet straight into the buffer
+  CDC_OutBuf.wrIdx += USB_ReadEP(CDC_DEP_OUT, &CDC_OutBuf.data[CDC_OutBuf.wrIdx]);
 }
 
 
@@ -21,8 +21,12 @@
 
 /* CDC buffer handling */
 extern int CDC_RdOutBuf        (char *buffer, const int *length);
-extern int CDC_WrOutBuf        (const char *buffer, int *length);
+extern char *CDC_OutBufData    (int *length);
+extern void CDC_OutBufConsume  (int length);
 extern int CDC_OutBufAvailChar (int *availChar);
+extern int CDC_OutBufSize      (void);
+extern int CDC_WrInBuf         (const char *buffer, int length);
+extern void CDC_BulkInStart    (void);
 
 
 /* CDC Data In/Out Endpoint Address */
@@ -58,6 +62,7 @@ extern unsigned short CDC_GetSerialState (void);
 
 /* flow control */
 extern unsigned short CDC_DepInEmpty;         // DataEndPoint IN empty
+extern volatile unsigned char CDC_DepInStalled;  // Host stopped taking IN packets
 
 #endif  /* __CDCUSER_H__ */
 
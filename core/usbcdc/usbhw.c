@@ -412,6 +412,21 @@ void USB_ClearEPBuf (uint32_t EPNum)
 }
 
 
+/*
+ *  Get USB Endpoint Status
+ *    Parameters:      EPNum: Endpoint Number
+ *                       EPNum.0..3: Address
+ *                       EPNum.7:    Dir
+ *    Return Value:    Select Endpoint status (EP_SEL_F, etc.)
+ */
+
+uint32_t USB_SelectEP (uint32_t EPNum) 
+{
+  WrCmd(CMD_SEL_EP(EPAdr(EPNum)));
+  return (RdCmdDat(DAT_SEL_EP(EPAdr(EPNum))));
+}
+
+
 /*
  *  Read USB Endpoint Data
  *    Parameters:      EPNum: Endpoint Number
@@ -23,6 +23,7 @@
 #include "usbcore.h"
 #include "usbuser.h"
 #include "cdcuser.h"
+#include "core/trace/trace.h"
 
 
 /*
@@ -114,7 +115,10 @@ void USB_Error_Event (uint32_t error) {
 void USB_Configure_Event (void) {
 
   if (USB_Configuration) {                  /* Check if USB is configured */
-    /* add your code here */
+    TRACE1(TRACE_USB_CONFIGURED, USB_Configuration);
+    CDC_DepInEmpty = 1;                     /* Data IN EP starts out idle */
+    CDC_DepInStalled = 0;                   /* Give the host another chance */
+    CDC_BulkInStart();                      /* Send anything queued before */
   }
 }
 #endif
@@ -159,7 +159,7 @@ U8 chb_write(U16 addr, U8 *data, U8 len)
 /**************************************************************************/
 U8 chb_read(chb_rx_data_t *rx)
 {
-    U8 i, len, seq, *data_ptr;
+    U8 len, seq, *data_ptr;
 
     data_ptr = rx->data;
 
@@ -172,10 +172,7 @@ U8 chb_read(chb_rx_data_t *rx)
     *data_ptr++ = len;
 
     // load the rest of the data into buffer
-    for (i=0; i<len; i++)
-    {
-        *data_ptr++ = chb_buf_read();
-    }
+    chb_buf_read_len(data_ptr, len);
 
     // we're using the buffer that's fed in as an argument as a temp
     // buffer as well to save resources.
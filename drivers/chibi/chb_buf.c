@@ -34,10 +34,11 @@
 #include <stdio.h>
 #include "chb_buf.h"
 #include "projectconfig.h"
+#include "core/ringbuf/ringbuf.h"
 
-static U8 chb_buf[CFG_CHIBI_BUFFERSIZE];
-static volatile U32 rd_ptr, wr_ptr;
-static volatile U32 len;
+// Written by the radio ISR and read from the main loop
+static U8 chb_storage[CFG_CHIBI_BUFFERSIZE];
+static ringbuf_t chb_buf;
 
 /**************************************************************************/
 /*!
@@ -46,9 +47,7 @@ static volatile U32 len;
 /**************************************************************************/
 void chb_buf_init()
 {
-    rd_ptr = 0;
-    wr_ptr = 0;
-    len = 0;
+    ringbufInit(&chb_buf, chb_storage, CFG_CHIBI_BUFFERSIZE);
 }
 
 /**************************************************************************/
@@ -58,9 +57,7 @@ void chb_buf_init()
 /**************************************************************************/
 void chb_buf_write(U8 data)
 {
-    chb_buf[wr_ptr] = data;
-    wr_ptr = (wr_ptr + 1) % CFG_CHIBI_BUFFERSIZE;
-    len++;
+    ringbufPut(&chb_buf, data);
 }
 
 /**************************************************************************/
@@ -70,20 +67,38 @@ void chb_buf_write(U8 data)
 /**************************************************************************/
 U8 chb_buf_read()
 {
-    U8 data;
+    U8 data = 0;
 
-    data = chb_buf[rd_ptr];
-    rd_ptr = (rd_ptr + 1) % CFG_CHIBI_BUFFERSIZE;
-    len--;
+    ringbufGet(&chb_buf, &data);
     return data;
 }
 
 /**************************************************************************/
 /*!
 
+*/
+/**************************************************************************/
+U32 chb_buf_read_len(U8 *data, U32 len)
+{
+    return ringbufRead(&chb_buf, data, len);
+}
+
+/**************************************************************************/
+/*!
+
 */
 /**************************************************************************/
 U32 chb_buf_get_len()
 {
-    return len;
+    return ringbufCount(&chb_buf);
+}
+
+/**************************************************************************/
+/*!
+
+*/
+/**************************************************************************/
+U32 chb_buf_get_free()
+{
+    return ringbufFree(&chb_buf);
 }
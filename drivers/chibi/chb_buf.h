@@ -39,6 +39,8 @@
 void chb_buf_init();
 void chb_buf_write(U8 data);
 U8 chb_buf_read();
+U32 chb_buf_read_len(U8 *data, U32 len);
 U32 chb_buf_get_len();
+U32 chb_buf_get_free();
 
 #endif
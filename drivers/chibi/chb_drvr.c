@@ -44,6 +44,9 @@
 // store string messages in flash rather than RAM
 const char chb_err_overflow[] = "BUFFER FULL. TOSSING INCOMING DATA\r\n";
 const char chb_err_init[] = "RADIO NOT INITIALIZED PROPERLY\r\n";
+
+// set when the radio interrupt had to wait for the spi bus
+static volatile bool chb_isr_deferred = false;
 /**************************************************************************/
 /*!
 
@@ -247,7 +250,7 @@ void chb_reg_read_mod_write(U8 addr, U8 val, U8 mask)
 /**************************************************************************/
 void chb_frame_write(U8 *hdr, U8 hdr_len, U8 *data, U8 data_len)
 {
-    U8 i, dummy;
+    U8 dummy;
 
     // dont allow transmission longer than max frame size
     if ((hdr_len + data_len) > 127)
@@ -262,17 +265,9 @@ void chb_frame_write(U8 *hdr, U8 hdr_len, U8 *data, U8 data_len)
     // send fifo write command
     dummy = chb_xfer_byte(CHB_SPI_CMD_FW);
 
-    // write hdr contents to fifo
-    for (i=0; i<hdr_len; i++)
-    {
-        dummy = chb_xfer_byte(*hdr++);
-    }
-
-    // write data contents to fifo
-    for (i=0; i<data_len; i++)
-    {
-        dummy = chb_xfer_byte(*data++);
-    }
+    // write hdr and data contents to fifo
+    chb_xfer_block(hdr, NULL, hdr_len);
+    chb_xfer_block(data, NULL, data_len);
 
     // terminate spi transaction
     CHB_SPI_DISABLE(); 
@@ -286,7 +281,8 @@ void chb_frame_write(U8 *hdr, U8 hdr_len, U8 *data, U8 data_len)
 /**************************************************************************/
 static void chb_frame_read()
 {
-    U8 i, len, data;
+    U8 i, len;
+    U8 frame[CHB_MAX_FRAME_LENGTH];
 
     // CHB_ENTER_CRIT();
     CHB_SPI_ENABLE();
@@ -299,14 +295,15 @@ static void chb_frame_read()
     if ((len >= CHB_MIN_FRAME_LENGTH) && (len <= CHB_MAX_FRAME_LENGTH))
     {
         // check to see if there is room to write the frame in the buffer. if not, then drop it
-        if (len < (CFG_CHIBI_BUFFERSIZE - chb_buf_get_len()))
+        if (len < chb_buf_get_free())
         {
             chb_buf_write(len);
-            
+
+            // read the whole frame before copying it to the buffer
+            chb_xfer_block(NULL, frame, len);
             for (i=0; i<len; i++)
             {
-                data = chb_xfer_byte(0);
-                chb_buf_write(data);
+                chb_buf_write(frame[i]);
             }
         }
         else
@@ -315,10 +312,7 @@ static void chb_frame_read()
             chb_pcb_t *pcb = chb_get_pcb();
 
             // read out the data and throw it away
-            for (i=0; i<len; i++)
-            {
-                data = chb_xfer_byte(0);
-            }
+            chb_xfer_block(NULL, NULL, len);
 
             // Increment the overflow stat
             pcb->overflow++;
@@ -341,7 +335,7 @@ static void chb_frame_read()
 #ifdef CHB_DEBUG
 void chb_sram_read(U8 addr, U8 len, U8 *data)
 {
-    U8 i, dummy;
+    U8 dummy;
 
     CHB_ENTER_CRIT();
     CHB_SPI_ENABLE();
@@ -352,10 +346,7 @@ void chb_sram_read(U8 addr, U8 len, U8 *data)
     /*Send address where to start reading.*/
     dummy = chb_xfer_byte(addr);
 
-    for (i=0; i<len; i++)
-    {
-        *data++ = chb_xfer_byte(0);
-    }
+    chb_xfer_block(NULL, data, len);
 
     CHB_SPI_DISABLE();
     CHB_LEAVE_CRIT();
@@ -368,7 +359,7 @@ void chb_sram_read(U8 addr, U8 len, U8 *data)
 /**************************************************************************/
 void chb_sram_write(U8 addr, U8 len, U8 *data)
 {    
-    U8 i, dummy;
+    U8 dummy;
 
     CHB_ENTER_CRIT();
     CHB_SPI_ENABLE();
@@ -379,10 +370,7 @@ void chb_sram_write(U8 addr, U8 len, U8 *data)
     /*Send address where to start writing to.*/
     dummy = chb_xfer_byte(addr);
 
-    for (i=0; i<len; i++)
-    {
-        dummy = chb_xfer_byte(*data++);
-    }
+    chb_xfer_block(data, NULL, len);
 
     CHB_SPI_DISABLE();
     CHB_LEAVE_CRIT();
@@ -835,6 +823,18 @@ void chb_sleep(U8 enb)
     chb_set_state(RX_STATE);
   }
 }
+/**************************************************************************/
+/*!
+    Returns true if the radio interrupt was deferred while the spi bus
+    was busy, in which case the pin interrupt has already been cleared
+    and chb_ISR_Handler still needs to be called
+*/
+/**************************************************************************/
+bool chb_ISR_Deferred (void)
+{
+    return chb_isr_deferred;
+}
+
 /**************************************************************************/
 /*!
 
@@ -845,6 +845,15 @@ void chb_ISR_Handler (void)
     U8 dummy, state, intp_src = 0;
     chb_pcb_t *pcb = chb_get_pcb();
 
+    // if the spi bus is in use (ex. by the sd card), the interrupt will be
+    // set pending again as soon as it is released
+    if (sspDefer(CHB_EINTIRQ))
+    {
+        chb_isr_deferred = true;
+        return;
+    }
+    chb_isr_deferred = false;
+
     CHB_ENTER_CRIT();
 
     /*Read Interrupt source.*/
@@ -64,6 +64,7 @@
 #define CHB_EINTPORT          1
 #define CHB_EINTPIN           8
 #define CHB_EINTPIN_IOCONREG  IOCON_PIO1_8
+#define CHB_EINTIRQ           EINT1_IRQn
 #define CHB_RSTPORT           1
 #define CHB_RSTPIN            9
 #define CHB_RSTPIN_IOCONREG   IOCON_PIO1_9
@@ -368,6 +369,7 @@ void chb_sram_read(U8 addr, U8 len, U8 *data);
 void chb_sram_write(U8 addr, U8 len, U8 *data);
 #endif
 
+bool chb_ISR_Deferred (void);
 void chb_ISR_Handler (void);
 
 #endif
@@ -38,10 +38,18 @@
 
 */
 /**************************************************************************/
+#include <string.h>
+
 #include "chb.h"
 #include "chb_spi.h"
 #include "core/ssp/ssp.h"
 
+// radio on ssp0, 4MHz, high between frames and transition on trailing edge
+const sspDevice_t chb_spi_dev = 
+{
+    CHB_SSPORT, CHB_SSPIN, 8, sspClockPolarity_High, sspClockPhase_FallingEdge
+};
+
 /**************************************************************************/
 /*!
 
@@ -53,7 +61,7 @@ void chb_spi_init()
     sspInit(0, sspClockPolarity_High, sspClockPhase_FallingEdge);
 
     // set the slave select to idle
-    CHB_SPI_DISABLE();
+    sspDeviceInit(&chb_spi_dev);
 }
 
 /**************************************************************************/
@@ -65,13 +73,31 @@ void chb_spi_init()
 /**************************************************************************/
 U8 chb_xfer_byte(U8 data)
 {
-    /* Move on only if NOT busy and TX FIFO not full */
-    while ((SSP_SSP0SR & (SSP_SSP0SR_TNF_MASK | SSP_SSP0SR_BSY_MASK)) != SSP_SSP0SR_TNF_NOTFULL);
-    SSP_SSP0DR = data;
-  
-    /* Wait until the busy bit is cleared and receive buffer is not empty */
-    while ((SSP_SSP0SR & (SSP_SSP0SR_BSY_MASK | SSP_SSP0SR_RNE_MASK)) != SSP_SSP0SR_RNE_NOTEMPTY);
+    sspTransfer(0, &data, &data, 1);
+    return data;
+}
 
-    // Read the queue
-    return SSP_SSP0DR;
+/**************************************************************************/
+/*!
+    Transfers a block of bytes in one go, keeping the SSP FIFO full. If tx
+    is NULL, 0 is sent for each byte.  If rx is NULL, the data read back
+    is discarded.
+*/
+/**************************************************************************/
+void chb_xfer_block(const U8 *tx, U8 *rx, U8 len)
+{
+    if (tx)
+    {
+        sspTransfer(0, tx, rx, len);
+    }
+    else if (rx)
+    {
+        // sspTransfer sends 0xFF when tx is NULL, but the radio expects 0
+        memset(rx, 0, len);
+        sspTransfer(0, rx, rx, len);
+    }
+    else
+    {
+        sspFill(0, 0, len);
+    }
 }
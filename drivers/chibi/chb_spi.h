@@ -44,12 +44,15 @@
 
 #include "projectconfig.h"
 #include "core/gpio/gpio.h"
+#include "core/ssp/ssp.h"
 
-#define CHB_SSPORT          (0) // P0.2 = SSEL
-#define CHB_SSPIN           (2)
+#define CHB_SSPORT          CFG_CHIBI_CSPORT    // See CFG_CHIBI in projectconfig.h
+#define CHB_SSPIN           CFG_CHIBI_CSPIN
 
-#define CHB_SPI_ENABLE()    do {gpioSetValue(CHB_SSPORT, CHB_SSPIN, 0);} while (0)  // Drive SSEL low
-#define CHB_SPI_DISABLE()   do {gpioSetValue(CHB_SSPORT, CHB_SSPIN, 1);} while (0)  // Drive SSEL high
+extern const sspDevice_t chb_spi_dev;
+
+#define CHB_SPI_ENABLE()    do {sspSelect(&chb_spi_dev);} while (0)     // Drive SSEL low
+#define CHB_SPI_DISABLE()   do {sspDeselect(&chb_spi_dev);} while (0)   // Drive SSEL high
 
 #define CHB_SPIPORT     0
 #define CHB_SCK         1                 // PB.1 - Output: SPI Serial Clock (SCLK)
@@ -58,5 +61,6 @@
 
 void chb_spi_init();
 U8 chb_xfer_byte(U8 data);
+void chb_xfer_block(const U8 *tx, U8 *rx, U8 len);
 
 #endif
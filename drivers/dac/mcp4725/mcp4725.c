@@ -56,10 +56,6 @@
 #include "mcp4725.h"
 #include "core/i2c/i2c.h"
 
-extern volatile uint8_t   I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t   I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t  I2CReadLength, I2CWriteLength;
-
 static bool _mcp4725Initialised = false;
 
 /**************************************************************************/
@@ -101,27 +97,14 @@ void mcp4725SetVoltage( uint16_t output, bool writeEEPROM )
 {
   if (!_mcp4725Initialised) mcp4725Init();
 
-  // Clear write buffers
-  uint32_t i;
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
+  uint8_t data[2];
+  data[0] = (output / 16);                              // Upper data bits          (D11.D10.D9.D8.D7.D6.D5.D4)
+  data[1] = (output % 16) << 4;                         // Lower data bits          (D3.D2.D1.D0.x.x.x.x)
 
-  I2CWriteLength = 4;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = MCP4725_ADDRESS;                 // I2C device address
-  if (writeEEPROM)                                      // command and config bits  (C2.C1.C0.x.x.PD1.PD0.x)
-  {
-    I2CMasterBuffer[1] = (MCP4726_CMD_WRITEDACEEPROM);
-  }
-  else
-  {
-    I2CMasterBuffer[1] = (MCP4726_CMD_WRITEDAC);
-  }
-  I2CMasterBuffer[2] = (output / 16);                   // Upper data bits          (D11.D10.D9.D8.D7.D6.D5.D4)
-  I2CMasterBuffer[3] = (output % 16) << 4;              // Lower data bits          (D3.D2.D1.D0.x.x.x.x)
-  i2cEngine();
+  // The command and config bits (C2.C1.C0.x.x.PD1.PD0.x) are sent first
+  i2cWriteReg(MCP4725_ADDRESS, 
+              writeEEPROM ? MCP4726_CMD_WRITEDACEEPROM : MCP4726_CMD_WRITEDAC, 1,
+              data, sizeof(data));
 }
 
 /**************************************************************************/
@@ -139,20 +122,11 @@ void mcp472ReadConfig( uint8_t *status, uint16_t *value )
 {
   if (!_mcp4725Initialised) mcp4725Init();
 
-  // Clear write buffers
-  uint32_t i;
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 1;
-  I2CReadLength = 3;
-  I2CMasterBuffer[0] = MCP4725_ADDRESS | MCP4725_READ;
-  i2cEngine();
+  uint8_t data[3];
+  i2cReadReg(MCP4725_ADDRESS, 0, 0, data, sizeof(data));
 
   // Shift values to create properly formed integers
-  *status = I2CSlaveBuffer[0];
-  *value = ((I2CSlaveBuffer[1] << 4) | (I2CSlaveBuffer[2] >> 4));
+  *status = data[0];
+  *value = ((data[1] << 4) | (data[2] >> 4));
 }
 
@@ -9,12 +9,12 @@
 
     Driver for Atmel's AT25010a/AT25020a/AT25040a 1K/2K/4K serial EEPROM.
     
-    @note     The AT25xxx has an 8-byte buffer, including 1 command byte
-              and one address offset byte, meaning that a maximum of 6
-              bytes can be read or written in one operation.  An error
-              will be returned if a value greater than 6 is passed in
-              for bufferLength with the eepromRead and eepromWrite
-              methods.
+    @note     The AT25xxx writes 8-byte pages.  at25WriteBuffer splits
+              longer writes at page boundaries, and returns as soon as
+              the last page has been sent.  The status register is then
+              polled (see at25WaitReady) before the next access, so the
+              write cycle overlaps with whatever the application does
+              next.  Reads can be any length.
 
     @section Example
 
@@ -36,7 +36,7 @@
     
       // Write 0xAA to EEPROM at address 0x0000
       wBuffer[0] = 0xAA;
-      error = at25Write(0x0000, wBuffer, 1);
+      error = at25WriteBuffer(0x0000, wBuffer, 1);
       if (error)
       {
         // Log the error message or take appropriate actions
@@ -55,7 +55,7 @@
       }
 
       // Read the EEPROM at address 0x0000
-      at25Read(0x0000, rBuffer, 1);
+      at25ReadBuffer(0x0000, rBuffer, 1);
       ...
     }
     @endcode
@@ -93,29 +93,67 @@
 
 #include "at25040.h"
 #include "core/ssp/ssp.h"
-#include "core/gpio/gpio.h"
+#include "core/systick/systick.h"
 
-#define AT25_SELECT()       gpioSetValue(0, 2, 0)
-#define AT25_DESELECT()     gpioSetValue(0, 2, 1)
+/* AT25040 on SSP0, CLK low when inactive, trigger on leading edge */
+static const sspDevice_t at25Device = 
+{
+  AT25_CSPORT, AT25_CSPIN, 8, sspClockPolarity_Low, sspClockPhase_RisingEdge
+};
+
+#define AT25_SELECT()       sspSelect(&at25Device)
+#define AT25_DESELECT()     sspDeselect(&at25Device)
 
-uint32_t i, timeout;
-uint8_t src_addr[SSP_FIFOSIZE]; 
-uint8_t dest_addr[SSP_FIFOSIZE];
+static bool _at25Initialised = false;
+static bool _at25WriteBusy = false;
 
 /**************************************************************************/
 /*! 
-    @brief Sends the write enable command (WREN/0x06)
+    @brief  Initialises the SPI block (CLK set low when inactive, trigger
+            on leading edge).
 */
 /**************************************************************************/
-void at25WriteEnable()
+void at25Init (void)
 {
-  AT25_SELECT();
-  src_addr[0] = AT25_WREN;
-  sspSend(0, (uint8_t *)src_addr, 1);
-  AT25_DESELECT();
+  sspInit(0, sspClockPolarity_Low, sspClockPhase_RisingEdge);
+  sspDeviceInit(&at25Device);
+
+  _at25Initialised = true;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Checks that a block of bytes lies within the EEPROM
+*/
+/**************************************************************************/
+static at25Error_e at25CheckRange (uint16_t address, uint32_t length)
+{
+  if (address >= AT25_MAXADDRESS)
+  {
+    return AT25_ERROR_ADDRERR;
+  }
+
+  if (length > AT25_MAXADDRESS - address)
+  {
+    return AT25_ERROR_BUFFEROVERFLOW;
+  }
 
-  // Delay for at least 250nS (1nS @ 72MHz = ~0.0072 ticks)
-  for (i = 0; i < 100; i++);
+  return AT25_ERROR_OK;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sends a command and its address offset (appending A8 to the
+           command for addresses above 0xFF)
+*/
+/**************************************************************************/
+static void at25SendCommand (uint8_t command, uint16_t address)
+{
+  uint8_t request[2];
+
+  request[0] = address > 0xFF ? command | AT25_A8 : command;
+  request[1] = address & 0xFF;
+  sspSend(0, request, 2);
 }
 
 /**************************************************************************/
@@ -125,25 +163,48 @@ void at25WriteEnable()
     @return     The 8-bit value returned by the Read Status Register
 */
 /**************************************************************************/
-uint8_t at25GetRSR()
+static uint8_t at25GetRSR (void)
 {
+  uint8_t buffer[2] = { AT25_RDSR, 0xFF };
+
   AT25_SELECT();
-  src_addr[0] = AT25_RDSR;
-  sspSend(0, (uint8_t *)src_addr, 1);
-  sspReceive(0, (uint8_t *)dest_addr, 1);
+  sspTransfer(0, buffer, buffer, 2);
   AT25_DESELECT();
-  return dest_addr[0] & (AT25_RDSR_WEN | AT25_RDSR_RDY);
+
+  return buffer[1] & (AT25_RDSR_WEN | AT25_RDSR_RDY);
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Initialises the SPI block (CLK set low when inactive, trigger
-            on leading edge).
+    @brief Waits for any write cycle in progress to finish.
+
+    The status register is polled until the RDY (write in progress)
+    bit clears.  Writes return as soon as the data has been sent, and
+    this is called automatically before the next read or write.  Call
+    it directly before powering down the EEPROM.
 */
 /**************************************************************************/
-void at25Init (void)
+at25Error_e at25WaitReady (void)
 {
-  sspInit(0, sspClockPolarity_Low, sspClockPhase_RisingEdge);
+  uint32_t start;
+
+  if (!_at25WriteBusy)
+  {
+    return AT25_ERROR_OK;
+  }
+
+  // Allow one extra tick since the first one may be partial
+  start = systickGetTicks();
+  while (at25GetRSR() & AT25_RDSR_RDY)
+  {
+    if ((systickGetTicks() - start) * CFG_SYSTICK_DELAY_IN_MS > AT25_WRITETIME_MS + CFG_SYSTICK_DELAY_IN_MS)
+    {
+      return AT25_ERROR_TIMEOUT_WFINISH;
+    }
+  }
+
+  _at25WriteBusy = false;
+  return AT25_ERROR_OK;
 }
 
 /**************************************************************************/
@@ -151,7 +212,8 @@ void at25Init (void)
     @brief Reads the specified number of bytes from the supplied address.
 
     This function will read one or more bytes starting at the supplied
-    address.
+    address.  Any number of bytes can be read in a single sequential
+    read (up to the end of the EEPROM).
 
     @param[in]  address
                 The 16-bit address where the read will start.  The maximum
@@ -162,48 +224,24 @@ void at25Init (void)
                 Length of the buffer
 */
 /**************************************************************************/
-at25Error_e at25Read (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
+at25Error_e at25ReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
 {
-  if (address >= AT25_MAXADDRESS)
-  {
-    return AT25_ERROR_ADDRERR;
-  }
+  at25Error_e error;
 
-  if (bufferLength > 6)
-  {
-    return AT25_ERROR_BUFFEROVERFLOW;
-  }
+  if (!_at25Initialised) at25Init();
 
-  timeout = 0;
-  while ( timeout < SSP_MAX_TIMEOUT )
-  {
-    // Wait until the device is ready
-    uint8_t status = at25GetRSR() & AT25_RDSR_RDY;
-    if (status == 0)
-    {
-      break;
-    }
-    timeout++;
-  }
-  if ( timeout == SSP_MAX_TIMEOUT )
-  {
-    return AT25_ERROR_TIMEOUT_WE;
-  }
+  error = at25CheckRange(address, bufferLength);
+  if (error) return error;
+
+  error = at25WaitReady();
+  if (error) return error;
 
+  // Read command (0x03) and address, then read straight into the buffer
   AT25_SELECT();
-  // Read command (0x03), append A8 if > addr 256 bytes
-  src_addr[0] = address > 0xFF ? AT25_READ | AT25_A8 : AT25_READ;
-  src_addr[1] = (address);
-  sspSend(0, (uint8_t *)src_addr, 2); 
-  sspReceive(0, (uint8_t *)&dest_addr[2], bufferLength);
+  at25SendCommand(AT25_READ, address);
+  sspReceive(0, buffer, bufferLength);
   AT25_DESELECT();
 
-  // Fill response buffer
-  for (i = 0; i < bufferLength; i++)
-  {
-    buffer[i] = dest_addr[i + 2];
-  }
-
   return AT25_ERROR_OK;
 }
 
@@ -212,7 +250,11 @@ at25Error_e at25Read (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
     @brief Writes the supplied bytes at a specified address.
 
     This function will write one or more bytes starting at the supplied
-    address.
+    address.  The data is split into one write per EEPROM page
+    (AT25_PAGESIZE bytes), since a write that crosses the end of a
+    page would wrap around to its start.  Before each page the status
+    register is polled until the previous write cycle has finished
+    (see at25WaitReady) and the write enable latch is set.
 
     @param[in]  address
                 The 16-bit address where the write will start.  The
@@ -224,74 +266,79 @@ at25Error_e at25Read (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
                 Length of the buffer
 */
 /**************************************************************************/
-at25Error_e at25Write (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
+at25Error_e at25WriteBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
 {
-  if (address >= AT25_MAXADDRESS)
-  {
-    return AT25_ERROR_ADDRERR;
-  }
+  at25Error_e error;
+  uint32_t length;
+  uint8_t command = AT25_WREN;
 
-  if (bufferLength > 6)
-  {
-    return AT25_ERROR_BUFFEROVERFLOW;
-  }
+  if (!_at25Initialised) at25Init();
 
-  // Set write enable latch
-  at25WriteEnable();
+  error = at25CheckRange(address, bufferLength);
+  if (error) return error;
 
-  timeout = 0;
-  while ( timeout < SSP_MAX_TIMEOUT )
+  while (bufferLength)
   {
-    // Wait until the device is write enabled
-    if (at25GetRSR() == AT25_RDSR_WEN)
+    // Write up to the end of the current page
+    length = AT25_PAGESIZE - (address % AT25_PAGESIZE);
+    if (length > bufferLength)
     {
-      break;
+      length = bufferLength;
     }
-    timeout++;
-  }
-  if ( timeout == SSP_MAX_TIMEOUT )
-  {
-    return AT25_ERROR_TIMEOUT_WE;
-  }
-
-  for (i = 0; i < bufferLength; i++)        // Init RD and WR buffer
-  {
-    src_addr[i+2] = buffer[i];              // leave two bytes for cmd and offset(8 bits)
-    dest_addr[i] = 0;
-  }
 
-  AT25_SELECT();
-  // Write command (0x02), append A8 if addr > 256 bytes
-  src_addr[0] = address > 0xFF ? AT25_WRITE | AT25_A8 : AT25_WRITE;
-  src_addr[1] = (address);
-  sspSend(0, (uint8_t *)src_addr, bufferLength + 2);
-  AT25_DESELECT();
+    error = at25WaitReady();
+    if (error) return error;
 
-  // Wait at least 3ms
-  for (i = 0; i < ((CFG_CPU_CCLK / 1000) * 3); i++);
-  
-  timeout = 0;
-  while ( timeout < SSP_MAX_TIMEOUT )
-  {
-    // Check status to see if write cycle is done or not
+    // Set the write enable latch (cleared again after every write)
     AT25_SELECT();
-    src_addr[0] = AT25_RDSR;
-    sspSend(0, (uint8_t *)src_addr, 1);
-    sspReceive(0, (uint8_t *)dest_addr, 1);
+    sspSend(0, &command, 1);
     AT25_DESELECT();
-    // Wait until device is ready
-    if ((dest_addr[0] & AT25_RDSR_RDY) == 0x00)
+    if (!(at25GetRSR() & AT25_RDSR_WEN))
     {
-      break;
+      return AT25_ERROR_TIMEOUT_WE;
     }
-    timeout++;
-  }
-  if ( timeout == SSP_MAX_TIMEOUT )
-  {
-    return AT25_ERROR_TIMEOUT_WFINISH;
-  }
 
-  for (i = 0; i < 300; i++);                // Wait at least 250ns
+    // Write command (0x02) and address followed by the page data
+    AT25_SELECT();
+    at25SendCommand(AT25_WRITE, address);
+    sspSend(0, buffer, length);
+    AT25_DESELECT();
+    _at25WriteBusy = true;
+
+    address += length;
+    buffer += length;
+    bufferLength -= length;
+  }
 
   return AT25_ERROR_OK;
 }
+
+/**************************************************************************/
+/*! 
+    @brief Reads one byte from the supplied address.
+
+    @param[in]  address
+                The 16-bit address to read
+    @param[in]  *buffer
+                Pointer to the buffer that will store the read result
+*/
+/**************************************************************************/
+at25Error_e at25ReadByte (uint16_t address, uint8_t *buffer)
+{
+  return at25ReadBuffer(address, buffer, 1);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Writes one byte to the supplied address.
+
+    @param[in]  address
+                The 16-bit address to write to
+    @param[in]  value
+                The data to be written to the EEPROM
+*/
+/**************************************************************************/
+at25Error_e at25WriteByte (uint16_t address, uint8_t value)
+{
+  return at25WriteBuffer(address, &value, 1);
+}
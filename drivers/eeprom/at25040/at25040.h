@@ -46,6 +46,17 @@
 #define AT25_RDSR_WEN       0x02
 #define AT25_A8             0x08        // For addresses > 0xFF (AT25040 only) A8 must be added to R/W commands
 #define AT25_MAXADDRESS     0x0200      // AT25040 = 0X0200, AT25020 = 0x100, AT25010 = 0x80
+#define AT25_PAGESIZE       8           // Bytes per page write
+#define AT25_WRITETIME_MS   5           // Maximum write cycle time
+
+// Chip select (see CFG_SPIEEPROM in projectconfig.h)
+#ifdef CFG_SPIEEPROM
+  #define AT25_CSPORT       CFG_SPIEEPROM_CSPORT
+  #define AT25_CSPIN        CFG_SPIEEPROM_CSPIN
+#else
+  #define AT25_CSPORT       0
+  #define AT25_CSPIN        2
+#endif
 
 /**************************************************************************/
 /*! 
@@ -73,13 +84,16 @@ typedef enum
   AT25_ERROR_TIMEOUT_WE,        // Timed out waiting for write enable status
   AT25_ERROR_TIMEOUT_WFINISH,   // Timed out waiting for write to finish
   AT25_ERROR_ADDRERR,           // Address out of range
-  AT25_ERROR_BUFFEROVERFLOW,    // Max 6 bytes can be read/written in one operation
+  AT25_ERROR_BUFFEROVERFLOW,    // Read/write would run past the end of the EEPROM
   AT2_ERROR_LAST
 }
 at25Error_e;
 
 void at25Init (void);
-at25Error_e at25Read (uint16_t address, uint8_t *buffer, uint32_t bufferLength);
-at25Error_e at25Write (uint16_t address, uint8_t *buffer, uint32_t bufferLength);
+at25Error_e at25ReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength);
+at25Error_e at25WriteBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength);
+at25Error_e at25ReadByte (uint16_t address, uint8_t *buffer);
+at25Error_e at25WriteByte (uint16_t address, uint8_t value);
+at25Error_e at25WaitReady (void);
 
 #endif
@@ -38,11 +38,260 @@
 #include "projectconfig.h"
 #include "eeprom.h"
 
-// Currently only the MCP24AA I2C EEPROM is used
-#include "drivers/eeprom/mcp24aa/mcp24aa.h"
+// Block access to whichever EEPROM was selected in eeprom.h
+#ifdef CFG_SPIEEPROM
+  #define eepromDevRead(addr, buffer, length)   at25ReadBuffer(addr, buffer, length)
+  #define eepromDevWrite(addr, buffer, length)  at25WriteBuffer(addr, buffer, length)
+  #define EEPROM_PAGESIZE       AT25_PAGESIZE
+#else
+  #define eepromDevRead(addr, buffer, length)   mcp24aaReadBuffer(addr, buffer, length)
+  #define eepromDevWrite(addr, buffer, length)  mcp24aaWriteBuffer(addr, buffer, length)
+  #define EEPROM_PAGESIZE       MCP24AA_PAGESIZE
+#endif
+
+#if CFG_EEPROM_CACHE_SIZE > 0
+  #include "core/systick/systick.h"
+#endif
 
 static uint8_t buf[32];
 
+#if CFG_EEPROM_CACHE_SIZE > 0
+
+// The cache is flushed a page at a time, so pages are numbered from the
+// page containing the first cached address
+#define EEPROM_CACHE_END      (CFG_EEPROM_CACHE_START + CFG_EEPROM_CACHE_SIZE)
+#define EEPROM_CACHE_FIRSTPAGE (CFG_EEPROM_CACHE_START / EEPROM_PAGESIZE)
+#define EEPROM_CACHE_PAGES    ((EEPROM_CACHE_END - 1) / EEPROM_PAGESIZE - EEPROM_CACHE_FIRSTPAGE + 1)
+
+static uint8_t eepromCache[CFG_EEPROM_CACHE_SIZE];
+static bool eepromCacheDirty[EEPROM_CACHE_PAGES];
+static bool eepromCacheLoaded = false;
+static bool eepromCacheHasDirty = false;
+static uint32_t eepromCacheDirtyTick;
+static eepromCacheStats_t eepromCacheStats;
+
+/**************************************************************************/
+/*! 
+    @brief Loads the cached region from EEPROM (with one sequential
+           read) the first time it is needed
+
+    @return     true if the cache can be used
+*/
+/**************************************************************************/
+static bool eepromCacheLoad(void)
+{
+  if (!eepromCacheLoaded)
+  {
+    eepromCacheLoaded = (eepromDevRead(CFG_EEPROM_CACHE_START, eepromCache, CFG_EEPROM_CACHE_SIZE) == EEPROM_ERROR_OK);
+  }
+
+  return eepromCacheLoaded;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Finds the part of a block of EEPROM addresses that is cached
+
+    @param[in]  addr
+                The first address of the block
+    @param[in]  length
+                The length of the block
+    @param[out] start
+                The first cached address
+    @param[out] end
+                One past the last cached address
+
+    @return     true if any of the block is cached
+*/
+/**************************************************************************/
+static bool eepromCacheOverlap(uint16_t addr, uint32_t length, uint32_t *start, uint32_t *end)
+{
+  *start = addr > CFG_EEPROM_CACHE_START ? addr : CFG_EEPROM_CACHE_START;
+  *end = addr + length < EEPROM_CACHE_END ? addr + length : EEPROM_CACHE_END;
+
+  return (*start < *end) && eepromCacheLoad();
+}
+
+/**************************************************************************/
+/*! 
+    @brief Reads from the cache where possible, and from the EEPROM
+           for anything outside the cached region
+*/
+/**************************************************************************/
+static eepromError_e eepromRead(uint16_t addr, uint8_t *buffer, uint32_t length)
+{
+  eepromError_e error = EEPROM_ERROR_OK;
+  uint32_t start, end;
+
+  if (!eepromCacheOverlap(addr, length, &start, &end))
+  {
+    eepromCacheStats.readMisses++;
+    return eepromDevRead(addr, buffer, length);
+  }
+
+  if ((start != addr) || (end != addr + length))
+  {
+    // Partly cached, so read it all then use any newer cached data
+    eepromCacheStats.readMisses++;
+    error = eepromDevRead(addr, buffer, length);
+  }
+  else
+  {
+    eepromCacheStats.readHits++;
+  }
+  memcpy(&buffer[start - addr], &eepromCache[start - CFG_EEPROM_CACHE_START], end - start);
+
+  return error;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Writes to the cache where possible, marking the pages that
+           changed as dirty, and to the EEPROM for anything outside the
+           cached region
+*/
+/**************************************************************************/
+static eepromError_e eepromWrite(uint16_t addr, uint8_t *buffer, uint32_t length)
+{
+  eepromError_e error = EEPROM_ERROR_OK;
+  uint32_t start, end, a;
+
+  if (!eepromCacheOverlap(addr, length, &start, &end))
+  {
+    eepromCacheStats.writeMisses++;
+    return eepromDevWrite(addr, buffer, length);
+  }
+
+  // Write any uncached bytes before and after the cached region directly
+  if (start > addr)
+  {
+    error = eepromDevWrite(addr, buffer, start - addr);
+  }
+  if ((error == EEPROM_ERROR_OK) && (end < addr + length))
+  {
+    error = eepromDevWrite(end, &buffer[end - addr], addr + length - end);
+  }
+  if ((start != addr) || (end != addr + length))
+  {
+    eepromCacheStats.writeMisses++;
+  }
+  else
+  {
+    eepromCacheStats.writeHits++;
+  }
+
+  // Only bytes that actually change need to be written back
+  for (a = start; a < end; a++)
+  {
+    if (eepromCache[a - CFG_EEPROM_CACHE_START] != buffer[a - addr])
+    {
+      eepromCache[a - CFG_EEPROM_CACHE_START] = buffer[a - addr];
+      eepromCacheDirty[a / EEPROM_PAGESIZE - EEPROM_CACHE_FIRSTPAGE] = true;
+      if (!eepromCacheHasDirty)
+      {
+        eepromCacheHasDirty = true;
+        eepromCacheDirtyTick = systickGetTicks();
+      }
+    }
+  }
+
+  return error;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Writes any modified data in the RAM cache back to EEPROM,
+           using one page write for each page that was modified
+
+    @return     EEPROM_ERROR_OK if everything was written
+*/
+/**************************************************************************/
+eepromError_e eepromFlush(void)
+{
+  eepromError_e error = EEPROM_ERROR_OK;
+  uint32_t page, start, end;
+
+  if (!eepromCacheHasDirty)
+  {
+    return EEPROM_ERROR_OK;
+  }
+
+  eepromCacheStats.flushes++;
+  for (page = 0; page < EEPROM_CACHE_PAGES; page++)
+  {
+    if (!eepromCacheDirty[page])
+    {
+      continue;
+    }
+
+    // Write the part of the page that lies within the cache
+    start = (page + EEPROM_CACHE_FIRSTPAGE) * EEPROM_PAGESIZE;
+    end = start + EEPROM_PAGESIZE;
+    if (start < CFG_EEPROM_CACHE_START) start = CFG_EEPROM_CACHE_START;
+    if (end > EEPROM_CACHE_END) end = EEPROM_CACHE_END;
+
+    error = eepromDevWrite(start, &eepromCache[start - CFG_EEPROM_CACHE_START], end - start);
+    if (error)
+    {
+      // Leave the page (and any that follow) dirty to try again later
+      return error;
+    }
+    eepromCacheDirty[page] = false;
+    eepromCacheStats.pagesWritten++;
+  }
+
+  eepromCacheHasDirty = false;
+  return EEPROM_ERROR_OK;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Flushes the cache once data has been waiting to be written
+           for CFG_EEPROM_CACHE_FLUSHMS.  This should be called
+           regularly from the main loop.
+*/
+/**************************************************************************/
+void eepromPoll(void)
+{
+  #if CFG_EEPROM_CACHE_FLUSHMS > 0
+  if (eepromCacheHasDirty && 
+      ((systickGetTicks() - eepromCacheDirtyTick) * CFG_SYSTICK_DELAY_IN_MS >= CFG_EEPROM_CACHE_FLUSHMS))
+  {
+    if (eepromFlush() != EEPROM_ERROR_OK)
+    {
+      // Try again after another delay
+      eepromCacheDirtyTick = systickGetTicks();
+    }
+  }
+  #endif
+}
+
+/**************************************************************************/
+/*! 
+    @brief Gets the cache statistics
+
+    @param[out] stats
+                Receives the statistics
+*/
+/**************************************************************************/
+void eepromGetCacheStats(eepromCacheStats_t *stats)
+{
+  *stats = eepromCacheStats;
+}
+
+#else
+
+// Without a cache every access goes straight to the EEPROM
+#define eepromRead(addr, buffer, length)    eepromDevRead(addr, buffer, length)
+#define eepromWrite(addr, buffer, length)   eepromDevWrite(addr, buffer, length)
+
+eepromError_e eepromFlush(void)
+{
+  return EEPROM_ERROR_OK;
+}
+
+#endif
+
 /**************************************************************************/
 /*! 
     @brief Checks whether the supplied address is within the valid range
@@ -56,7 +305,7 @@ static uint8_t buf[32];
 bool eepromCheckAddress(uint16_t addr)
 {
   // Check for invalid values
-  return addr <= MCP24AA_MAXADDR ? FALSE : TRUE;
+  return addr <= EEPROM_MAXADDR ? FALSE : TRUE;
 }
 
 /**************************************************************************/
@@ -71,8 +320,8 @@ bool eepromCheckAddress(uint16_t addr)
 /**************************************************************************/
 uint8_t eepromReadU8(uint16_t addr)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(uint8_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(uint8_t));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -94,8 +343,8 @@ int8_t eepromReadS8(uint16_t addr)
 {
   int8_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(int8_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(int8_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -118,8 +367,8 @@ uint16_t eepromReadU16(uint16_t addr)
 {
   uint16_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(uint16_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(uint16_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -143,8 +392,8 @@ int16_t eepromReadS16(uint16_t addr)
 {
   int16_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(int16_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(int16_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -167,8 +416,8 @@ uint32_t eepromReadU32(uint16_t addr)
 {
   uint32_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(uint32_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(uint32_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -191,8 +440,8 @@ int32_t eepromReadS32(uint16_t addr)
 {
   int32_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(int32_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(int32_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -215,8 +464,8 @@ uint64_t eepromReadU64(uint16_t addr)
 {
   uint64_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(uint64_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(uint64_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -239,8 +488,8 @@ int64_t eepromReadS64(uint16_t addr)
 {
   int64_t results;
 
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaReadBuffer(addr, buf, sizeof(int64_t));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromRead(addr, buf, sizeof(int64_t));
   
   // ToDo: Handle any errors
   if (error) { };
@@ -259,15 +508,32 @@ int64_t eepromReadS64(uint16_t addr)
                 Pointer to the buffer that will store any retrieved bytes
     @param[in]  bufferLength
                 The number of bytes to read
+
+    @return     EEPROM_ERROR_OK if everything was read
 */
 /**************************************************************************/
-void eepromReadBuffer(uint16_t addr, uint8_t *buffer, uint32_t bufferLength)
+eepromError_e eepromReadBuffer(uint16_t addr, uint8_t *buffer, uint32_t bufferLength)
 {
-  // Instantiate error message placeholder
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  
   // Read the contents of address
-  error = mcp24aaReadBuffer(addr, buffer, bufferLength);
+  return eepromRead(addr, buffer, bufferLength);
+}
+
+/**************************************************************************/
+/*! 
+    @brief Writes a variable length buffer to EEPROM
+
+    @param[in]  addr
+                The 16-bit address to write to in EEPROM
+    @param[in]  buffer
+                Pointer to the bytes to write
+    @param[in]  bufferLength
+                The number of bytes to write
+*/
+/**************************************************************************/
+void eepromWriteBuffer(uint16_t addr, uint8_t *buffer, uint32_t bufferLength)
+{
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, buffer, bufferLength);
 
   // ToDo: Handle any errors
   if (error) { };
@@ -283,8 +549,8 @@ void eepromReadBuffer(uint16_t addr, uint8_t *buffer, uint32_t bufferLength)
 /**************************************************************************/
 void eepromWriteU8(uint16_t addr, uint8_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -300,8 +566,8 @@ void eepromWriteU8(uint16_t addr, uint8_t value)
 /**************************************************************************/
 void eepromWriteS8(uint16_t addr, int8_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -317,8 +583,8 @@ void eepromWriteS8(uint16_t addr, int8_t value)
 /**************************************************************************/
 void eepromWriteU16(uint16_t addr, uint16_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -334,8 +600,8 @@ void eepromWriteU16(uint16_t addr, uint16_t value)
 /**************************************************************************/
 void eepromWriteS16(uint16_t addr, int16_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -351,8 +617,8 @@ void eepromWriteS16(uint16_t addr, int16_t value)
 /**************************************************************************/
 void eepromWriteU32(uint16_t addr, uint32_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -368,8 +634,8 @@ void eepromWriteU32(uint16_t addr, uint32_t value)
 /**************************************************************************/
 void eepromWriteS32(uint16_t addr, int32_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -385,8 +651,8 @@ void eepromWriteS32(uint16_t addr, int32_t value)
 /**************************************************************************/
 void eepromWriteU64(uint16_t addr, uint64_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
@@ -402,8 +668,8 @@ void eepromWriteU64(uint16_t addr, uint64_t value)
 /**************************************************************************/
 void eepromWriteS64(uint16_t addr, int64_t value)
 {
-  mcp24aaError_e error = MCP24AA_ERROR_OK;
-  error = mcp24aaWriteBuffer(addr, (uint8_t *)&value, sizeof(value));
+  eepromError_e error = EEPROM_ERROR_OK;
+  error = eepromWrite(addr, (uint8_t *)&value, sizeof(value));
 
   // ToDo: Handle any errors
   if (error) { };
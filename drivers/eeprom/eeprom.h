@@ -38,6 +38,31 @@
 
 #include "projectconfig.h"
 
+// Settings are stored in the SPI EEPROM if CFG_SPIEEPROM is defined,
+// otherwise in the I2C EEPROM
+#ifdef CFG_SPIEEPROM
+  #include "drivers/eeprom/at25040/at25040.h"
+  typedef at25Error_e eepromError_e;
+  #define EEPROM_ERROR_OK       AT25_ERROR_OK
+  #define EEPROM_MAXADDR        (AT25_MAXADDRESS - 1)
+#else
+  #include "drivers/eeprom/mcp24aa/mcp24aa.h"
+  typedef mcp24aaError_e eepromError_e;
+  #define EEPROM_ERROR_OK       MCP24AA_ERROR_OK
+  #define EEPROM_MAXADDR        MCP24AA_MAXADDR
+#endif
+
+// RAM cache statistics (see CFG_EEPROM_CACHE_SIZE)
+typedef struct
+{
+  uint32_t readHits;          // Reads served entirely from the cache
+  uint32_t readMisses;        // Reads that needed the EEPROM
+  uint32_t writeHits;         // Writes absorbed entirely by the cache
+  uint32_t writeMisses;       // Writes that went (partly) to the EEPROM
+  uint32_t flushes;           // Flushes with dirty data
+  uint32_t pagesWritten;      // EEPROM page writes made by flushes
+} eepromCacheStats_t;
+
 // Method Prototypes
 bool      eepromCheckAddress ( uint16_t addr );
 uint8_t   eepromReadU8 ( uint16_t addr );
@@ -48,7 +73,7 @@ uint32_t  eepromReadU32 ( uint16_t addr );
 int32_t   eepromReadS32 ( uint16_t addr );
 uint64_t  eepromReadU64 ( uint16_t addr );
 int64_t   eepromReadS64 ( uint16_t addr );
-void      eepromReadBuffer ( uint16_t addr, uint8_t *buffer, uint32_t bufferLength);
+eepromError_e eepromReadBuffer ( uint16_t addr, uint8_t *buffer, uint32_t bufferLength);
 void      eepromWriteU8 ( uint16_t addr, uint8_t value );
 void      eepromWriteS8 ( uint16_t addr, int8_t value );
 void      eepromWriteU16 ( uint16_t addr, uint16_t value );
@@ -57,5 +82,11 @@ void      eepromWriteU32 ( uint16_t addr, uint32_t value );
 void      eepromWriteS32 ( uint16_t addr, int32_t value );
 void      eepromWriteU64 ( uint16_t addr, uint64_t value );
 void      eepromWriteS64 ( uint16_t addr, int64_t value );
+void      eepromWriteBuffer ( uint16_t addr, uint8_t *buffer, uint32_t bufferLength);
+eepromError_e  eepromFlush ( void );
+#if CFG_EEPROM_CACHE_SIZE > 0
+void      eepromPoll ( void );
+void      eepromGetCacheStats ( eepromCacheStats_t *stats );
+#endif
 
 #endif
@@ -104,13 +104,8 @@
 #include "core/systick/systick.h"
 #include "core/i2c/i2c.h"
 
-extern volatile uint8_t   I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t   I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t  I2CReadLength, I2CWriteLength;
-
-uint32_t i, timeout;
-
 static bool _mcp24aaInitialised = false;
+static bool _mcp24aaWriteBusy = false;
 
 /**************************************************************************/
 /*! 
@@ -131,12 +126,67 @@ mcp24aaError_e mcp24aaInit()
   return MCP24AA_ERROR_OK;
 }
 
+/**************************************************************************/
+/*! 
+    @brief  Checks that a block of bytes lies within the EEPROM
+*/
+/**************************************************************************/
+static mcp24aaError_e mcp24aaCheckRange (uint16_t address, uint32_t length)
+{
+  if (address > MCP24AA_MAXADDR)
+  {
+    return MCP24AA_ERROR_ADDRERR;
+  }
+
+  if (length > MCP24AA_MAXADDR + 1 - address)
+  {
+    return MCP24AA_ERROR_BUFFEROVERFLOW;
+  }
+
+  return MCP24AA_ERROR_OK;
+}
+
+/**************************************************************************/
+/*! 
+    @brief Waits for any write cycle in progress to finish.
+
+    The EEPROM doesn't acknowledge its address while it is writing a
+    page, so it is polled with an empty write until it does (ACK
+    polling).  Writes return as soon as the data has been sent, and
+    this is called automatically before the next read or write, so the
+    write cycle overlaps with whatever the application does next.  Call
+    it directly before powering down the EEPROM.
+*/
+/**************************************************************************/
+mcp24aaError_e mcp24aaWaitReady (void)
+{
+  uint32_t start;
+
+  if (!_mcp24aaWriteBusy)
+  {
+    return MCP24AA_ERROR_OK;
+  }
+
+  start = systickGetTicks();
+  while (i2cWriteReg(MCP24AA_ADDR, 0, 0, NULL, 0) != I2CSTATE_ACK)
+  {
+    if ((systickGetTicks() - start) * CFG_SYSTICK_DELAY_IN_MS > MCP24AA_WRITETIME_MS)
+    {
+      return MCP24AA_ERROR_TIMEOUT;
+    }
+  }
+
+  _mcp24aaWriteBusy = false;
+  return MCP24AA_ERROR_OK;
+}
+
 /**************************************************************************/
 /*! 
     @brief Reads the specified number of bytes from the supplied address.
 
     This function will read one or more bytes starting at the supplied
-    address.  A maximum of 8 bytes can be read in one operation.
+    address.  Any number of bytes can be read in a single sequential
+    read (up to the end of the EEPROM).
 
     @param[in]  address
                 The 16-bit address where the read will start.  The maximum
@@ -149,45 +199,21 @@ mcp24aaError_e mcp24aaInit()
 /**************************************************************************/
 mcp24aaError_e mcp24aaReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
 {
-  if (!_mcp24aaInitialised) mcp24aaInit();
+  mcp24aaError_e error;
 
-  if (address >= MCP24AA_MAXADDR)
-  {
-    return MCP24AA_ERROR_ADDRERR;
-  }
-
-  if (bufferLength > 8)
-  {
-    return MCP24AA_ERROR_BUFFEROVERFLOW;
-  }
+  if (!_mcp24aaInitialised) mcp24aaInit();
 
-  // ToDo: Check if I2C is ready
+  error = mcp24aaCheckRange(address, bufferLength);
+  if (error) return error;
 
-  // Clear buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-    I2CSlaveBuffer[i] = 0x00;
-  }
+  error = mcp24aaWaitReady();
+  if (error) return error;
 
-  // Write address bits to enable random read
-  I2CWriteLength = 3;
-  I2CReadLength = bufferLength;
-  I2CMasterBuffer[0] = MCP24AA_ADDR;                    // I2C device address
-  I2CMasterBuffer[1] = (address >> 8);                  // Address (high byte)
-  I2CMasterBuffer[2] = (address & 0xFF);                // Address (low byte)
-  // If you wish to read, you need to append the address w/read bit, though this
-  // needs to be placed one bit higher than the size of I2CWriteLength which 
-  // may be unexpected
-  I2CMasterBuffer[3] = MCP24AA_ADDR | MCP24AA_READBIT;  
-
-  // Transmit command
-  i2cEngine();
-
-  // Fill response buffer
-  for (i = 0; i < bufferLength; i++)
+  // Write the 16-bit address to enable random read, then read the
+  // results directly into the caller's buffer
+  if (i2cReadReg(MCP24AA_ADDR, address, 2, buffer, bufferLength) != I2CSTATE_ACK)
   {
-    buffer[i] = I2CSlaveBuffer[i];
+    return MCP24AA_ERROR_I2CBUSY;
   }
 
   return MCP24AA_ERROR_OK;
@@ -198,7 +224,11 @@ mcp24aaError_e mcp24aaReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bu
     @brief Writes the supplied bytes at a specified address.
 
     This function will write one or more bytes starting at the supplied
-    address.  A maximum of 8 bytes can be written in one operation.
+    address.  The data is split into one write per EEPROM page
+    (MCP24AA_PAGESIZE bytes), since a write that crosses the end of a
+    page would wrap around to its start.  Before each page the EEPROM
+    is ACK polled until the previous write cycle has finished (see
+    mcp24aaWaitReady).
 
     @param[in]  address
                 The 16-bit address where the write will start.  The
@@ -212,42 +242,37 @@ mcp24aaError_e mcp24aaReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bu
 /**************************************************************************/
 mcp24aaError_e mcp24aaWriteBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength)
 {
+  mcp24aaError_e error;
+  uint32_t length;
+
   if (!_mcp24aaInitialised) mcp24aaInit();
 
-  if (address >= MCP24AA_MAXADDR)
-  {
-    return MCP24AA_ERROR_ADDRERR;
-  }
+  error = mcp24aaCheckRange(address, bufferLength);
+  if (error) return error;
 
-  if (bufferLength > 8)
+  while (bufferLength)
   {
-    return MCP24AA_ERROR_BUFFEROVERFLOW;
-  }
+    // Write up to the end of the current page
+    length = MCP24AA_PAGESIZE - (address % MCP24AA_PAGESIZE);
+    if (length > bufferLength)
+    {
+      length = bufferLength;
+    }
 
-  // ToDo: Check if I2C is ready
+    error = mcp24aaWaitReady();
+    if (error) return error;
 
-  // Clear write buffer
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
+    // Write the 16-bit address followed by the data from the caller's buffer
+    if (i2cWriteReg(MCP24AA_ADDR, address, 2, buffer, length) != I2CSTATE_ACK)
+    {
+      return MCP24AA_ERROR_I2CBUSY;
+    }
+    _mcp24aaWriteBusy = true;
 
-  // Write address bits and data to the master buffer
-  I2CWriteLength = 3 + bufferLength;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = MCP24AA_ADDR;                // I2C device address
-  I2CMasterBuffer[1] = (address >> 8);              // Address (high byte)
-  I2CMasterBuffer[2] = (address & 0xFF);            // Address (low byte)
-  for (i = 0; i < bufferLength; i++)
-  {
-    I2CMasterBuffer[i+3] = buffer[i];
+    address += length;
+    buffer += length;
+    bufferLength -= length;
   }
-
-  // Transmit command
-  i2cEngine();
-
-  // Wait at least 10ms
-  systickDelay(10);
   
   return MCP24AA_ERROR_OK;
 }
@@ -41,10 +41,12 @@
 
 #include "projectconfig.h"
 
-#define MCP24AA_ADDR    0xA0          // 10100000
-#define MCP24AA_RW      0x01
-#define MCP24AA_READBIT 0x01
-#define MCP24AA_MAXADDR 0xFFF         // 4K = 4096
+#define MCP24AA_ADDR          0xA0    // 10100000
+#define MCP24AA_RW            0x01
+#define MCP24AA_READBIT       0x01
+#define MCP24AA_MAXADDR       0xFFF   // 4K = 4096
+#define MCP24AA_PAGESIZE      32      // Bytes per page write
+#define MCP24AA_WRITETIME_MS  10      // Maximum write cycle time (5ms typical)
 
 typedef enum
 {
@@ -52,7 +54,8 @@ typedef enum
   MCP24AA_ERROR_I2CINIT,              // Unable to initialise I2C
   MCP24AA_ERROR_I2CBUSY,              // I2C already in use
   MCP24AA_ERROR_ADDRERR,              // Address out of range
-  MCP24AA_ERROR_BUFFEROVERFLOW,       // Max 8 bytes can be read/written in one operation
+  MCP24AA_ERROR_BUFFEROVERFLOW,       // Read/write would run past the end of the EEPROM
+  MCP24AA_ERROR_TIMEOUT,              // Write cycle didn't finish in MCP24AA_WRITETIME_MS
   MCP24AA_ERROR_LAST
 }
 mcp24aaError_e;
@@ -62,6 +65,7 @@ mcp24aaError_e mcp24aaReadBuffer (uint16_t address, uint8_t *buffer, uint32_t bu
 mcp24aaError_e mcp24aaWriteBuffer (uint16_t address, uint8_t *buffer, uint32_t bufferLength);
 mcp24aaError_e mcp24aaReadByte (uint16_t address, uint8_t *buffer);
 mcp24aaError_e mcp24aaWriteByte (uint16_t address, uint8_t value);
+mcp24aaError_e mcp24aaWaitReady (void);
 
 
 #endif
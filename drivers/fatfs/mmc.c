@@ -34,8 +34,13 @@
 
 
 /* Port Controls  (Platform dependent) */
-#define CS_LOW()    gpioSetValue(SSP0_CSPORT, SSP0_CSPIN, 0)
-#define CS_HIGH()   gpioSetValue(SSP0_CSPORT, SSP0_CSPIN, 1)
+#define CS_LOW()    sspSelect(&mmcDevice)
+#define CS_HIGH()   sspDeselect(&mmcDevice)
+
+/* (PCLK / (CPSDVSR * [SCR+1])) = (72,000,000 / (2 * [89 + 1])) = 400 KHz */
+#define MMC_SCR_SLOW    (89)
+/* (PCLK / (CPSDVSR * [SCR+1])) = (72,000,000 / (2 * [5 + 1])) = 6.0 MHz */
+#define MMC_SCR_FAST    (5)
 
 // #define	FCLK_SLOW()					/* Set slow clock (100k-400k) */
 // #define	FCLK_FAST()					/* Set fast clock (depends on the CSD) */
@@ -57,6 +62,14 @@ BYTE Timer1, Timer2;	/* 100Hz decrement timer */
 static
 BYTE CardType;			/* Card type flags */
 
+/* SD card on SSP0 (clock low between frames, transition on leading edge) */
+static sspDevice_t mmcDevice = 
+{
+  CFG_SDCARD_CSPORT, CFG_SDCARD_CSPIN, 
+  MMC_SCR_SLOW, 
+  sspClockPolarity_Low, sspClockPhase_RisingEdge
+};
+
 /**************************************************************************/
 /*! 
     Set SSP clock to slow (400 KHz)
@@ -64,27 +77,8 @@ BYTE CardType;			/* Card type flags */
 /**************************************************************************/
 static void FCLK_SLOW()
 {
-    /* Divide by 10 (SSPCLKDIV also enables to SSP CLK) */
-    SCB_SSP0CLKDIV = SCB_SSP0CLKDIV_DIV10;
-  
-    /* (PCLK / (CPSDVSR * [SCR+1])) = (7,200,000 / (2 x [8 + 1])) = 400 KHz */
-    uint32_t configReg = ( SSP_SSP0CR0_DSS_8BIT     // Data size = 8-bit
-                  | SSP_SSP0CR0_FRF_SPI             // Frame format = SPI
-                  | SSP_SSP0CR0_SCR_8);             // Serial clock rate = 8
-  
-    // Set clock polarity (low between frames)
-    // configReg &= ~SSP_SSP0CR0_CPOL_MASK;    
-    // configReg |= SSP_SSP0CR0_CPOL_LOW;
-
-    // Set edge transition (leading edge)
-    // configReg &= ~SSP_SSP0CR0_CPHA_MASK;
-    // configReg |= SSP_SSP0CR0_CPHA_FIRST;
-  
-    // Assign config values to SSP0CR0
-    SSP_SSP0CR0 = configReg;
-  
-    /* Clock prescale register must be even and at least 2 in master mode */
-    SSP_SSP0CPSR = SSP_SSP0CPSR_CPSDVSR_DIV2;  
+    /* Loaded by the SSP driver the next time the card uses the bus */
+    mmcDevice.clockDivider = MMC_SCR_SLOW;
 }
 
 /**************************************************************************/
@@ -94,27 +88,7 @@ static void FCLK_SLOW()
 /**************************************************************************/
 static void FCLK_FAST()
 {
-    /* Divide by 1 (SSPCLKDIV also enables to SSP CLK) */
-    SCB_SSP0CLKDIV = SCB_SSP0CLKDIV_DIV1;
-  
-    /* (PCLK / (CPSDVSR * [SCR+1])) = (72,000,000 / (2 * [5 + 1])) = 6.0 MHz */
-    uint32_t configReg = ( SSP_SSP0CR0_DSS_8BIT   // Data size = 8-bit
-                  | SSP_SSP0CR0_FRF_SPI           // Frame format = SPI
-                  | SSP_SSP0CR0_SCR_5);           // Serial clock rate = 5
-  
-    // Set clock polarity (low between frames)
-    // configReg &= ~SSP_SSP0CR0_CPOL_MASK;    
-    // configReg |= SSP_SSP0CR0_CPOL_LOW;
-
-    // Set edge transition (leading edge)
-    // configReg &= ~SSP_SSP0CR0_CPHA_MASK;
-    // configReg |= SSP_SSP0CR0_CPHA_FIRST;
-  
-    // Assign config values to SSP0CR0
-    SSP_SSP0CR0 = configReg;
-  
-    /* Clock prescale register must be even and at least 2 in master mode */
-    SSP_SSP0CPSR = SSP_SSP0CPSR_CPSDVSR_DIV2;  
+    mmcDevice.clockDivider = MMC_SCR_FAST;
 }
 
 /*-----------------------------------------------------------------------*/
@@ -142,12 +116,30 @@ BYTE rcvr_spi (void)
     return data;
 }
 
-/* Alternative macro to receive data fast */
+/*-----------------------------------------------------------------------*/
+/* Receive a block of bytes from MMC with a queued SSP job (the card is  */
+/* already selected and stays selected)                                  */
+/*-----------------------------------------------------------------------*/
+
+static
+void rcvr_spi_multi (BYTE *dst, UINT cnt)
+{
+    sspJob_t job = { &mmcDevice, NULL, dst, cnt, SSPJOB_HOLDCS };
+
+    sspRun(&job);
+}
+
+/*-----------------------------------------------------------------------*/
+/* Transmit a block of bytes to MMC with a queued SSP job                */
+/*-----------------------------------------------------------------------*/
 
-#define rcvr_spi_m(dst) \
-    do { \
-        sspReceive(0, (uint8_t*)(dst), 1); \
-    } while(0)
+static
+void xmit_spi_multi (const BYTE *src, UINT cnt)
+{
+    sspJob_t job = { &mmcDevice, src, NULL, cnt, SSPJOB_HOLDCS };
+
+    sspRun(&job);
+}
 
 
 
@@ -180,8 +172,10 @@ BYTE wait_ready (void)
 static
 void deselect (void)
 {
+	sspLock(&mmcDevice);	/* Keep the bus for the trailing clocks */
 	CS_HIGH();
 	rcvr_spi();
+	sspUnlock(&mmcDevice);
 }
 
 
@@ -246,14 +240,8 @@ BOOL rcvr_datablock (
 	} while ((token == 0xFF) && Timer1);
 	if(token != 0xFE) return FALSE;	/* If not valid data token, retutn with error */
 
-	do {							/* Receive the data block into buffer */
-		rcvr_spi_m(buff++);
-		rcvr_spi_m(buff++);
-		rcvr_spi_m(buff++);
-		rcvr_spi_m(buff++);
-	} while (btr -= 4);
-	rcvr_spi();						/* Discard CRC */
-	rcvr_spi();
+	rcvr_spi_multi(buff, btr);		/* Receive the data block into buffer */
+	sspFill(0, 0xFF, 2);			/* Discard CRC */
 
 	return TRUE;					/* Return with success */
 }
@@ -271,20 +259,15 @@ BOOL xmit_datablock (
 	BYTE token			/* Data/Stop token */
 )
 {
-	BYTE resp, wc;
+	BYTE resp;
 
 
 	if (wait_ready() != 0xFF) return FALSE;
 
 	xmit_spi(token);					/* Xmit data token */
 	if (token != 0xFD) {	/* Is data token */
-		wc = 0;
-		do {							/* Xmit the 512 byte data block to MMC */
-			xmit_spi(*buff++);
-			xmit_spi(*buff++);
-		} while (--wc);
-		xmit_spi(0xFF);					/* CRC (Dummy) */
-		xmit_spi(0xFF);
+		xmit_spi_multi(buff, 512);		/* Xmit the 512 byte data block to MMC */
+		sspFill(0, 0xFF, 2);			/* CRC (Dummy) */
 		resp = rcvr_spi();				/* Reveive data response */
 		if ((resp & 0x1F) != 0x05)		/* If not accepted, return with error */
 			return FALSE;
@@ -306,7 +289,7 @@ BYTE send_cmd (
 	DWORD arg		/* Argument */
 )
 {
-	BYTE n, res;
+	BYTE n, res, buf[6];
 
 
 	if (cmd & 0x80) {	/* ACMD<n> is the command sequense of CMD55-CMD<n> */
@@ -320,15 +303,16 @@ BYTE send_cmd (
 	if (!select()) return 0xFF;
 
 	/* Send command packet */
-	xmit_spi(cmd);						/* Start + Command index */
-	xmit_spi((BYTE)(arg >> 24));		/* Argument[31..24] */
-	xmit_spi((BYTE)(arg >> 16));		/* Argument[23..16] */
-	xmit_spi((BYTE)(arg >> 8));			/* Argument[15..8] */
-	xmit_spi((BYTE)arg);				/* Argument[7..0] */
+	buf[0] = cmd;						/* Start + Command index */
+	buf[1] = (BYTE)(arg >> 24);			/* Argument[31..24] */
+	buf[2] = (BYTE)(arg >> 16);			/* Argument[23..16] */
+	buf[3] = (BYTE)(arg >> 8);			/* Argument[15..8] */
+	buf[4] = (BYTE)arg;					/* Argument[7..0] */
 	n = 0x01;							/* Dummy CRC + Stop */
 	if (cmd == CMD0) n = 0x95;			/* Valid CRC for CMD0(0) */
 	if (cmd == CMD8) n = 0x87;			/* Valid CRC for CMD8(0x1AA) */
-	xmit_spi(n);
+	buf[5] = n;
+	xmit_spi_multi(buf, 6);
 
 	/* Receive command response */
 	if (cmd == CMD12) rcvr_spi();		/* Skip a stuff byte when stop reading */
@@ -359,10 +343,11 @@ DSTATUS disk_initialize (
 {
 	BYTE n, cmd, ty, ocr[4];
 
-        // Init SSP (clock low between frames, transition on leading edge)      
+        // Init SSP (only the first call sets up SSP0, later calls leave
+        // the bus to whichever device is using it)
         sspInit(0, sspClockPolarity_Low, sspClockPhase_RisingEdge); 
     
-        gpioSetDir( SSP0_CSPORT, SSP0_CSPIN, gpioDirection_Output ); /* CS */
+        sspDeviceInit(&mmcDevice); /* CS */
         gpioSetDir( CFG_SDCARD_CDPORT, CFG_SDCARD_CDPIN, gpioDirection_Input ); /* Card Detect */
         gpioSetPullup (&IOCON_PIO3_0, gpioPullupMode_Inactive);
 
@@ -374,7 +359,9 @@ DSTATUS disk_initialize (
 
 	power_on();							/* Force socket power on */
 	FCLK_SLOW();
-	for (n = 100; n; n--) rcvr_spi();	/* 80 dummy clocks */
+	sspLock(&mmcDevice);
+	sspFill(0, 0xFF, 100);				/* 80 dummy clocks */
+	sspUnlock(&mmcDevice);
 
 	ty = 0;
 	if (send_cmd(CMD0, 0) == 1) {			/* Enter Idle state */
@@ -454,6 +441,7 @@ DRESULT disk_read (
 			do {
 				if (!rcvr_datablock(buff, 512)) break;
 				buff += 512;
+				sspYield(&mmcDevice);		/* Let the radio in between blocks */
 			} while (--count);
 			send_cmd(CMD12, 0);				/* STOP_TRANSMISSION */
 		}
@@ -494,6 +482,7 @@ DRESULT disk_write (
 			do {
 				if (!xmit_datablock(buff, 0xFC)) break;
 				buff += 512;
+				sspYield(&mmcDevice);		/* Let the radio in between blocks */
 			} while (--count);
 			if (!xmit_datablock(0, 0xFD))	/* STOP_TRAN token */
 				count = 1;
@@ -581,7 +570,7 @@ DRESULT disk_ioctl (
 				if (send_cmd(ACMD13, 0) == 0) {	/* Read SD status */
 					rcvr_spi();
 					if (rcvr_datablock(csd, 16)) {				/* Read partial block */
-						for (n = 64 - 16; n; n--) rcvr_spi();	/* Purge trailing data */
+						sspFill(0, 0xFF, 64 - 16);				/* Purge trailing data */
 						*(DWORD*)buff = 16UL << (csd[10] >> 4);
 						res = RES_OK;
 					}
@@ -105,6 +105,12 @@ static uint8_t *alphaString_ptr;
 /* For quick retrieval of button X/Y locqtions */
 uint32_t alphaBtnX[5], alphaBtnY[6];
 
+/* Cached button size and text cursor position (calculated once when the
+   dialogue is opened so that touch events don't need to call back into
+   the lcd driver for every hit-test)                                     */
+static uint16_t alphaBtnWidth, alphaBtnHeight;
+static uint16_t alphaCursorX, alphaTextY, alphaTextRight;
+
 /* Array showing which characters should be displayed on each alphaPage */
 /* You can rearrange the keypad by modifying the array contents below   */
 /* --------------------    --------------------   --------------------   --------------------
@@ -145,7 +151,7 @@ char alphaKeys[4][6][5] =  {  {  { 'A', 'B', 'C', 'D', '<' },
 
 /**************************************************************************/
 /*! 
-    @brief  Renders the UI
+    @brief  Renders a single button on the keypad
 */
 /**************************************************************************/
 void alphaRenderButton(uint8_t alphaPage, uint8_t col, uint8_t row, bool selected)
@@ -172,46 +178,140 @@ void alphaRenderButton(uint8_t alphaPage, uint8_t col, uint8_t row, bool selecte
   {
     case '<':
       // Backspace
-      drawButton (alphaBtnX[col], alphaBtnY[row], ALPHA_BTN_WIDTH, ALPHA_BTN_HEIGHT, &dejaVuSans9ptFontInfo, 7, border, fill, font, NULL); 
-      drawArrow (alphaBtnX[col] + ALPHA_BTN_WIDTH / 2 - 3, alphaBtnY[row] + ALPHA_BTN_HEIGHT / 2, 7, DRAW_DIRECTION_LEFT, font);
+      drawButton (alphaBtnX[col], alphaBtnY[row], alphaBtnWidth, alphaBtnHeight, &dejaVuSans9ptFontInfo, 7, border, fill, font, NULL); 
+      drawArrow (alphaBtnX[col] + alphaBtnWidth / 2 - 3, alphaBtnY[row] + alphaBtnHeight / 2, 7, DRAW_DIRECTION_LEFT, font);
       break;
     case '*':
       // Page Shift
-      drawButton (alphaBtnX[col], alphaBtnY[row], ALPHA_BTN_WIDTH, ALPHA_BTN_HEIGHT, &dejaVuSans9ptFontInfo, 7, border, fill, font, NULL); 
-      drawArrow (alphaBtnX[col] + ALPHA_BTN_WIDTH / 2, (alphaBtnY[row] + ALPHA_BTN_HEIGHT / 2) - 3, 7, DRAW_DIRECTION_UP, font);
+      drawButton (alphaBtnX[col], alphaBtnY[row], alphaBtnWidth, alphaBtnHeight, &dejaVuSans9ptFontInfo, 7, border, fill, font, NULL); 
+      drawArrow (alphaBtnX[col] + alphaBtnWidth / 2, (alphaBtnY[row] + alphaBtnHeight / 2) - 3, 7, DRAW_DIRECTION_UP, font);
       break;
     case '>':
       // OK
-      drawButton (alphaBtnX[col], alphaBtnY[row], ALPHA_BTN_WIDTH, ALPHA_BTN_HEIGHT, &dejaVuSans9ptFontInfo, 7, border, fill, font, "OK"); 
+      drawButton (alphaBtnX[col], alphaBtnY[row], alphaBtnWidth, alphaBtnHeight, &dejaVuSans9ptFontInfo, 7, border, fill, font, "OK"); 
       break;
     default:
       // Standard character
-      drawButton (alphaBtnX[col], alphaBtnY[row], ALPHA_BTN_WIDTH, ALPHA_BTN_HEIGHT, &dejaVuSans9ptFontInfo, 7, border, fill, font, key); 
+      drawButton (alphaBtnX[col], alphaBtnY[row], alphaBtnWidth, alphaBtnHeight, &dejaVuSans9ptFontInfo, 7, border, fill, font, key); 
       break;
   }
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Renders the UI
+    @brief  Renders the keypad for the current page
+
+    @param[in]  previousPage
+                The page that is currently visible on the screen.  Only
+                keys whose label differs between previousPage and the
+                current page will be redrawn.  Set this to 0xFF to render
+                every key (for ex. when the dialogue is first displayed).
 */
 /**************************************************************************/
-void alphaRefreshScreen(void)
+void alphaRenderKeypad(uint8_t previousPage)
 {
   uint8_t x, y;
 
-  /* Draw keypad */
   for (y = 0; y < 6; y++)
   {
     for (x = 0; x < 5; x++)
     {
-      alphaRenderButton(alphaPage, x, y, false);
+      if ((previousPage > 3) || (alphaKeys[previousPage][y][x] != alphaKeys[alphaPage][y][x]))
+      {
+        alphaRenderButton(alphaPage, x, y, false);
+      }
     }
   }
+}
 
-  /* Render Text */
+/**************************************************************************/
+/*! 
+    @brief  Renders the text input field and the current string contents
+*/
+/**************************************************************************/
+void alphaRenderInput(void)
+{
   drawRectangleRounded(ALPHA_BTN_SPACING, ALPHA_BTN_SPACING, lcdGetWidth() - 1 - ALPHA_BTN_SPACING, ALPHA_KEYPAD_TOP - ALPHA_BTN_SPACING, ALPHA_COLOR_INPUTFILL, 10, DRAW_ROUNDEDCORNERS_ALL);
-  drawString(ALPHA_BTN_SPACING * 3, ALPHA_BTN_SPACING * 3, ALPHA_COLOR_INPUTTEXT, &dejaVuSans9ptFontInfo, (char *)&alphaString);
+  drawString(ALPHA_BTN_SPACING * 3, alphaTextY, ALPHA_COLOR_INPUTTEXT, &dejaVuSans9ptFontInfo, (char *)&alphaString);
+  alphaCursorX = ALPHA_BTN_SPACING * 3 + drawGetStringWidth(&dejaVuSans9ptFontInfo, (char *)&alphaString);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Appends a single character to the string buffer and renders
+            it at the current cursor position
+*/
+/**************************************************************************/
+void alphaAppendChar(char c)
+{
+  char glyph[2] = { c, '\0' };
+  uint16_t glyphWidth = drawGetStringWidth(&dejaVuSans9ptFontInfo, glyph);
+
+  // Make sure there is room left in the buffer and in the input field
+  if ((alphaString_ptr >= &alphaString[sizeof(alphaString) - 1]) ||
+      (alphaCursorX + glyphWidth > alphaTextRight))
+  {
+    return;
+  }
+
+  *alphaString_ptr++ = c;
+  drawString(alphaCursorX, alphaTextY, ALPHA_COLOR_INPUTTEXT, &dejaVuSans9ptFontInfo, glyph);
+  alphaCursorX += glyphWidth;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Removes the last character from the string buffer and clears
+            it from the input field
+*/
+/**************************************************************************/
+void alphaTrimChar(void)
+{
+  if (alphaString_ptr > alphaString)
+  {
+    alphaString_ptr--;
+    char glyph[2] = { *alphaString_ptr, '\0' };
+    uint16_t glyphWidth = drawGetStringWidth(&dejaVuSans9ptFontInfo, glyph);
+    *alphaString_ptr = '\0';
+    alphaCursorX -= glyphWidth;
+    // Bitmap font glyphs are rendered from 7 pixels above the y position
+    drawRectangleFilled(alphaCursorX, alphaTextY - 7,
+                        alphaCursorX + glyphWidth - 1, alphaTextY + (dejaVuSans9ptFontInfo.heightPages - 1) * 8,
+                        ALPHA_COLOR_INPUTFILL);
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Converts touch data to a column and row on the keypad using
+            the cached button geometry
+
+    @return true if a key was touched, otherwise false
+*/
+/**************************************************************************/
+bool alphaGetKey(tsTouchData_t *data, uint8_t *col, uint8_t *row)
+{
+  uint8_t i;
+
+  // Get column
+  for (i = 0; i < 5; i++)
+  {
+    if ((data->xlcd > alphaBtnX[i]) && (data->xlcd < alphaBtnX[i] + alphaBtnWidth))
+      break;
+  }
+  if (i == 5) return false;
+  *col = i;
+
+  // Get row
+  for (i = 0; i < 6; i++)
+  {
+    if ((data->ylcd > alphaBtnY[i]) && (data->ylcd < alphaBtnY[i] + alphaBtnHeight))
+      break;
+  }
+  if (i == 6) return false;
+  *row = i;
+
+  return true;
 }
 
 /**************************************************************************/
@@ -223,7 +323,7 @@ char alphaHandleTouchEvent(void)
 {
   tsTouchData_t data;
   char result = '\0';
-  uint8_t row, col;
+  uint8_t row, col, previousPage;
   int32_t tsError = -1;
 
   // Blocking delay until a valid touch event occurs
@@ -233,64 +333,19 @@ char alphaHandleTouchEvent(void)
   }
 
   // Attempt to convert touch data to char
-  if ((data.ylcd < ALPHA_ROW1_TOP) || (data.ylcd > ALPHA_ROW6_TOP + ALPHA_BTN_HEIGHT))
+  if (!alphaGetKey(&data, &col, &row))
   {
     return result;
   }
 
-  // Get column
-  if ((data.xlcd > alphaBtnX[0]) && (data.xlcd < alphaBtnX[0] + ALPHA_BTN_WIDTH))
-    col = 0;
-  else if ((data.xlcd > alphaBtnX[1]) && (data.xlcd < alphaBtnX[1] + ALPHA_BTN_WIDTH))
-    col = 1;
-  else if ((data.xlcd > alphaBtnX[2]) && (data.xlcd < alphaBtnX[2] + ALPHA_BTN_WIDTH))
-    col = 2;
-  else if ((data.xlcd > alphaBtnX[3]) && (data.xlcd < alphaBtnX[3] + ALPHA_BTN_WIDTH))
-    col = 3;
-  else if ((data.xlcd > ALPHA_COL5_LEFT) && (data.xlcd < ALPHA_COL5_LEFT + ALPHA_BTN_WIDTH))
-    col = 4;
-  else
-    return result;
-
-  // Get row
-  if ((data.ylcd > ALPHA_ROW1_TOP) && (data.ylcd < ALPHA_ROW1_TOP + ALPHA_BTN_HEIGHT))
-    row = 0;
-  else if ((data.ylcd > ALPHA_ROW2_TOP) && (data.ylcd < ALPHA_ROW2_TOP + ALPHA_BTN_HEIGHT))
-    row = 1;
-  else if ((data.ylcd > ALPHA_ROW3_TOP) && (data.ylcd < ALPHA_ROW3_TOP + ALPHA_BTN_HEIGHT))
-    row = 2;
-  else if ((data.ylcd > ALPHA_ROW4_TOP) && (data.ylcd < ALPHA_ROW4_TOP + ALPHA_BTN_HEIGHT))
-    row = 3;
-  else if ((data.ylcd > ALPHA_ROW5_TOP) && (data.ylcd < ALPHA_ROW5_TOP + ALPHA_BTN_HEIGHT))
-    row = 4;
-  else if ((data.ylcd > ALPHA_ROW6_TOP) && (data.ylcd < ALPHA_ROW6_TOP + ALPHA_BTN_HEIGHT))
-    row = 5;
-  else
-    return result;
-
-  // Match found ... update button and process the results
+  // Match found ... highlight the button and process the results
   alphaRenderButton(alphaPage, col, row, true);
   result = alphaKeys[alphaPage][row][col];
   
   if (result == '<')
   {
     // Trim character if backspace was pressed
-    if (alphaString_ptr > alphaString)
-    {
-      alphaString_ptr--;
-      *alphaString_ptr = '\0';
-    }
-  }
-  else if (result == '*')
-  {
-    // Switch page if the shift button was pressed
-    alphaPage++;
-    if (alphaPage > 3)
-    {
-      alphaPage = 0;
-    }
-    // Update the UI
-    alphaRefreshScreen();
+    alphaTrimChar();
   }
   else if (result == '>')
   {
@@ -298,17 +353,31 @@ char alphaHandleTouchEvent(void)
     systickDelay(CFG_TFTLCD_TS_KEYPADDELAY);
     return '>';
   }
-  else
+  else if (result != '*')
   {
     // Add text to string buffer
-    *alphaString_ptr++ = result;
+    alphaAppendChar(result);
   }
 
   // Brief delay
   systickDelay(CFG_TFTLCD_TS_KEYPADDELAY);
 
   // Return button to deselected state
-  alphaRefreshScreen();
+  alphaRenderButton(alphaPage, col, row, false);
+
+  if (result == '*')
+  {
+    // Switch page if the shift button was pressed
+    previousPage = alphaPage;
+    alphaPage++;
+    if (alphaPage > 3)
+    {
+      alphaPage = 0;
+    }
+    // Only redraw the keys that change between pages
+    alphaRenderKeypad(previousPage);
+  }
+
   return result;
 }
 
@@ -345,6 +414,10 @@ char* alphaShowDialogue(void)
   alphaBtnY[3] = ALPHA_ROW4_TOP;
   alphaBtnY[4] = ALPHA_ROW5_TOP;
   alphaBtnY[5] = ALPHA_ROW6_TOP;
+  alphaBtnWidth = ALPHA_BTN_WIDTH;
+  alphaBtnHeight = ALPHA_BTN_HEIGHT;
+  alphaTextY = ALPHA_BTN_SPACING * 3;
+  alphaTextRight = lcdGetWidth() - (ALPHA_BTN_SPACING * 3);
 
   /* Initialise the string buffer */
   memset(&alphaString[0], 0, sizeof(alphaString));
@@ -353,7 +426,8 @@ char* alphaShowDialogue(void)
 
   /* Draw the background and render the buttons */
   drawFill(ALPHA_COLOR_BACKGROUND);
-  alphaRefreshScreen();
+  alphaRenderKeypad(0xFF);
+  alphaRenderInput();
 
   /* Capture results until the 'OK' button is pressed */
   while(1)
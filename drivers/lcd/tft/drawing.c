@@ -42,17 +42,312 @@
 #include <string.h>
 
 #include "drawing.h"
+#include "trig.h"
 
 #ifdef CFG_SDCARD
   #include "bmp.h"
 #endif
 
+// Clip rectangle (inclusive, in screen co-ordinates) and the viewport
+// origin that is added to every co-ordinate passed into the draw methods
+typedef struct
+{
+  int16_t x0;
+  int16_t y0;
+  int16_t x1;
+  int16_t y1;
+  int16_t originX;
+  int16_t originY;
+} drawClip_t;
+
+static drawClip_t drawClip;
+static drawClip_t drawClipStack[DRAW_CLIPSTACK_DEPTH];
+static uint8_t    drawClipDepth = 0;
+
 /**************************************************************************/
 /*                                                                        */
 /* ----------------------- Private Methods ------------------------------ */
 /*                                                                        */
 /**************************************************************************/
 
+/**************************************************************************/
+/*!
+    @brief  Makes sure the active clip rectangle is valid
+
+    When nothing has been pushed the clip rectangle tracks the panel
+    dimensions, so that changing the orientation is always honoured.
+*/
+/**************************************************************************/
+static inline void drawClipRefresh(void)
+{
+  if (drawClipDepth == 0)
+  {
+    drawClip.x0 = 0;
+    drawClip.y0 = 0;
+    drawClip.x1 = lcdGetWidth() - 1;
+    drawClip.y1 = lcdGetHeight() - 1;
+    drawClip.originX = 0;
+    drawClip.originY = 0;
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Translates a rectangle into screen co-ordinates and clips
+            it against the active clip rectangle
+
+    Co-ordinates are treated as signed, so values that have wrapped
+    below zero (ex. 'x - radius' near the left edge) are clipped
+    instead of being rendered on the far side of the screen.
+
+    @return false if no part of the rectangle is visible
+*/
+/**************************************************************************/
+static bool drawClipRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, drawClip_t *rect)
+{
+  int16_t t;
+  int16_t left = (int16_t)x0;
+  int16_t top = (int16_t)y0;
+  int16_t right = (int16_t)x1;
+  int16_t bottom = (int16_t)y1;
+
+  if (right < left) { t = left; left = right; right = t; }
+  if (bottom < top) { t = top; top = bottom; bottom = t; }
+
+  drawClipRefresh();
+  left += drawClip.originX;
+  right += drawClip.originX;
+  top += drawClip.originY;
+  bottom += drawClip.originY;
+
+  rect->x0 = left < drawClip.x0 ? drawClip.x0 : left;
+  rect->y0 = top < drawClip.y0 ? drawClip.y0 : top;
+  rect->x1 = right > drawClip.x1 ? drawClip.x1 : right;
+  rect->y1 = bottom > drawClip.y1 ? drawClip.y1 : bottom;
+
+  // Nothing left after clipping (this also rejects everything when
+  // the clip rectangle itself is empty)
+  return (rect->x0 <= rect->x1) && (rect->y0 <= rect->y1);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a clipped horizontal span using the LCD's fast
+            horizontal line method
+*/
+/**************************************************************************/
+static void drawSpanH(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
+{
+  drawClip_t span;
+
+  if (drawClipRect(x0, y, x1, y, &span))
+  {
+    lcdDrawHLine(span.x0, span.x1, span.y0, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a clipped vertical span using the LCD's fast
+            vertical line method
+*/
+/**************************************************************************/
+static void drawSpanV(uint16_t x, uint16_t y0, uint16_t y1, uint16_t color)
+{
+  drawClip_t span;
+
+  if (drawClipRect(x, y0, x, y1, &span))
+  {
+    lcdDrawVLine(span.x0, span.y0, span.y1, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Returns the integer square root of n (rounded down)
+*/
+/**************************************************************************/
+static uint32_t drawIsqrt(uint32_t n)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > n)
+  {
+    bit >>= 2;
+  }
+
+  while (bit)
+  {
+    if (n >= root + bit)
+    {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Limits the span lo..hi to the half-plane a*x + b >= 0
+
+    @return false if nothing is left of the span
+*/
+/**************************************************************************/
+static bool drawClipSpanHalfPlane(int32_t a, int32_t b, int32_t *lo, int32_t *hi)
+{
+  int32_t limit;
+
+  if (a > 0)
+  {
+    // x >= ceil(-b / a)
+    limit = b <= 0 ? (-b + a - 1) / a : -(b / a);
+    if (limit > *lo) *lo = limit;
+  }
+  else if (a < 0)
+  {
+    // x <= floor(b / -a)
+    a = -a;
+    limit = b >= 0 ? b / a : -((-b + a - 1) / a);
+    if (limit < *hi) *hi = limit;
+  }
+  else if (b < 0)
+  {
+    return false;
+  }
+
+  return *lo <= *hi;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Renders the part of the span lo..hi on row y (relative to
+            the center) that falls inside the arc's wedges
+
+    Each wedge is at most 180 degrees wide, so it is the intersection
+    of two half-planes and clips a span to a single span.  Wedges are
+    stored as Q15 direction vectors (start x, start y, end x, end y).
+*/
+/**************************************************************************/
+static void drawArcSpan(int16_t xCenter, int16_t yCenter, int32_t y, int32_t lo, int32_t hi, int32_t wedges[2][4], uint8_t wedgeCount, uint16_t color)
+{
+  int32_t spanLo[2], spanHi[2];
+  uint8_t i, spans = 0;
+
+  if (wedgeCount == 0)
+  {
+    // Full circle
+    drawSpanH(xCenter + lo, xCenter + hi, yCenter + y, color);
+    return;
+  }
+
+  for (i = 0; i < wedgeCount; i++)
+  {
+    spanLo[spans] = lo;
+    spanHi[spans] = hi;
+    // Clockwise of the start vector and anti-clockwise of the end vector
+    if (drawClipSpanHalfPlane(-wedges[i][1], wedges[i][0] * y, &spanLo[spans], &spanHi[spans]) &&
+        drawClipSpanHalfPlane(wedges[i][3], -wedges[i][2] * y, &spanLo[spans], &spanHi[spans]))
+    {
+      spans++;
+    }
+  }
+
+  // Merge the two halves of a > 180 degree arc when they touch
+  if ((spans == 2) && (spanLo[1] <= spanHi[0] + 1) && (spanLo[0] <= spanHi[1] + 1))
+  {
+    if (spanLo[1] < spanLo[0]) spanLo[0] = spanLo[1];
+    if (spanHi[1] > spanHi[0]) spanHi[0] = spanHi[1];
+    spans = 1;
+  }
+
+  for (i = 0; i < spans; i++)
+  {
+    drawSpanH(xCenter + spanLo[i], xCenter + spanHi[i], yCenter + y, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Renders the part of a ring between innerRadius and
+            outerRadius that lies between startAngle and endAngle
+            (clockwise) as horizontal spans
+
+    An inner radius of 0 renders a pie segment, and equal radii render
+    a one pixel wide arc.
+*/
+/**************************************************************************/
+static void drawArcSpans(uint16_t xCenter, uint16_t yCenter, uint16_t innerRadius, uint16_t outerRadius, int16_t startAngle, int16_t endAngle, uint16_t color)
+{
+  int32_t wedges[2][4];
+  uint8_t wedgeCount = 0;
+  int32_t sweep, y, outer, inner, xo, xi;
+
+  if (innerRadius > outerRadius)
+  {
+    return;
+  }
+
+  if (!drawIsVisible(xCenter - outerRadius, yCenter - outerRadius, xCenter + outerRadius, yCenter + outerRadius))
+  {
+    return;
+  }
+
+  sweep = (int32_t)endAngle - startAngle;
+  if (sweep == 0)
+  {
+    return;
+  }
+  if ((sweep < 360) && (sweep > -360))
+  {
+    sweep %= 360;
+    if (sweep < 0) sweep += 360;
+    // Split anything larger than 180 degrees into two convex wedges
+    wedges[0][0] = trigSin(startAngle);
+    wedges[0][1] = -trigCos(startAngle);
+    if (sweep > 180)
+    {
+      wedges[0][2] = trigSin(startAngle + 180);
+      wedges[0][3] = -trigCos(startAngle + 180);
+      wedges[1][0] = wedges[0][2];
+      wedges[1][1] = wedges[0][3];
+      wedgeCount++;
+    }
+    wedges[wedgeCount][2] = trigSin(endAngle);
+    wedges[wedgeCount][3] = -trigCos(endAngle);
+    wedgeCount++;
+  }
+
+  // Pixels with (2r - 1)^2 < 4(x^2 + y^2) <= (2r + 1)^2 are on a ring of radius r
+  outer = (2 * outerRadius + 1) * (2 * outerRadius + 1);
+  inner = (2 * innerRadius - 1) * (2 * innerRadius - 1);
+
+  for (y = -(int32_t)outerRadius; y <= (int32_t)outerRadius; y++)
+  {
+    xo = drawIsqrt((outer - 4 * y * y) / 4);
+    if ((innerRadius == 0) || (inner - 4 * y * y < 0))
+    {
+      drawArcSpan(xCenter, yCenter, y, -xo, xo, wedges, wedgeCount, color);
+    }
+    else
+    {
+      xi = drawIsqrt((inner - 4 * y * y) / 4) + 1;
+      if (xi <= xo)
+      {
+        drawArcSpan(xCenter, yCenter, y, -xo, -xi, wedges, wedgeCount, color);
+        drawArcSpan(xCenter, yCenter, y, xi, xo, wedges, wedgeCount, color);
+      }
+    }
+  }
+}
+
 /**************************************************************************/
 /*!
     @brief  Draws a single bitmap character
@@ -178,6 +473,162 @@ void drawCirclePoints(int cx, int cy, int x, int y, uint16_t color)
 /*                                                                        */
 /**************************************************************************/
 
+/**************************************************************************/
+/*!
+    @brief  Restricts all subsequent drawing to the intersection of the
+            supplied rectangle and the current clip rectangle
+
+    Co-ordinates are relative to the current viewport.  Every call must
+    be matched with a call to drawPopClip().
+
+    @param[in]  x0
+                Starting x co-ordinate
+    @param[in]  y0
+                Starting y co-ordinate
+    @param[in]  x1
+                Ending x co-ordinate (inclusive)
+    @param[in]  y1
+                Ending y co-ordinate (inclusive)
+
+    @return false if the clip stack is full (nothing was pushed)
+
+    @section Example
+
+    @code 
+
+    // Make sure a long label can't overwrite the widget next to it
+    drawPushClip(10, 10, 109, 29);
+    drawString(12, 24, COLOR_WHITE, &dejaVuSans9ptFontInfo, "A very long label");
+    drawPopClip();
+
+    @endcode
+*/
+/**************************************************************************/
+bool drawPushClip(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+  drawClip_t rect;
+
+  if (drawClipDepth >= DRAW_CLIPSTACK_DEPTH)
+  {
+    return false;
+  }
+
+  drawClipRefresh();
+  drawClipStack[drawClipDepth++] = drawClip;
+
+  if (drawClipRect(x0, y0, x1, y1, &rect))
+  {
+    drawClip.x0 = rect.x0;
+    drawClip.y0 = rect.y0;
+    drawClip.x1 = rect.x1;
+    drawClip.y1 = rect.y1;
+  }
+  else
+  {
+    // Nothing visible ... use an empty rectangle to reject everything
+    drawClip.x0 = drawClip.y0 = 1;
+    drawClip.x1 = drawClip.y1 = 0;
+  }
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Pushes a clip rectangle and moves the drawing origin to
+            its top-left corner
+
+    Widgets can render themselves at 0, 0 inside the viewport without
+    knowing where they are on the screen, and anything drawn outside
+    the viewport is clipped.  Every call must be matched with a call
+    to drawPopClip().
+
+    @param[in]  x
+                Left edge of the viewport (relative to the current one)
+    @param[in]  y
+                Top edge of the viewport (relative to the current one)
+    @param[in]  width
+                Viewport width in pixels
+    @param[in]  height
+                Viewport height in pixels
+
+    @return false if the clip stack is full (nothing was pushed)
+*/
+/**************************************************************************/
+bool drawPushViewport(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+  if ((width == 0) || (height == 0))
+  {
+    // Push an empty clip rectangle
+    if (!drawPushClip(x, y, x, y))
+    {
+      return false;
+    }
+    drawClip.x0 = drawClip.y0 = 1;
+    drawClip.x1 = drawClip.y1 = 0;
+  }
+  else if (!drawPushClip(x, y, x + width - 1, y + height - 1))
+  {
+    return false;
+  }
+
+  drawClip.originX += (int16_t)x;
+  drawClip.originY += (int16_t)y;
+
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Restores the clip rectangle and viewport that were active
+            before the last call to drawPushClip() or drawPushViewport()
+*/
+/**************************************************************************/
+void drawPopClip(void)
+{
+  if (drawClipDepth)
+  {
+    drawClip = drawClipStack[--drawClipDepth];
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Empties the clip stack so that drawing is only clipped
+            against the panel again
+*/
+/**************************************************************************/
+void drawResetClip(void)
+{
+  drawClipDepth = 0;
+  drawClipRefresh();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Checks if any part of the supplied rectangle is inside the
+            active clip rectangle
+
+    This can be used to skip building up a widget (or text) that
+    will not be visible anyway, which is the basis of partial redraws.
+
+    @param[in]  x0
+                Starting x co-ordinate
+    @param[in]  y0
+                Starting y co-ordinate
+    @param[in]  x1
+                Ending x co-ordinate (inclusive)
+    @param[in]  y1
+                Ending y co-ordinate (inclusive)
+*/
+/**************************************************************************/
+bool drawIsVisible(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+  drawClip_t rect;
+
+  return drawClipRect(x0, y0, x1, y1, &rect);
+}
+
 /**************************************************************************/
 /*!
     @brief  Draws a single pixel at the specified location
@@ -192,27 +643,47 @@ void drawCirclePoints(int cx, int cy, int x, int y, uint16_t color)
 /**************************************************************************/
 void drawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
-  if ((x >= lcdGetWidth()) || (y >= lcdGetHeight()))
+  int16_t sx, sy;
+
+  drawClipRefresh();
+  sx = (int16_t)x + drawClip.originX;
+  sy = (int16_t)y + drawClip.originY;
+
+  if ((sx < drawClip.x0) || (sx > drawClip.x1) || (sy < drawClip.y0) || (sy > drawClip.y1))
   {
     // Pixel out of range
     return;
   }
 
   // Redirect to LCD
-  lcdDrawPixel(x, y, color);
+  lcdDrawPixel(sx, sy, color);
 }
 
 /**************************************************************************/
 /*!
     @brief  Fills the screen with the specified color
 
+    If a clip rectangle has been pushed only the clip rectangle
+    is filled.
+
     @param[in]  color
                 Color used when drawing
 */
 /**************************************************************************/
 void drawFill(uint16_t color)
 {
-  lcdFillRGB(color);
+  int16_t y;
+
+  if (drawClipDepth == 0)
+  {
+    lcdFillRGB(color);
+    return;
+  }
+
+  for (y = drawClip.y0; y <= drawClip.y1; y++)
+  {
+    lcdDrawHLine(drawClip.x0, drawClip.x1, y, color);
+  }
 }
 
 /**************************************************************************/
@@ -329,8 +800,11 @@ void drawString(uint16_t x, uint16_t y, uint16_t color, const FONT_INFO *fontInf
       charOffset = (characterToOutput - fontInfo->startChar) * 5;
     }        
     
-    // Send individual characters
-    drawCharBitmap(currentX, y, color, &fontInfo->data[charOffset], fontInfo->heightPages, charWidth);
+    // Send individual characters (skipping any that are entirely clipped)
+    if (drawIsVisible(currentX, y - 7, currentX + charWidth - 1, y + (fontInfo->heightPages - 1) * 8))
+    {
+      drawCharBitmap(currentX, y, color, &fontInfo->data[charOffset], fontInfo->heightPages, charWidth);
+    }
 
     // next char X
     currentX += charWidth + 1;
@@ -434,16 +908,10 @@ void drawLineDotted ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16
     return;
   }
 
-  // If a negative y int was passed in it will overflow to 65K something
-  // Ugly, but drawCircleFilled() can pass in negative values so we need
-  // to check the values here
-  y0 = y0 > 65000 ? 0 : y0;
-  y1 = y1 > 65000 ? 0 : y1;
-
   // Check if we can use the optimised horizontal line method
   if ((y0 == y1) && (empty == 0))
   {
-    lcdDrawHLine(x0, x1, y0, color);
+    drawSpanH(x0, x1, y0, color);
     return;
   }
 
@@ -457,14 +925,20 @@ void drawLineDotted ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16
   {
     // Warning: This may actually be slower than drawing individual pixels on 
     // short lines ... Set a minimum line size to use the 'optimised' method
-    // (which changes the screen orientation) ?
-    lcdDrawVLine(x0, y0, y1, color);
+    // (which changes the GRAM address direction) ?
+    drawSpanV(x0, y0, y1, color);
+    return;
+  }
+
+  // Skip lines that are entirely outside the clip rectangle
+  if (!drawIsVisible(x0, y0, x1, y1))
+  {
     return;
   }
 
-  // Draw non-horizontal or dotted line
-  int dy = y1 - y0;
-  int dx = x1 - x0;
+  // Draw non-horizontal or dotted line (co-ordinates may be negative)
+  int dy = (int16_t)y1 - (int16_t)y0;
+  int dx = (int16_t)x1 - (int16_t)x0;
   int stepx, stepy;
   int emptycount, solidcount;
 
@@ -578,6 +1052,11 @@ void drawCircle (uint16_t xCenter, uint16_t yCenter, uint16_t radius, uint16_t c
   int y = radius;
   int p = (5 - radius*4)/4;
 
+  if (!drawIsVisible(xCenter - radius, yCenter - radius, xCenter + radius, yCenter + radius))
+  {
+    return;
+  }
+
   drawCirclePoints(xCenter, yCenter, x, y, color);
   while (x < y) 
   {
@@ -617,9 +1096,13 @@ void drawCircleFilled (uint16_t xCenter, uint16_t yCenter, uint16_t radius, uint
   int16_t x = 0;
   int16_t y = radius;
   int16_t xc_px, yc_my, xc_mx, xc_py, yc_mx, xc_my;
-  int16_t lcdWidth = lcdGetWidth();
 
-  if (xCenter < lcdWidth) drawLine(xCenter, yCenter-radius < 0 ? 0 : yCenter-radius, xCenter, (yCenter-radius) + (2*radius), color);
+  if (!drawIsVisible(xCenter - radius, yCenter - radius, xCenter + radius, yCenter + radius))
+  {
+    return;
+  }
+
+  drawSpanV(xCenter, yCenter - radius, yCenter + radius, color);
   
   while (x<y) 
   {
@@ -640,15 +1123,253 @@ void drawCircleFilled (uint16_t xCenter, uint16_t yCenter, uint16_t radius, uint
     yc_mx = yCenter-x;
     yc_my = yCenter-y;
 
-    // Make sure X positions are not negative or too large or the pixels will
-    // overflow.  Y overflow is handled in drawLine().
-    if ((xc_px < lcdWidth) && (xc_px >= 0)) drawLine(xc_px, yc_my, xc_px, yc_my + 2*y, color);
-    if ((xc_mx < lcdWidth) && (xc_mx >= 0)) drawLine(xc_mx, yc_my, xc_mx, yc_my + 2*y, color);
-    if ((xc_py < lcdWidth) && (xc_py >= 0)) drawLine(xc_py, yc_mx, xc_py, yc_mx + 2*x, color);
-    if ((xc_my < lcdWidth) && (xc_my >= 0)) drawLine(xc_my, yc_mx, xc_my, yc_mx + 2*x, color);
+    // Spans that are partially or entirely outside the clip rectangle
+    // (including negative co-ordinates) are clipped in drawSpanV()
+    drawSpanV(xc_px, yc_my, yc_my + 2*y, color);
+    drawSpanV(xc_mx, yc_my, yc_my + 2*y, color);
+    drawSpanV(xc_py, yc_mx, yc_mx + 2*x, color);
+    drawSpanV(xc_my, yc_mx, yc_mx + 2*x, color);
+  }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a one pixel wide arc
+
+    Angles are in degrees, with 0 pointing up (12 o'clock) and
+    increasing clockwise.  The arc is drawn clockwise from startAngle
+    to endAngle.
+
+    @param[in]  xCenter
+                The horizontal center of the arc
+    @param[in]  yCenter
+                The vertical center of the arc
+    @param[in]  radius
+                The arc's radius in pixels
+    @param[in]  startAngle
+                Starting angle in degrees
+    @param[in]  endAngle
+                Ending angle in degrees
+    @param[in]  color
+                Color used when drawing
+*/
+/**************************************************************************/
+void drawArc(uint16_t xCenter, uint16_t yCenter, uint16_t radius, int16_t startAngle, int16_t endAngle, uint16_t color)
+{
+  drawArcSpans(xCenter, yCenter, radius, radius, startAngle, endAngle, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a thick arc, filling the ring between innerRadius and
+            outerRadius
+
+    Angles are in degrees, with 0 pointing up (12 o'clock) and
+    increasing clockwise.  The arc is rendered as horizontal spans, so
+    it is well suited to gauge scales and bars.
+
+    @param[in]  xCenter
+                The horizontal center of the arc
+    @param[in]  yCenter
+                The vertical center of the arc
+    @param[in]  innerRadius
+                The inner radius in pixels
+    @param[in]  outerRadius
+                The outer radius in pixels
+    @param[in]  startAngle
+                Starting angle in degrees
+    @param[in]  endAngle
+                Ending angle in degrees
+    @param[in]  color
+                Color used when drawing
+
+    @section Example
+
+    @code 
+
+    #include "drivers/lcd/tft/drawing.h"
+
+    // 270 degree gauge scale with the last quarter in red
+    drawArcThick(120, 160, 80, 90, 225, 45, COLOR_WHITE);
+    drawArcThick(120, 160, 80, 90, 45, 135, COLOR_RED);
+
+    @endcode
+*/
+/**************************************************************************/
+void drawArcThick(uint16_t xCenter, uint16_t yCenter, uint16_t innerRadius, uint16_t outerRadius, int16_t startAngle, int16_t endAngle, uint16_t color)
+{
+  drawArcSpans(xCenter, yCenter, innerRadius, outerRadius, startAngle, endAngle, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a filled pie segment
+
+    Angles are in degrees, with 0 pointing up (12 o'clock) and
+    increasing clockwise.
+
+    @param[in]  xCenter
+                The horizontal center of the pie
+    @param[in]  yCenter
+                The vertical center of the pie
+    @param[in]  radius
+                The pie's radius in pixels
+    @param[in]  startAngle
+                Starting angle in degrees
+    @param[in]  endAngle
+                Ending angle in degrees
+    @param[in]  color
+                Color used when drawing
+*/
+/**************************************************************************/
+void drawPie(uint16_t xCenter, uint16_t yCenter, uint16_t radius, int16_t startAngle, int16_t endAngle, uint16_t color)
+{
+  drawArcSpans(xCenter, yCenter, 0, radius, startAngle, endAngle, color);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Draws a filled triangle using horizontal spans
+
+    @param[in]  x0
+                First x co-ordinate
+    @param[in]  y0
+                First y co-ordinate
+    @param[in]  x1
+                Second x co-ordinate
+    @param[in]  y1
+                Second y co-ordinate
+    @param[in]  x2
+                Third x co-ordinate
+    @param[in]  y2
+                Third y co-ordinate
+    @param[in]  color
+                Color used when drawing
+*/
+/**************************************************************************/
+void drawTriangleFilled(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color)
+{
+  int32_t ax = (int16_t)x0, ay = (int16_t)y0;
+  int32_t bx = (int16_t)x1, by = (int16_t)y1;
+  int32_t cx = (int16_t)x2, cy = (int16_t)y2;
+  int32_t t, y, yEnd, xLong, xShort, xMin, xMax;
+
+  // Sort the vertices so that ay <= by <= cy
+  if (by < ay) { t = ax; ax = bx; bx = t; t = ay; ay = by; by = t; }
+  if (cy < by) { t = bx; bx = cx; cx = t; t = by; by = cy; cy = t; }
+  if (by < ay) { t = ax; ax = bx; bx = t; t = ay; ay = by; by = t; }
+
+  xMin = ax < bx ? ax : bx;
+  xMin = cx < xMin ? cx : xMin;
+  xMax = ax > bx ? ax : bx;
+  xMax = cx > xMax ? cx : xMax;
+  if (!drawIsVisible(xMin, ay, xMax, cy))
+  {
+    return;
+  }
+
+  // Only walk the rows inside the clip rectangle
+  y = drawClip.y0 - drawClip.originY;
+  y = ay > y ? ay : y;
+  yEnd = drawClip.y1 - drawClip.originY;
+  yEnd = cy < yEnd ? cy : yEnd;
+
+  for (; y <= yEnd; y++)
+  {
+    xLong = cy == ay ? ax : ax + (cx - ax) * (y - ay) / (cy - ay);
+    if (y < by)
+    {
+      xShort = ax + (bx - ax) * (y - ay) / (by - ay);
+    }
+    else
+    {
+      xShort = cy == by ? bx : bx + (cx - bx) * (y - by) / (cy - by);
+    }
+    drawSpanH(xLong, xShort, y, color);
   }
 }
 
+/**************************************************************************/
+/*!
+    @brief  Draws a gauge needle, erasing its previous footprint
+
+    Only the pixels covered by the needle's last position are erased
+    (using bgColor), so several gauges can be updated at interactive
+    rates without redrawing their faces.  Nothing is rendered if the
+    angle hasn't changed.
+
+    @param[in]  needle
+                Pointer to the needle's settings and state.  'visible'
+                must be false before the first call.
+    @param[in]  angle
+                Angle in degrees, with 0 pointing up (12 o'clock) and
+                increasing clockwise
+
+    @section Example
+
+    @code 
+
+    #include "drivers/lcd/tft/drawing.h"
+
+    drawNeedle_t needle = { .xCenter = 120, .yCenter = 160, .length = 75,
+                            .width = 6, .color = COLOR_RED,
+                            .bgColor = COLOR_BLACK, .visible = false };
+
+    // Map 0..100% onto a 270 degree scale starting at 225 degrees
+    drawNeedle(&needle, 225 + (percent * 270) / 100);
+
+    @endcode
+*/
+/**************************************************************************/
+void drawNeedle(drawNeedle_t *needle, int16_t angle)
+{
+  int32_t sinA, cosA, half;
+
+  if (needle->visible)
+  {
+    if (angle == needle->angle)
+    {
+      return;
+    }
+
+    // Erase the previous footprint
+    if (needle->width <= 1)
+    {
+      drawLine(needle->xPoints[1], needle->yPoints[1], needle->xPoints[0], needle->yPoints[0], needle->bgColor);
+    }
+    else
+    {
+      drawTriangleFilled(needle->xPoints[0], needle->yPoints[0], needle->xPoints[1], needle->yPoints[1],
+                         needle->xPoints[2], needle->yPoints[2], needle->bgColor);
+    }
+  }
+
+  sinA = trigSin(angle);
+  cosA = trigCos(angle);
+  half = needle->width / 2;
+
+  // Tip, followed by the two corners at the pivot (rounded to the nearest pixel)
+  needle->xPoints[0] = needle->xCenter + ((needle->length * sinA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+  needle->yPoints[0] = needle->yCenter - ((needle->length * cosA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+  needle->xPoints[1] = needle->xCenter + ((half * cosA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+  needle->yPoints[1] = needle->yCenter + ((half * sinA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+  needle->xPoints[2] = needle->xCenter - ((half * cosA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+  needle->yPoints[2] = needle->yCenter - ((half * sinA + (TRIG_ONE / 2)) >> TRIG_SHIFT);
+
+  if (needle->width <= 1)
+  {
+    drawLine(needle->xPoints[1], needle->yPoints[1], needle->xPoints[0], needle->yPoints[0], needle->color);
+  }
+  else
+  {
+    drawTriangleFilled(needle->xPoints[0], needle->yPoints[0], needle->xPoints[1], needle->yPoints[1],
+                       needle->xPoints[2], needle->yPoints[2], needle->color);
+  }
+
+  needle->angle = angle;
+  needle->visible = true;
+}
+
 /**************************************************************************/
 /*!
     @brief  Draws a simple arrow of the specified width
@@ -766,29 +1487,18 @@ void drawRectangle ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 /**************************************************************************/
 void drawRectangleFilled ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
 {
-  int height;
-  uint16_t x, y;
+  drawClip_t rect;
+  int16_t y;
 
-  if (y1 < y0)
-  {
-    // Switch y1 and y0
-    y = y1;
-    y1 = y0;
-    y0 = y;
-  }
-
-  if (x1 < x0)
+  // Sort, translate and clip the corners once rather than for every row
+  if (!drawClipRect(x0, y0, x1, y1, &rect))
   {
-    // Switch x1 and x0
-    x = x1;
-    x1 = x0;
-    x0 = x;
+    return;
   }
 
-  height = y1 - y0;
-  for (height = y0; y1 > height - 1; ++height)
+  for (y = rect.y0; y <= rect.y1; y++)
   {
-    drawLine(x0, height, x1, height, color);
+    lcdDrawHLine(rect.x0, rect.x1, y, color);
   }
 }
 
@@ -817,6 +1527,11 @@ void drawRectangleRounded ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1,
   int height;
   uint16_t y;
 
+  if (!drawIsVisible(x0, y0, x1, y1))
+  {
+    return;
+  }
+
   if (corners == DRAW_ROUNDEDCORNERS_NONE)
   {
     drawRectangleFilled(x0, y0, x1, y1, color);
@@ -1131,6 +1846,12 @@ void drawButton(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const F
 void drawIcon16(uint16_t x, uint16_t y, uint16_t color, uint16_t icon[])
 {
   int i;
+
+  if (!drawIsVisible(x, y, x + 15, y + 15))
+  {
+    return;
+  }
+
   for (i = 0; i<16; i++)
   {
     if (icon[i] & (0X8000)) drawPixel(x, y+i, color);
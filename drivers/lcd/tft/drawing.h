@@ -51,6 +51,8 @@
   #include "bmp.h"
 #endif
 
+#define DRAW_CLIPSTACK_DEPTH    (4)     /* Max nested drawPushClip/drawPushViewport calls */
+
 typedef struct
 {
   uint8_t red;
@@ -76,6 +78,25 @@ typedef enum
   DRAW_DIRECTION_DOWN
 } drawDirection_t;
 
+typedef struct
+{
+  uint16_t xCenter;         // Pivot point
+  uint16_t yCenter;
+  uint16_t length;          // Distance from the pivot to the tip in pixels
+  uint16_t width;           // Width at the pivot in pixels (0 or 1 for a line)
+  uint16_t color;
+  uint16_t bgColor;         // Color used to erase the previous footprint
+  bool     visible;         // Must be false before the first drawNeedle()
+  int16_t  angle;           // Last rendered angle
+  int16_t  xPoints[3];      // Last rendered footprint (tip, base, base)
+  int16_t  yPoints[3];
+} drawNeedle_t;
+
+bool      drawPushClip         ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1 );
+bool      drawPushViewport     ( uint16_t x, uint16_t y, uint16_t width, uint16_t height );
+void      drawPopClip          ( void );
+void      drawResetClip        ( void );
+bool      drawIsVisible        ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1 );
 void      drawTestPattern      ( void );
 void      drawPixel            ( uint16_t x, uint16_t y, uint16_t color );
 void      drawFill             ( uint16_t color );
@@ -83,6 +104,11 @@ void      drawLine             ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t
 void      drawLineDotted       ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t space, uint16_t solid, uint16_t color );
 void      drawCircle           ( uint16_t xCenter, uint16_t yCenter, uint16_t radius, uint16_t color );
 void      drawCircleFilled     ( uint16_t xCenter, uint16_t yCenter, uint16_t radius, uint16_t color );
+void      drawArc              ( uint16_t xCenter, uint16_t yCenter, uint16_t radius, int16_t startAngle, int16_t endAngle, uint16_t color );
+void      drawArcThick         ( uint16_t xCenter, uint16_t yCenter, uint16_t innerRadius, uint16_t outerRadius, int16_t startAngle, int16_t endAngle, uint16_t color );
+void      drawPie              ( uint16_t xCenter, uint16_t yCenter, uint16_t radius, int16_t startAngle, int16_t endAngle, uint16_t color );
+void      drawTriangleFilled   ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color );
+void      drawNeedle           ( drawNeedle_t *needle, int16_t angle );
 void      drawArrow            ( uint16_t x, uint16_t y, uint16_t size, drawDirection_t, uint16_t color );
 void      drawRectangle        ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color );
 void      drawRectangleFilled  ( uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color );
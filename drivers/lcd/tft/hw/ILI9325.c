@@ -52,6 +52,7 @@
 
 static lcdOrientation_t lcdOrientation = LCD_ORIENTATION_PORTRAIT;
 static lcdProperties_t ili9325Properties = { 240, 320, TRUE, TRUE, TRUE };
+static uint16_t ili9325EntryMode = 0x1030;
 
 /*************************************************/
 /* Private Methods                               */
@@ -72,109 +73,6 @@ void ili9325Delay(unsigned int t)
   }
 }
 
-/**************************************************************************/
-/*! 
-    @brief  Writes the supplied 16-bit command using an 8-bit interface
-*/
-/**************************************************************************/
-void ili9325WriteCmd(uint16_t command) 
-{
-  // Compiled with -Os on GCC 4.4 this works out to 25 cycles
-  // (versus 36 compiled with no optimisations).  I'm not sure it
-  // can be improved further, so that means 25 cycles/350nS for
-  // continuous writes (cmd, data, data, data, ...) or ~150 cycles/
-  // ~2.1uS for a random pixel (Set X [cmd+data], Set Y [cmd+data],
-  // Set color [cmd+data]) (times assumes 72MHz clock).
-
-  CLR_CS_CD_SET_RD_WR;  // Saves 18 commands compared to "CLR_CS; CLR_CD; SET_RD; SET_WR;" 
-  ILI9325_GPIO2DATA_DATA = (command >> (8 - ILI9325_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ILI9325_GPIO2DATA_DATA = command << ILI9325_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR; SET_CS;"
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Writes the supplied 16-bit data using an 8-bit interface
-*/
-/**************************************************************************/
-void ili9325WriteData(uint16_t data)
-{
-  CLR_CS_SET_CD_RD_WR;  // Saves 18 commands compared to SET_CD; SET_RD; SET_WR; CLR_CS"
-  ILI9325_GPIO2DATA_DATA = (data >> (8 - ILI9325_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ILI9325_GPIO2DATA_DATA = data << ILI9325_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR, SET_CS;"
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Reads a 16-bit value from the 8-bit data bus
-*/
-/**************************************************************************/
-uint16_t ili9325ReadData(void)
-{
-  // ToDo: Optimise this method!
-
-  uint16_t high, low;
-  high = low = 0;
-  uint16_t d;
-
-  SET_CD_RD_WR;   // Saves 14 commands compared to "SET_CD; SET_RD; SET_WR"
-  CLR_CS;
-  
-  // set inputs
-  ILI9325_GPIO2DATA_SETINPUT;
-  CLR_RD;
-  ili9325Delay(100);
-  high = ILI9325_GPIO2DATA_DATA;  
-  high >>= ILI9325_DATA_OFFSET;
-  high &= 0xFF;
-  SET_RD;
-  
-  CLR_RD;
-  ili9325Delay(100);
-  low = ILI9325_GPIO2DATA_DATA;
-  low >>= ILI9325_DATA_OFFSET;
-  low &=0xFF;
-  SET_RD;
-  
-  SET_CS;
-  ILI9325_GPIO2DATA_SETOUTPUT;
-
-  d = high;
-  d <<= 8;
-  d |= low;
-  
-  return d;
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Reads a 16-bit value
-*/
-/**************************************************************************/
-uint16_t ili9325Read(uint16_t addr)
-{
-  ili9325WriteCmd(addr);
-  return ili9325ReadData();
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Sends a 16-bit command + 16-bit data
-*/
-/**************************************************************************/
-void ili9325Command(uint16_t command, uint16_t data)
-{
-  ili9325WriteCmd(command);
-  ili9325WriteData(data);
-}
-
 /**************************************************************************/
 /*! 
     @brief  Returns the 16-bit (4-hexdigit) controller code
@@ -182,32 +80,38 @@ void ili9325Command(uint16_t command, uint16_t data)
 /**************************************************************************/
 uint16_t ili9325Type(void)
 {
-  ili9325WriteCmd(ILI9325_COMMANDS_DRIVERCODEREAD);
-  return ili9325ReadData();
+  lcdBus8WriteCmd(ILI9325_COMMANDS_DRIVERCODEREAD);
+  return lcdBus8ReadData();
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Sets the cursor to the specified X/Y position
+    @brief  Sets the cursor to the specified X/Y position and selects
+            the GRAM data register (R22h)
 */
 /**************************************************************************/
 void ili9325SetCursor(uint16_t x, uint16_t y)
 {
   uint16_t al, ah;
   
-  if (lcdOrientation == LCD_ORIENTATION_LANDSCAPE)
+  // GRAM is always addressed in portrait co-ordinates, with the panel
+  // rotation handled by the SS/GS bits (see lcdSetOrientation)
+  switch (lcdOrientation)
   {
-    al = y;
-    ah = x;
-  }
-  else
-  {
-    al = x;
-    ah = y;
+    case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+      al = y;
+      ah = x;
+      break;
+    case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
+    default:
+      al = x;
+      ah = y;
+      break;
   }
 
-  ili9325Command(ILI9325_COMMANDS_HORIZONTALGRAMADDRESSSET, al);
-  ili9325Command(ILI9325_COMMANDS_VERTICALGRAMADDRESSSET, ah);
+  lcdBus8SetCursor(al, ah);
 }
 
 /**************************************************************************/
@@ -218,7 +122,7 @@ void ili9325SetCursor(uint16_t x, uint16_t y)
 void ili9325InitDisplay(void)
 {
   // Clear data line
-  GPIO_GPIO2DATA &= ~ILI9325_DATA_MASK;
+  GPIO_GPIO2DATA &= ~LCDBUS8_DATA_MASK;
     
   SET_RD;
   SET_WR;
@@ -231,47 +135,47 @@ void ili9325InitDisplay(void)
   SET_RESET;
   ili9325Delay(500);
 
-  ili9325Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL1, 0x0100);  // Driver Output Control Register (R01h)
-  ili9325Command(ILI9325_COMMANDS_LCDDRIVINGCONTROL, 0x0700);     // LCD Driving Waveform Control (R02h)
-  ili9325Command(ILI9325_COMMANDS_ENTRYMODE, 0x1030);             // Entry Mode (R03h)  
-  ili9325Command(ILI9325_COMMANDS_DISPLAYCONTROL2, 0x0302);
-  ili9325Command(ILI9325_COMMANDS_DISPLAYCONTROL3, 0x0000);
-  ili9325Command(ILI9325_COMMANDS_DISPLAYCONTROL4, 0x0000);       // Fmark On
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL1, 0x0000);         // Power Control 1 (R10h)
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL3, 0x0000);         // Power Control 3 (R12h)
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL4, 0x0000);         // Power Control 4 (R13h)
+  lcdBus8Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL1, 0x0100);  // Driver Output Control Register (R01h)
+  lcdBus8Command(ILI9325_COMMANDS_LCDDRIVINGCONTROL, 0x0700);     // LCD Driving Waveform Control (R02h)
+  lcdBus8Command(ILI9325_COMMANDS_ENTRYMODE, 0x1030);             // Entry Mode (R03h)  
+  lcdBus8Command(ILI9325_COMMANDS_DISPLAYCONTROL2, 0x0302);
+  lcdBus8Command(ILI9325_COMMANDS_DISPLAYCONTROL3, 0x0000);
+  lcdBus8Command(ILI9325_COMMANDS_DISPLAYCONTROL4, 0x0000);       // Fmark On
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL1, 0x0000);         // Power Control 1 (R10h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL3, 0x0000);         // Power Control 3 (R12h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL4, 0x0000);         // Power Control 4 (R13h)
   ili9325Delay(1000);  
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL1, 0x14B0);         // Power Control 1 (R10h)  
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL1, 0x14B0);         // Power Control 1 (R10h)  
   ili9325Delay(500);  
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)  
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)  
   ili9325Delay(500);  
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL3, 0x008E);         // Power Control 3 (R12h)
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL4, 0x0C00);         // Power Control 4 (R13h)
-  ili9325Command(ILI9325_COMMANDS_POWERCONTROL7, 0x0015);         // NVM read data 2 (R29h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL3, 0x008E);         // Power Control 3 (R12h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL4, 0x0C00);         // Power Control 4 (R13h)
+  lcdBus8Command(ILI9325_COMMANDS_POWERCONTROL7, 0x0015);         // NVM read data 2 (R29h)
   ili9325Delay(500);
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL1, 0x0000);         // Gamma Control 1
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL2, 0x0107);         // Gamma Control 2
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL3, 0x0000);         // Gamma Control 3
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL4, 0x0203);         // Gamma Control 4
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL5, 0x0402);         // Gamma Control 5
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL6, 0x0000);         // Gamma Control 6
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL7, 0x0207);         // Gamma Control 7
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL8, 0x0000);         // Gamma Control 8
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL9, 0x0203);         // Gamma Control 9
-  ili9325Command(ILI9325_COMMANDS_GAMMACONTROL10, 0x0403);        // Gamma Control 10
-  ili9325Command(ILI9325_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, 0x0000);                      // Window Horizontal RAM Address Start (R50h)
-  ili9325Command(ILI9325_COMMANDS_HORIZONTALADDRESSENDPOSITION, ili9325Properties.width - 1);   // Window Horizontal RAM Address End (R51h)
-  ili9325Command(ILI9325_COMMANDS_VERTICALADDRESSSTARTPOSITION, 0X0000);                        // Window Vertical RAM Address Start (R52h)
-  ili9325Command(ILI9325_COMMANDS_VERTICALADDRESSENDPOSITION, ili9325Properties.height - 1);    // Window Vertical RAM Address End (R53h)
-  ili9325Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL2, 0xa700);    // Driver Output Control (R60h)
-  ili9325Command(ILI9325_COMMANDS_BASEIMAGEDISPLAYCONTROL, 0x0003); // Driver Output Control (R61h) - enable VLE
-  ili9325Command(ILI9325_COMMANDS_PANELINTERFACECONTROL1, 0X0010);  // Panel Interface Control 1 (R90h)
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL1, 0x0000);         // Gamma Control 1
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL2, 0x0107);         // Gamma Control 2
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL3, 0x0000);         // Gamma Control 3
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL4, 0x0203);         // Gamma Control 4
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL5, 0x0402);         // Gamma Control 5
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL6, 0x0000);         // Gamma Control 6
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL7, 0x0207);         // Gamma Control 7
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL8, 0x0000);         // Gamma Control 8
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL9, 0x0203);         // Gamma Control 9
+  lcdBus8Command(ILI9325_COMMANDS_GAMMACONTROL10, 0x0403);        // Gamma Control 10
+  lcdBus8Command(ILI9325_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, 0x0000);                      // Window Horizontal RAM Address Start (R50h)
+  lcdBus8Command(ILI9325_COMMANDS_HORIZONTALADDRESSENDPOSITION, ili9325Properties.width - 1);   // Window Horizontal RAM Address End (R51h)
+  lcdBus8Command(ILI9325_COMMANDS_VERTICALADDRESSSTARTPOSITION, 0X0000);                        // Window Vertical RAM Address Start (R52h)
+  lcdBus8Command(ILI9325_COMMANDS_VERTICALADDRESSENDPOSITION, ili9325Properties.height - 1);    // Window Vertical RAM Address End (R53h)
+  lcdBus8Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL2, 0xa700);    // Driver Output Control (R60h)
+  lcdBus8Command(ILI9325_COMMANDS_BASEIMAGEDISPLAYCONTROL, 0x0003); // Driver Output Control (R61h) - enable VLE
+  lcdBus8Command(ILI9325_COMMANDS_PANELINTERFACECONTROL1, 0X0010);  // Panel Interface Control 1 (R90h)
 
   // Display On
-  ili9325Command(ILI9325_COMMANDS_DISPLAYCONTROL1, 0x0133);     // Display Control (R07h)
+  lcdBus8Command(ILI9325_COMMANDS_DISPLAYCONTROL1, 0x0133);     // Display Control (R07h)
   ili9325Delay(500);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);
+  lcdBus8WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);
 }
 
 /**************************************************************************/
@@ -282,7 +186,6 @@ void ili9325InitDisplay(void)
 void ili9325Home(void)
 {
   ili9325SetCursor(0, 0);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);            // Write Data to GRAM (R22h)
 }
 
 /**************************************************************************/
@@ -292,10 +195,21 @@ void ili9325Home(void)
 /**************************************************************************/
 void ili9325SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
-  ili9325Command(ILI9325_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, x0);
-  ili9325Command(ILI9325_COMMANDS_HORIZONTALADDRESSENDPOSITION, x1);
-  ili9325Command(ILI9325_COMMANDS_VERTICALADDRESSSTARTPOSITION, y0);
-  ili9325Command(ILI9325_COMMANDS_VERTICALADDRESSENDPOSITION, y1);
+  uint16_t h0 = x0, h1 = x1, v0 = y0, v1 = y1;
+
+  // The window is set in GRAM co-ordinates, so swap the axes in landscape
+  if ((lcdOrientation == LCD_ORIENTATION_LANDSCAPE) || (lcdOrientation == LCD_ORIENTATION_LANDSCAPE_INVERTED))
+  {
+    h0 = y0;
+    h1 = y1;
+    v0 = x0;
+    v1 = x1;
+  }
+
+  lcdBus8Command(ILI9325_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, h0);
+  lcdBus8Command(ILI9325_COMMANDS_HORIZONTALADDRESSENDPOSITION, h1);
+  lcdBus8Command(ILI9325_COMMANDS_VERTICALADDRESSSTARTPOSITION, v0);
+  lcdBus8Command(ILI9325_COMMANDS_VERTICALADDRESSENDPOSITION, v1);
   ili9325SetCursor(x0, y0);
 }
 
@@ -310,27 +224,8 @@ void ili9325SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 /**************************************************************************/
 void lcdInit(void)
 {
-  // Set control line pins to output
-  gpioSetDir(ILI9325_CS_PORT, ILI9325_CS_PIN, 1);
-  gpioSetDir(ILI9325_CD_PORT, ILI9325_CD_PIN, 1);
-  gpioSetDir(ILI9325_WR_PORT, ILI9325_WR_PIN, 1);
-  gpioSetDir(ILI9325_RD_PORT, ILI9325_RD_PIN, 1);
-  
-  // Set data port pins to output
-  ILI9325_GPIO2DATA_SETOUTPUT;
-
-  // Disable pullups
-  ILI9325_DISABLEPULLUPS();
-  
-  // Set backlight pin to output and turn it on
-  gpioSetDir(ILI9325_BL_PORT, ILI9325_BL_PIN, 1);      // set to output
-  lcdBacklight(TRUE);
-
-  // Set reset pin to output
-  gpioSetDir(ILI9325_RES_PORT, ILI9325_RES_PIN, 1);    // Set to output
-  gpioSetValue(ILI9325_RES_PORT, ILI9325_RES_PIN, 0);  // Low to reset
-  systickDelay(50);
-  gpioSetValue(ILI9325_RES_PORT, ILI9325_RES_PIN, 1);  // High to exit
+  // Configure the bus pins, turn the backlight on and reset the LCD
+  lcdBus8Init();
 
   // Initialize the display
   ili9325InitDisplay();
@@ -355,7 +250,7 @@ void lcdInit(void)
 void lcdBacklight(bool state)
 {
   // Set the backlight
-  gpioSetValue(ILI9325_BL_PORT, ILI9325_BL_PIN, state ? 0 : 1);
+  lcdBus8Backlight(state);
 }
 
 /**************************************************************************/
@@ -372,14 +267,14 @@ void lcdTest(void)
   {
     for(j=0;j<240;j++)
     {
-      if(i>279)ili9325WriteData(COLOR_WHITE);
-      else if(i>239)ili9325WriteData(COLOR_BLUE);
-      else if(i>199)ili9325WriteData(COLOR_GREEN);
-      else if(i>159)ili9325WriteData(COLOR_CYAN);
-      else if(i>119)ili9325WriteData(COLOR_RED);
-      else if(i>79)ili9325WriteData(COLOR_MAGENTA);
-      else if(i>39)ili9325WriteData(COLOR_YELLOW);
-      else ili9325WriteData(COLOR_BLACK);
+      if(i>279)lcdBus8WriteData(COLOR_WHITE);
+      else if(i>239)lcdBus8WriteData(COLOR_BLUE);
+      else if(i>199)lcdBus8WriteData(COLOR_GREEN);
+      else if(i>159)lcdBus8WriteData(COLOR_CYAN);
+      else if(i>119)lcdBus8WriteData(COLOR_RED);
+      else if(i>79)lcdBus8WriteData(COLOR_MAGENTA);
+      else if(i>39)lcdBus8WriteData(COLOR_YELLOW);
+      else lcdBus8WriteData(COLOR_BLACK);
     }
   }
 }
@@ -391,14 +286,8 @@ void lcdTest(void)
 /**************************************************************************/
 void lcdFillRGB(uint16_t data)
 {
-  unsigned int i;
   ili9325Home();
-  
-  uint32_t pixels = 320*240;
-  for ( i=0; i < pixels; i++ )
-  {
-    ili9325WriteData(data);
-  } 
+  lcdBus8WriteRepeat(data, 320*240);
 }
 
 /**************************************************************************/
@@ -409,8 +298,7 @@ void lcdFillRGB(uint16_t data)
 void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
   ili9325SetCursor(x, y);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);  // Write Data to GRAM (R22h)
-  ili9325WriteData(color);
+  lcdBus8WriteData(color);
 }
 
 /**************************************************************************/
@@ -421,14 +309,8 @@ void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 /**************************************************************************/
 void lcdDrawPixels(uint16_t x, uint16_t y, uint16_t *data, uint32_t len)
 {
-  uint32_t i = 0;
   ili9325SetCursor(x, y);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);
-  do
-  {
-    ili9325WriteData(data[i]);
-    i++;
-  } while (i<len);
+  lcdBus8WritePixels(data, len);
 }
 
 /**************************************************************************/
@@ -440,7 +322,7 @@ void lcdDrawPixels(uint16_t x, uint16_t y, uint16_t *data, uint32_t len)
 void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
 {
   // Allows for slightly better performance than setting individual pixels
-  uint16_t x, pixels;
+  uint16_t x;
 
   if (x1 < x0)
   {
@@ -461,11 +343,7 @@ void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
   }
 
   ili9325SetCursor(x0, y);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);  // Write Data to GRAM (R22h)
-  for (pixels = 0; pixels < x1 - x0 + 1; pixels++)
-  {
-    ili9325WriteData(color);
-  }
+  lcdBus8WriteRepeat(color, x1 - x0 + 1);
 }
 
 /**************************************************************************/
@@ -476,17 +354,32 @@ void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
 /**************************************************************************/
 void lcdDrawVLine(uint16_t x, uint16_t y0, uint16_t y1, uint16_t color)
 {
-  // Allows for slightly better performance than setting individual pixels
-  lcdOrientation_t orientation = lcdOrientation;
+  uint16_t y;
 
-  // Switch orientation
-  lcdSetOrientation(orientation == LCD_ORIENTATION_PORTRAIT ? LCD_ORIENTATION_LANDSCAPE : LCD_ORIENTATION_PORTRAIT);
+  if (y1 < y0)
+  {
+    // Switch y1 and y0
+    y = y1;
+    y1 = y0;
+    y0 = y;
+  }
 
-  // Draw horizontal line like usual
-  lcdDrawHLine(y0, y1, lcdGetHeight() - (x + 1), color);
+  // Check limits
+  if (y1 >= lcdGetHeight())
+  {
+    y1 = lcdGetHeight() - 1;
+  }
+  if (y0 >= lcdGetHeight())
+  {
+    y0 = lcdGetHeight() - 1;
+  }
 
-  // Switch orientation back
-  lcdSetOrientation(orientation);
+  // Toggle the AM bit so that the GRAM address auto-increments along
+  // the y axis, draw the line in one burst, then restore the entry mode
+  lcdBus8Command(ILI9325_COMMANDS_ENTRYMODE, ili9325EntryMode ^ 0x0008);
+  ili9325SetCursor(x, y0);
+  lcdBus8WriteRepeat(color, y1 - y0 + 1);
+  lcdBus8Command(ILI9325_COMMANDS_ENTRYMODE, ili9325EntryMode);
 }
 
 /**************************************************************************/
@@ -499,39 +392,59 @@ uint16_t lcdGetPixel(uint16_t x, uint16_t y)
   uint16_t preFetch = 0;
 
   ili9325SetCursor(x, y);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);
-  preFetch = ili9325ReadData();
+  preFetch = lcdBus8ReadData();
 
   // Eeek ... why does this need to be done twice for a proper value?!?
   ili9325SetCursor(x, y);
-  ili9325WriteCmd(ILI9325_COMMANDS_WRITEDATATOGRAM);
-  return ili9325ReadData();
+  return lcdBus8ReadData();
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Sets the LCD orientation to horizontal and vertical
+    @brief  Sets the LCD orientation (portrait or landscape, either of
+            which can be rotated 180 degrees)
 */
 /**************************************************************************/
 void lcdSetOrientation(lcdOrientation_t orientation)
 {
   uint16_t entryMode = 0x1030;
   uint16_t outputControl = 0x0100;
-
+  uint16_t gateScan = 0xA700;
+
+  // Rotation is handled entirely by the controller:
+  //   Entry Mode (R03h) AM    - GRAM auto-increments horizontally (0) or
+  //                             vertically (1), so bursts always follow
+  //                             the x axis of the current orientation
+  //   Output Control (R01h) SS - Source (horizontal) output direction
+  //   Output Control (R60h) GS - Gate (vertical) scan direction
   switch (orientation)
   {
     case LCD_ORIENTATION_PORTRAIT:
       entryMode = 0x1030;
       outputControl = 0x0100;
+      gateScan = 0xA700;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
-      entryMode = 0x1028;
+      entryMode = 0x1038;
       outputControl = 0x0000;
+      gateScan = 0xA700;
+      break;
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
+      entryMode = 0x1030;
+      outputControl = 0x0000;
+      gateScan = 0x2700;
+      break;
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+      entryMode = 0x1038;
+      outputControl = 0x0100;
+      gateScan = 0x2700;
       break;
   }
 
-  ili9325Command(ILI9325_COMMANDS_ENTRYMODE, entryMode);
-  ili9325Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL1, outputControl);
+  lcdBus8Command(ILI9325_COMMANDS_ENTRYMODE, entryMode);
+  lcdBus8Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL1, outputControl);
+  lcdBus8Command(ILI9325_COMMANDS_DRIVEROUTPUTCONTROL2, gateScan);
+  ili9325EntryMode = entryMode;
   lcdOrientation = orientation;
 
   ili9325SetCursor(0, 0);
@@ -539,7 +452,7 @@ void lcdSetOrientation(lcdOrientation_t orientation)
 
 /**************************************************************************/
 /*! 
-    @brief  Gets the current screen orientation (horizontal or vertical)
+    @brief  Gets the current screen orientation
 */
 /**************************************************************************/
 lcdOrientation_t lcdGetOrientation(void)
@@ -558,9 +471,11 @@ uint16_t lcdGetWidth(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return ili9325Properties.width;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return ili9325Properties.height;
   }
@@ -577,9 +492,11 @@ uint16_t lcdGetHeight(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return ili9325Properties.height;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return ili9325Properties.width;
   }
@@ -598,8 +515,8 @@ void lcdScroll(int16_t pixels, uint16_t fillColor)
     y += 320;
   while (y >= 320)
     y -= 320;
-  ili9325WriteCmd(ILI9325_COMMANDS_VERTICALSCROLLCONTROL);
-  ili9325WriteData(y);
+  lcdBus8WriteCmd(ILI9325_COMMANDS_VERTICALSCROLLCONTROL);
+  lcdBus8WriteData(y);
 }
 
 /**************************************************************************/
@@ -45,6 +45,7 @@
 
 static volatile lcdOrientation_t lcdOrientation = LCD_ORIENTATION_PORTRAIT;
 static lcdProperties_t ili9328Properties = { 240, 320, TRUE, TRUE, TRUE };
+static uint16_t ili9328EntryMode = 0x1030;
 
 /*************************************************/
 /* Private Methods                               */
@@ -65,109 +66,6 @@ void ili9328Delay(unsigned int t)
   }
 }
 
-/**************************************************************************/
-/*! 
-    @brief  Writes the supplied 16-bit command using an 8-bit interface
-*/
-/**************************************************************************/
-void ili9328WriteCmd(uint16_t command) 
-{
-  // Compiled with -Os on GCC 4.4 this works out to 25 cycles
-  // (versus 36 compiled with no optimisations).  I'm not sure it
-  // can be improved further, so that means 25 cycles/350nS for
-  // continuous writes (cmd, data, data, data, ...) or ~150 cycles/
-  // ~2.1uS for a random pixel (Set X [cmd+data], Set Y [cmd+data],
-  // Set color [cmd+data]) (times assumes 72MHz clock).
-
-  CLR_CS_CD_SET_RD_WR;  // Saves 18 commands compared to "CLR_CS; CLR_CD; SET_RD; SET_WR;" 
-  ILI9328_GPIO2DATA_DATA = (command >> (8 - ILI9328_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ILI9328_GPIO2DATA_DATA = command << ILI9328_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR; SET_CS;"
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Writes the supplied 16-bit data using an 8-bit interface
-*/
-/**************************************************************************/
-void ili9328WriteData(uint16_t data)
-{
-  CLR_CS_SET_CD_RD_WR;  // Saves 18 commands compared to SET_CD; SET_RD; SET_WR; CLR_CS"
-  ILI9328_GPIO2DATA_DATA = (data >> (8 - ILI9328_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ILI9328_GPIO2DATA_DATA = data << ILI9328_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR, SET_CS;"
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Reads a 16-bit value from the 8-bit data bus
-*/
-/**************************************************************************/
-uint16_t ili9328ReadData(void)
-{
-  // ToDo: Optimise this method!
-
-  uint16_t high, low;
-  high = low = 0;
-  uint16_t d;
-
-  SET_CD_RD_WR;   // Saves 14 commands compared to "SET_CD; SET_RD; SET_WR"
-  CLR_CS;
-  
-  // set inputs
-  ILI9328_GPIO2DATA_SETINPUT;
-  CLR_RD;
-  ili9328Delay(100);
-  high = ILI9328_GPIO2DATA_DATA;  
-  high >>= ILI9328_DATA_OFFSET;
-  high &= 0xFF;
-  SET_RD;
-  
-  CLR_RD;
-  ili9328Delay(100);
-  low = ILI9328_GPIO2DATA_DATA;
-  low >>= ILI9328_DATA_OFFSET;
-  low &=0xFF;
-  SET_RD;
-  
-  SET_CS;
-  ILI9328_GPIO2DATA_SETOUTPUT;
-
-  d = high;
-  d <<= 8;
-  d |= low;
-  
-  return d;
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Reads a 16-bit value
-*/
-/**************************************************************************/
-uint16_t ili9328Read(uint16_t addr)
-{
-  ili9328WriteCmd(addr);
-  return ili9328ReadData();
-}
-
-/**************************************************************************/
-/*! 
-    @brief  Sends a 16-bit command + 16-bit data
-*/
-/**************************************************************************/
-void ili9328Command(uint16_t command, uint16_t data)
-{
-  ili9328WriteCmd(command);
-  ili9328WriteData(data);
-}
-
 /**************************************************************************/
 /*! 
     @brief  Returns the 16-bit (4-hexdigit) controller code
@@ -175,32 +73,38 @@ void ili9328Command(uint16_t command, uint16_t data)
 /**************************************************************************/
 uint16_t ili9328Type(void)
 {
-  ili9328WriteCmd(ILI9328_COMMANDS_DRIVERCODEREAD);
-  return ili9328ReadData();
+  lcdBus8WriteCmd(ILI9328_COMMANDS_DRIVERCODEREAD);
+  return lcdBus8ReadData();
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Sets the cursor to the specified X/Y position
+    @brief  Sets the cursor to the specified X/Y position and selects
+            the GRAM data register (R22h)
 */
 /**************************************************************************/
 void ili9328SetCursor(uint16_t x, uint16_t y)
 {
   uint16_t al, ah;
   
-  if (lcdOrientation == LCD_ORIENTATION_LANDSCAPE)
-  {
-    al = y;
-    ah = x;
-  }
-  else
+  // GRAM is always addressed in portrait co-ordinates, with the panel
+  // rotation handled by the SS/GS bits (see lcdSetOrientation)
+  switch (lcdOrientation)
   {
-    al = x;
-    ah = y;
+    case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+      al = y;
+      ah = x;
+      break;
+    case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
+    default:
+      al = x;
+      ah = y;
+      break;
   }
 
-  ili9328Command(ILI9328_COMMANDS_HORIZONTALGRAMADDRESSSET, al);
-  ili9328Command(ILI9328_COMMANDS_VERTICALGRAMADDRESSSET, ah);
+  lcdBus8SetCursor(al, ah);
 }
 
 /**************************************************************************/
@@ -211,7 +115,7 @@ void ili9328SetCursor(uint16_t x, uint16_t y)
 void ili9328InitDisplay(void)
 {
   // Clear data line
-  GPIO_GPIO2DATA &= ~ILI9328_DATA_MASK;
+  GPIO_GPIO2DATA &= ~LCDBUS8_DATA_MASK;
     
   SET_RD;
   SET_WR;
@@ -224,47 +128,47 @@ void ili9328InitDisplay(void)
   SET_RESET;
   ili9328Delay(1000);
 
-  ili9328Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL1, 0x0100);  // Driver Output Control Register (R01h)
-  ili9328Command(ILI9328_COMMANDS_LCDDRIVINGCONTROL, 0x0700);     // LCD Driving Waveform Control (R02h)
-  ili9328Command(ILI9328_COMMANDS_ENTRYMODE, 0x1030);             // Entry Mode (R03h)  
-  ili9328Command(ILI9328_COMMANDS_DISPLAYCONTROL2, 0x0302);
-  ili9328Command(ILI9328_COMMANDS_DISPLAYCONTROL3, 0x0000);
-  ili9328Command(ILI9328_COMMANDS_DISPLAYCONTROL4, 0x0000);       // Fmark On
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL1, 0x0000);         // Power Control 1 (R10h)
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL3, 0x0000);         // Power Control 3 (R12h)
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL4, 0x0000);         // Power Control 4 (R13h)
+  lcdBus8Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL1, 0x0100);  // Driver Output Control Register (R01h)
+  lcdBus8Command(ILI9328_COMMANDS_LCDDRIVINGCONTROL, 0x0700);     // LCD Driving Waveform Control (R02h)
+  lcdBus8Command(ILI9328_COMMANDS_ENTRYMODE, 0x1030);             // Entry Mode (R03h)  
+  lcdBus8Command(ILI9328_COMMANDS_DISPLAYCONTROL2, 0x0302);
+  lcdBus8Command(ILI9328_COMMANDS_DISPLAYCONTROL3, 0x0000);
+  lcdBus8Command(ILI9328_COMMANDS_DISPLAYCONTROL4, 0x0000);       // Fmark On
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL1, 0x0000);         // Power Control 1 (R10h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL3, 0x0000);         // Power Control 3 (R12h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL4, 0x0000);         // Power Control 4 (R13h)
   ili9328Delay(1000);  
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL1, 0x14B0);         // Power Control 1 (R10h)  
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL1, 0x14B0);         // Power Control 1 (R10h)  
   ili9328Delay(500);  
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)  
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL2, 0x0007);         // Power Control 2 (R11h)  
   ili9328Delay(500);  
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL3, 0x008E);         // Power Control 3 (R12h)
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL4, 0x0C00);         // Power Control 4 (R13h)
-  ili9328Command(ILI9328_COMMANDS_POWERCONTROL7, 0x0015);         // NVM read data 2 (R29h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL3, 0x008E);         // Power Control 3 (R12h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL4, 0x0C00);         // Power Control 4 (R13h)
+  lcdBus8Command(ILI9328_COMMANDS_POWERCONTROL7, 0x0015);         // NVM read data 2 (R29h)
   ili9328Delay(500);
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL1, 0x0000);         // Gamma Control 1
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL2, 0x0107);         // Gamma Control 2
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL3, 0x0000);         // Gamma Control 3
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL4, 0x0203);         // Gamma Control 4
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL5, 0x0402);         // Gamma Control 5
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL6, 0x0000);         // Gamma Control 6
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL7, 0x0207);         // Gamma Control 7
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL8, 0x0000);         // Gamma Control 8
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL9, 0x0203);         // Gamma Control 9
-  ili9328Command(ILI9328_COMMANDS_GAMMACONTROL10, 0x0403);        // Gamma Control 10
-  ili9328Command(ILI9328_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, 0x0000);                      // Window Horizontal RAM Address Start (R50h)
-  ili9328Command(ILI9328_COMMANDS_HORIZONTALADDRESSENDPOSITION, ili9328Properties.width - 1);   // Window Horizontal RAM Address End (R51h)
-  ili9328Command(ILI9328_COMMANDS_VERTICALADDRESSSTARTPOSITION, 0X0000);                        // Window Vertical RAM Address Start (R52h)
-  ili9328Command(ILI9328_COMMANDS_VERTICALADDRESSENDPOSITION, ili9328Properties.height - 1);    // Window Vertical RAM Address End (R53h)
-  ili9328Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL2, 0xa700);    // Driver Output Control (R60h)
-  ili9328Command(ILI9328_COMMANDS_BASEIMAGEDISPLAYCONTROL, 0x0003); // Driver Output Control (R61h) - enable VLE
-  ili9328Command(ILI9328_COMMANDS_PANELINTERFACECONTROL1, 0X0010);  // Panel Interface Control 1 (R90h)
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL1, 0x0000);         // Gamma Control 1
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL2, 0x0107);         // Gamma Control 2
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL3, 0x0000);         // Gamma Control 3
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL4, 0x0203);         // Gamma Control 4
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL5, 0x0402);         // Gamma Control 5
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL6, 0x0000);         // Gamma Control 6
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL7, 0x0207);         // Gamma Control 7
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL8, 0x0000);         // Gamma Control 8
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL9, 0x0203);         // Gamma Control 9
+  lcdBus8Command(ILI9328_COMMANDS_GAMMACONTROL10, 0x0403);        // Gamma Control 10
+  lcdBus8Command(ILI9328_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, 0x0000);                      // Window Horizontal RAM Address Start (R50h)
+  lcdBus8Command(ILI9328_COMMANDS_HORIZONTALADDRESSENDPOSITION, ili9328Properties.width - 1);   // Window Horizontal RAM Address End (R51h)
+  lcdBus8Command(ILI9328_COMMANDS_VERTICALADDRESSSTARTPOSITION, 0X0000);                        // Window Vertical RAM Address Start (R52h)
+  lcdBus8Command(ILI9328_COMMANDS_VERTICALADDRESSENDPOSITION, ili9328Properties.height - 1);    // Window Vertical RAM Address End (R53h)
+  lcdBus8Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL2, 0xa700);    // Driver Output Control (R60h)
+  lcdBus8Command(ILI9328_COMMANDS_BASEIMAGEDISPLAYCONTROL, 0x0003); // Driver Output Control (R61h) - enable VLE
+  lcdBus8Command(ILI9328_COMMANDS_PANELINTERFACECONTROL1, 0X0010);  // Panel Interface Control 1 (R90h)
 
   // Display On
-  ili9328Command(ILI9328_COMMANDS_DISPLAYCONTROL1, 0x0133);     // Display Control (R07h)
+  lcdBus8Command(ILI9328_COMMANDS_DISPLAYCONTROL1, 0x0133);     // Display Control (R07h)
   ili9328Delay(500);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);
+  lcdBus8WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);
 }
 
 /**************************************************************************/
@@ -275,7 +179,6 @@ void ili9328InitDisplay(void)
 void ili9328Home(void)
 {
   ili9328SetCursor(0, 0);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);            // Write Data to GRAM (R22h)
 }
 
 /**************************************************************************/
@@ -285,10 +188,21 @@ void ili9328Home(void)
 /**************************************************************************/
 void ili9328SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
-  ili9328Command(ILI9328_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, x0);
-  ili9328Command(ILI9328_COMMANDS_HORIZONTALADDRESSENDPOSITION, x1);
-  ili9328Command(ILI9328_COMMANDS_VERTICALADDRESSSTARTPOSITION, y0);
-  ili9328Command(ILI9328_COMMANDS_VERTICALADDRESSENDPOSITION, y1);
+  uint16_t h0 = x0, h1 = x1, v0 = y0, v1 = y1;
+
+  // The window is set in GRAM co-ordinates, so swap the axes in landscape
+  if ((lcdOrientation == LCD_ORIENTATION_LANDSCAPE) || (lcdOrientation == LCD_ORIENTATION_LANDSCAPE_INVERTED))
+  {
+    h0 = y0;
+    h1 = y1;
+    v0 = x0;
+    v1 = x1;
+  }
+
+  lcdBus8Command(ILI9328_COMMANDS_HORIZONTALADDRESSSTARTPOSITION, h0);
+  lcdBus8Command(ILI9328_COMMANDS_HORIZONTALADDRESSENDPOSITION, h1);
+  lcdBus8Command(ILI9328_COMMANDS_VERTICALADDRESSSTARTPOSITION, v0);
+  lcdBus8Command(ILI9328_COMMANDS_VERTICALADDRESSENDPOSITION, v1);
   ili9328SetCursor(x0, y0);
 }
 
@@ -303,27 +217,8 @@ void ili9328SetWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 /**************************************************************************/
 void lcdInit(void)
 {
-  // Set control line pins to output
-  gpioSetDir(ILI9328_CS_PORT, ILI9328_CS_PIN, 1);
-  gpioSetDir(ILI9328_CD_PORT, ILI9328_CD_PIN, 1);
-  gpioSetDir(ILI9328_WR_PORT, ILI9328_WR_PIN, 1);
-  gpioSetDir(ILI9328_RD_PORT, ILI9328_RD_PIN, 1);
-  
-  // Set data port pins to output
-  ILI9328_GPIO2DATA_SETOUTPUT;
-
-  // Disable pullups
-  ILI9328_DISABLEPULLUPS();
-  
-  // Set backlight pin to output and turn it on
-  gpioSetDir(ILI9328_BL_PORT, ILI9328_BL_PIN, 1);      // set to output
-  lcdBacklight(TRUE);
-
-  // Set reset pin to output
-  gpioSetDir(ILI9328_RES_PORT, ILI9328_RES_PIN, 1);    // Set to output
-  gpioSetValue(ILI9328_RES_PORT, ILI9328_RES_PIN, 0);  // Low to reset
-  systickDelay(50);
-  gpioSetValue(ILI9328_RES_PORT, ILI9328_RES_PIN, 1);  // High to exit
+  // Configure the bus pins, turn the backlight on and reset the LCD
+  lcdBus8Init();
 
   // Initialize the display
   ili9328InitDisplay();
@@ -348,7 +243,7 @@ void lcdInit(void)
 void lcdBacklight(bool state)
 {
   // Set the backlight
-  gpioSetValue(ILI9328_BL_PORT, ILI9328_BL_PIN, state ? 0 : 1);
+  lcdBus8Backlight(state);
 }
 
 /**************************************************************************/
@@ -365,14 +260,14 @@ void lcdTest(void)
   {
     for(j=0;j<240;j++)
     {
-      if(i>279)ili9328WriteData(COLOR_WHITE);
-      else if(i>239)ili9328WriteData(COLOR_BLUE);
-      else if(i>199)ili9328WriteData(COLOR_GREEN);
-      else if(i>159)ili9328WriteData(COLOR_CYAN);
-      else if(i>119)ili9328WriteData(COLOR_RED);
-      else if(i>79)ili9328WriteData(COLOR_MAGENTA);
-      else if(i>39)ili9328WriteData(COLOR_YELLOW);
-      else ili9328WriteData(COLOR_BLACK);
+      if(i>279)lcdBus8WriteData(COLOR_WHITE);
+      else if(i>239)lcdBus8WriteData(COLOR_BLUE);
+      else if(i>199)lcdBus8WriteData(COLOR_GREEN);
+      else if(i>159)lcdBus8WriteData(COLOR_CYAN);
+      else if(i>119)lcdBus8WriteData(COLOR_RED);
+      else if(i>79)lcdBus8WriteData(COLOR_MAGENTA);
+      else if(i>39)lcdBus8WriteData(COLOR_YELLOW);
+      else lcdBus8WriteData(COLOR_BLACK);
     }
   }
 }
@@ -384,14 +279,8 @@ void lcdTest(void)
 /**************************************************************************/
 void lcdFillRGB(uint16_t data)
 {
-  unsigned int i;
   ili9328Home();
-  
-  uint32_t pixels = 320*240;
-  for ( i=0; i < pixels; i++ )
-  {
-    ili9328WriteData(data);
-  } 
+  lcdBus8WriteRepeat(data, 320*240);
 }
 
 /**************************************************************************/
@@ -402,8 +291,7 @@ void lcdFillRGB(uint16_t data)
 void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
   ili9328SetCursor(x, y);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);  // Write Data to GRAM (R22h)
-  ili9328WriteData(color);
+  lcdBus8WriteData(color);
 }
 
 /**************************************************************************/
@@ -414,14 +302,8 @@ void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 /**************************************************************************/
 void lcdDrawPixels(uint16_t x, uint16_t y, uint16_t *data, uint32_t len)
 {
-  uint32_t i = 0;
   ili9328SetCursor(x, y);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);
-  do
-  {
-    ili9328WriteData(data[i]);
-    i++;
-  } while (i<len);
+  lcdBus8WritePixels(data, len);
 }
 
 /**************************************************************************/
@@ -433,7 +315,7 @@ void lcdDrawPixels(uint16_t x, uint16_t y, uint16_t *data, uint32_t len)
 void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
 {
   // Allows for slightly better performance than setting individual pixels
-  uint16_t x, pixels;
+  uint16_t x;
 
   if (x1 < x0)
   {
@@ -454,11 +336,7 @@ void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
   }
 
   ili9328SetCursor(x0, y);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);  // Write Data to GRAM (R22h)
-  for (pixels = 0; pixels < x1 - x0 + 1; pixels++)
-  {
-    ili9328WriteData(color);
-  }
+  lcdBus8WriteRepeat(color, x1 - x0 + 1);
 }
 
 /**************************************************************************/
@@ -469,16 +347,32 @@ void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
 /**************************************************************************/
 void lcdDrawVLine(uint16_t x, uint16_t y0, uint16_t y1, uint16_t color)
 {
-  lcdOrientation_t orientation = lcdOrientation;
+  uint16_t y;
 
-  // Switch orientation
-  lcdSetOrientation(orientation == LCD_ORIENTATION_PORTRAIT ? LCD_ORIENTATION_LANDSCAPE : LCD_ORIENTATION_PORTRAIT);
+  if (y1 < y0)
+  {
+    // Switch y1 and y0
+    y = y1;
+    y1 = y0;
+    y0 = y;
+  }
 
-  // Draw horizontal line like usual
-  lcdDrawHLine(y0, y1, lcdGetHeight() - (x + 1), color);
+  // Check limits
+  if (y1 >= lcdGetHeight())
+  {
+    y1 = lcdGetHeight() - 1;
+  }
+  if (y0 >= lcdGetHeight())
+  {
+    y0 = lcdGetHeight() - 1;
+  }
 
-  // Switch orientation back
-  lcdSetOrientation(orientation);
+  // Toggle the AM bit so that the GRAM address auto-increments along
+  // the y axis, draw the line in one burst, then restore the entry mode
+  lcdBus8Command(ILI9328_COMMANDS_ENTRYMODE, ili9328EntryMode ^ 0x0008);
+  ili9328SetCursor(x, y0);
+  lcdBus8WriteRepeat(color, y1 - y0 + 1);
+  lcdBus8Command(ILI9328_COMMANDS_ENTRYMODE, ili9328EntryMode);
 }
 
 /**************************************************************************/
@@ -491,39 +385,59 @@ uint16_t lcdGetPixel(uint16_t x, uint16_t y)
   uint16_t preFetch = 0;
 
   ili9328SetCursor(x, y);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);
-  preFetch = ili9328ReadData();
+  preFetch = lcdBus8ReadData();
 
   // Eeek ... why does this need to be done twice for a proper value?!?
   ili9328SetCursor(x, y);
-  ili9328WriteCmd(ILI9328_COMMANDS_WRITEDATATOGRAM);
-  return ili9328ReadData();
+  return lcdBus8ReadData();
 }
 
 /**************************************************************************/
 /*! 
-    @brief  Sets the LCD orientation to horizontal and vertical
+    @brief  Sets the LCD orientation (portrait or landscape, either of
+            which can be rotated 180 degrees)
 */
 /**************************************************************************/
 void lcdSetOrientation(lcdOrientation_t orientation)
 {
   uint16_t entryMode = 0x1030;
   uint16_t outputControl = 0x0100;
-
+  uint16_t gateScan = 0xA700;
+
+  // Rotation is handled entirely by the controller:
+  //   Entry Mode (R03h) AM    - GRAM auto-increments horizontally (0) or
+  //                             vertically (1), so bursts always follow
+  //                             the x axis of the current orientation
+  //   Output Control (R01h) SS - Source (horizontal) output direction
+  //   Output Control (R60h) GS - Gate (vertical) scan direction
   switch (orientation)
   {
     case LCD_ORIENTATION_PORTRAIT:
       entryMode = 0x1030;
       outputControl = 0x0100;
+      gateScan = 0xA700;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
-      entryMode = 0x1028;
+      entryMode = 0x1038;
       outputControl = 0x0000;
+      gateScan = 0xA700;
+      break;
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
+      entryMode = 0x1030;
+      outputControl = 0x0000;
+      gateScan = 0x2700;
+      break;
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+      entryMode = 0x1038;
+      outputControl = 0x0100;
+      gateScan = 0x2700;
       break;
   }
 
-  ili9328Command(ILI9328_COMMANDS_ENTRYMODE, entryMode);
-  ili9328Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL1, outputControl);
+  lcdBus8Command(ILI9328_COMMANDS_ENTRYMODE, entryMode);
+  lcdBus8Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL1, outputControl);
+  lcdBus8Command(ILI9328_COMMANDS_DRIVEROUTPUTCONTROL2, gateScan);
+  ili9328EntryMode = entryMode;
   lcdOrientation = orientation;
 
   ili9328SetCursor(0, 0);
@@ -531,7 +445,7 @@ void lcdSetOrientation(lcdOrientation_t orientation)
 
 /**************************************************************************/
 /*! 
-    @brief  Gets the current screen orientation (horizontal or vertical)
+    @brief  Gets the current screen orientation
 */
 /**************************************************************************/
 lcdOrientation_t lcdGetOrientation(void)
@@ -550,9 +464,11 @@ uint16_t lcdGetWidth(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return ili9328Properties.width;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return ili9328Properties.height;
   }
@@ -569,9 +485,11 @@ uint16_t lcdGetHeight(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return ili9328Properties.height;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return ili9328Properties.width;
   }
@@ -590,8 +508,8 @@ void lcdScroll(int16_t pixels, uint16_t fillColor)
     y += 320;
   while (y >= 320)
     y -= 320;
-  ili9328WriteCmd(ILI9328_COMMANDS_VERTICALSCROLLCONTROL);
-  ili9328WriteData(y);
+  lcdBus8WriteCmd(ILI9328_COMMANDS_VERTICALSCROLLCONTROL);
+  lcdBus8WriteData(y);
 }
 
 /**************************************************************************/
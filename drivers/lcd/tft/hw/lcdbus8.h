@@ -0,0 +1,376 @@
+/**************************************************************************/
+/*! 
+    @file     lcdbus8.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section  DESCRIPTION
+
+    Shared 8-bit parallel bus (8080-style) used by the ILI9325, ILI9328
+    and ST7783 drivers.  Everything is static inline so that the bus
+    writes are inlined into the drivers' pixel loops.
+
+    Controller specific timing and registers can be set by defining
+    the LCDBUS8_* settings below before this file is included.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#ifndef __LCDBUS8_H__
+#define __LCDBUS8_H__
+
+#include "projectconfig.h"
+
+#include "core/gpio/gpio.h"
+#include "core/systick/systick.h"
+
+// Read strobe timing in nS (see the AC characteristics in the datasheet)
+#ifndef LCDBUS8_RD_LOW_NS
+  #define LCDBUS8_RD_LOW_NS       (355)   // RD low pulse width (read access time)
+#endif
+#ifndef LCDBUS8_RD_HIGH_NS
+  #define LCDBUS8_RD_HIGH_NS      (90)    // RD high pulse width
+#endif
+
+// GRAM address and data registers
+#ifndef LCDBUS8_REG_GRAMX
+  #define LCDBUS8_REG_GRAMX       (0x0020)
+#endif
+#ifndef LCDBUS8_REG_GRAMY
+  #define LCDBUS8_REG_GRAMY       (0x0021)
+#endif
+#ifndef LCDBUS8_REG_GRAMDATA
+  #define LCDBUS8_REG_GRAMDATA    (0x0022)
+#endif
+
+// Converts nS to lcdBus8Delay() loops at CFG_CPU_CCLK, rounding up (each
+// loop takes at least 3 cycles, so the delay is never shorter than asked)
+#define LCDBUS8_NS_TO_LOOPS(ns)   ((((ns) * (CFG_CPU_CCLK / 1000000)) / 1000) / 3 + 1)
+
+// Control pins
+#define LCDBUS8_CS_PORT           1     // CS (LCD Pin 7)
+#define LCDBUS8_CS_PIN            8
+#define LCDBUS8_CD_PORT           1     // CS/RS (LCD Pin 8)
+#define LCDBUS8_CD_PIN            9
+#define LCDBUS8_WR_PORT           1     // WR (LCD Pin 9)
+#define LCDBUS8_WR_PIN            10
+#define LCDBUS8_RD_PORT           1     // RD (LCD Pin 10)
+#define LCDBUS8_RD_PIN            11
+
+// These combined pin definitions are for optimisation purposes.
+// If the pin values above are modified the bit equivalents
+// below will also need to be updated
+#define LCDBUS8_CS_CD_PINS        0x300   // 8 + 9
+#define LCDBUS8_RD_WR_PINS        0xC00   // 11 + 10
+#define LCDBUS8_WR_CS_PINS        0x500   // 10 + 8
+#define LCDBUS8_CD_RD_WR_PINS     0xE00   // 9 + 11 + 10
+#define LCDBUS8_CS_CD_RD_WR_PINS  0xF00   // 8 + 9 + 11 + 10
+
+// Backlight and Reset pins
+#define LCDBUS8_RES_PORT          3     // LCD Reset  (LCD Pin 31)
+#define LCDBUS8_RES_PIN           3
+#define LCDBUS8_BL_PORT           2     // Backlight Enable (LCD Pin 16)
+#define LCDBUS8_BL_PIN            9
+
+// Data pins
+// Note: data pins must be consecutive and on the same port
+#define LCDBUS8_DATA_PORT         2     // 8-Pin Data Port
+#define LCDBUS8_DATA_PIN1         1
+#define LCDBUS8_DATA_PIN2         2
+#define LCDBUS8_DATA_PIN3         3
+#define LCDBUS8_DATA_PIN4         4
+#define LCDBUS8_DATA_PIN5         5
+#define LCDBUS8_DATA_PIN6         6
+#define LCDBUS8_DATA_PIN7         7
+#define LCDBUS8_DATA_PIN8         8
+#define LCDBUS8_DATA_MASK         0x000001FE
+#define LCDBUS8_DATA_OFFSET       1    // Offset = PIN1
+
+// Placed here to try to keep all pin specific values in header file
+#define LCDBUS8_DISABLEPULLUPS() do { gpioSetPullup(&IOCON_PIO2_1, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_2, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_3, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_4, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_5, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_6, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_7, gpioPullupMode_Inactive); \
+                                      gpioSetPullup(&IOCON_PIO2_8, gpioPullupMode_Inactive); } while (0)
+
+// These registers allow fast single operation clear+set of bits (see section 8.5.1 of LPC1343 UM)
+#define LCDBUS8_GPIO2DATA_DATA        (*(pREG32 (GPIO_GPIO2_BASE + (LCDBUS8_DATA_MASK << 2))))
+#define LCDBUS8_GPIO1DATA_WR          (*(pREG32 (GPIO_GPIO1_BASE + ((1 << LCDBUS8_WR_PIN) << 2))))
+#define LCDBUS8_GPIO1DATA_CD          (*(pREG32 (GPIO_GPIO1_BASE + ((1 << LCDBUS8_CD_PIN) << 2))))
+#define LCDBUS8_GPIO1DATA_CS          (*(pREG32 (GPIO_GPIO1_BASE + ((1 << LCDBUS8_CS_PIN) << 2))))
+#define LCDBUS8_GPIO1DATA_RD          (*(pREG32 (GPIO_GPIO1_BASE + ((1 << LCDBUS8_RD_PIN) << 2))))
+#define LCDBUS8_GPIO3DATA_RES         (*(pREG32 (GPIO_GPIO3_BASE + ((1 << LCDBUS8_RES_PIN) << 2))))
+#define LCDBUS8_GPIO1DATA_CS_CD       (*(pREG32 (GPIO_GPIO1_BASE + ((LCDBUS8_CS_CD_PINS) << 2))))
+#define LCDBUS8_GPIO1DATA_RD_WR       (*(pREG32 (GPIO_GPIO1_BASE + ((LCDBUS8_RD_WR_PINS) << 2))))
+#define LCDBUS8_GPIO1DATA_WR_CS       (*(pREG32 (GPIO_GPIO1_BASE + ((LCDBUS8_WR_CS_PINS) << 2))))
+#define LCDBUS8_GPIO1DATA_CD_RD_WR    (*(pREG32 (GPIO_GPIO1_BASE + ((LCDBUS8_CD_RD_WR_PINS) << 2))))
+#define LCDBUS8_GPIO1DATA_CS_CD_RD_WR (*(pREG32 (GPIO_GPIO1_BASE + ((LCDBUS8_CS_CD_RD_WR_PINS) << 2))))
+
+// Macros to set data bus direction to input/output
+#define LCDBUS8_GPIO2DATA_SETINPUT  GPIO_GPIO2DIR &= ~LCDBUS8_DATA_MASK
+#define LCDBUS8_GPIO2DATA_SETOUTPUT GPIO_GPIO2DIR |= LCDBUS8_DATA_MASK
+
+// Macros for control line state
+#define CLR_CD          LCDBUS8_GPIO1DATA_CD = (0)
+#define SET_CD          LCDBUS8_GPIO1DATA_CD = (1 << LCDBUS8_CD_PIN)
+#define CLR_CS          LCDBUS8_GPIO1DATA_CS = (0)
+#define SET_CS          LCDBUS8_GPIO1DATA_CS = (1 << LCDBUS8_CS_PIN)
+#define CLR_WR          LCDBUS8_GPIO1DATA_WR = (0)
+#define SET_WR          LCDBUS8_GPIO1DATA_WR = (1 << LCDBUS8_WR_PIN)
+#define CLR_RD          LCDBUS8_GPIO1DATA_RD = (0)
+#define SET_RD          LCDBUS8_GPIO1DATA_RD = (1 << LCDBUS8_RD_PIN)
+#define CLR_RESET       LCDBUS8_GPIO3DATA_RES = (0)
+#define SET_RESET       LCDBUS8_GPIO3DATA_RES = (1 << LCDBUS8_RES_PIN)
+
+// These 'combined' macros are defined to improve code performance by
+// reducing the number of instructions in heavily used functions
+#define CLR_CS_CD           LCDBUS8_GPIO1DATA_CS_CD = (0);
+#define SET_RD_WR           LCDBUS8_GPIO1DATA_RD_WR = (LCDBUS8_RD_WR_PINS);
+#define SET_WR_CS           LCDBUS8_GPIO1DATA_WR_CS = (LCDBUS8_WR_CS_PINS);
+#define SET_CD_RD_WR        LCDBUS8_GPIO1DATA_CD_RD_WR = (LCDBUS8_CD_RD_WR_PINS);
+#define CLR_CS_CD_SET_RD_WR LCDBUS8_GPIO1DATA_CS_CD_RD_WR = (LCDBUS8_RD_WR_PINS);
+#define CLR_CS_SET_CD_RD_WR LCDBUS8_GPIO1DATA_CS_CD_RD_WR = (LCDBUS8_CD_RD_WR_PINS);
+
+/**************************************************************************/
+/*! 
+    @brief  Busy-waits for the specified number of loops (see
+            LCDBUS8_NS_TO_LOOPS)
+*/
+/**************************************************************************/
+static inline void lcdBus8Delay(uint32_t loops)
+{
+  while (loops--)
+  {
+    __asm volatile ("nop");
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Writes the supplied 16-bit command using an 8-bit interface
+*/
+/**************************************************************************/
+static inline void lcdBus8WriteCmd(uint16_t command)
+{
+  // Compiled with -Os on GCC 4.4 this works out to 25 cycles
+  // (versus 36 compiled with no optimisations).  I'm not sure it
+  // can be improved further, so that means 25 cycles/350nS for
+  // continuous writes (cmd, data, data, data, ...) or ~150 cycles/
+  // ~2.1uS for a random pixel (Set X [cmd+data], Set Y [cmd+data],
+  // Set color [cmd+data]) (times assumes 72MHz clock).
+
+  CLR_CS_CD_SET_RD_WR;  // Saves 18 commands compared to "CLR_CS; CLR_CD; SET_RD; SET_WR;" 
+  LCDBUS8_GPIO2DATA_DATA = (command >> (8 - LCDBUS8_DATA_OFFSET));
+  CLR_WR;
+  SET_WR;
+  LCDBUS8_GPIO2DATA_DATA = command << LCDBUS8_DATA_OFFSET;
+  CLR_WR;
+  SET_WR_CS;            // Saves 7 commands compared to "SET_WR; SET_CS;"
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Writes the supplied 16-bit data using an 8-bit interface
+*/
+/**************************************************************************/
+static inline void lcdBus8WriteData(uint16_t data)
+{
+  CLR_CS_SET_CD_RD_WR;  // Saves 18 commands compared to SET_CD; SET_RD; SET_WR; CLR_CS"
+  LCDBUS8_GPIO2DATA_DATA = (data >> (8 - LCDBUS8_DATA_OFFSET));
+  CLR_WR;
+  SET_WR;
+  LCDBUS8_GPIO2DATA_DATA = data << LCDBUS8_DATA_OFFSET;
+  CLR_WR;
+  SET_WR_CS;            // Saves 7 commands compared to "SET_WR, SET_CS;"
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Writes the same 16-bit value 'count' times, keeping CS
+            asserted for the whole burst
+
+    When the high and low bytes are identical (ex. black or white)
+    the data lines are only set once and only WR is strobed.
+*/
+/**************************************************************************/
+static inline void lcdBus8WriteRepeat(uint16_t data, uint32_t count)
+{
+  uint32_t high = data >> (8 - LCDBUS8_DATA_OFFSET);
+  uint32_t low = data << LCDBUS8_DATA_OFFSET;
+
+  CLR_CS_SET_CD_RD_WR;
+  if ((data >> 8) == (data & 0xFF))
+  {
+    LCDBUS8_GPIO2DATA_DATA = low;
+    while (count--)
+    {
+      CLR_WR;
+      SET_WR;
+      CLR_WR;
+      SET_WR;
+    }
+  }
+  else
+  {
+    while (count--)
+    {
+      LCDBUS8_GPIO2DATA_DATA = high;
+      CLR_WR;
+      SET_WR;
+      LCDBUS8_GPIO2DATA_DATA = low;
+      CLR_WR;
+      SET_WR;
+    }
+  }
+  SET_CS;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Writes an array of 16-bit values, keeping CS asserted for
+            the whole burst
+*/
+/**************************************************************************/
+static inline void lcdBus8WritePixels(const uint16_t *data, uint32_t len)
+{
+  CLR_CS_SET_CD_RD_WR;
+  while (len--)
+  {
+    LCDBUS8_GPIO2DATA_DATA = (*data >> (8 - LCDBUS8_DATA_OFFSET));
+    CLR_WR;
+    SET_WR;
+    LCDBUS8_GPIO2DATA_DATA = *data++ << LCDBUS8_DATA_OFFSET;
+    CLR_WR;
+    SET_WR;
+  }
+  SET_CS;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Reads a 16-bit value from the 8-bit data bus
+
+    The RD strobe is held for LCDBUS8_RD_LOW_NS/LCDBUS8_RD_HIGH_NS,
+    calibrated against CFG_CPU_CCLK.
+*/
+/**************************************************************************/
+static inline uint16_t lcdBus8ReadData(void)
+{
+  uint16_t high, low;
+
+  SET_CD_RD_WR;   // Saves 14 commands compared to "SET_CD; SET_RD; SET_WR"
+  CLR_CS;
+  LCDBUS8_GPIO2DATA_SETINPUT;
+
+  CLR_RD;
+  lcdBus8Delay(LCDBUS8_NS_TO_LOOPS(LCDBUS8_RD_LOW_NS));
+  high = (LCDBUS8_GPIO2DATA_DATA >> LCDBUS8_DATA_OFFSET) & 0xFF;
+  SET_RD;
+  lcdBus8Delay(LCDBUS8_NS_TO_LOOPS(LCDBUS8_RD_HIGH_NS));
+
+  CLR_RD;
+  lcdBus8Delay(LCDBUS8_NS_TO_LOOPS(LCDBUS8_RD_LOW_NS));
+  low = (LCDBUS8_GPIO2DATA_DATA >> LCDBUS8_DATA_OFFSET) & 0xFF;
+  SET_RD;
+
+  SET_CS;
+  LCDBUS8_GPIO2DATA_SETOUTPUT;
+
+  return (high << 8) | low;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sends a 16-bit command + 16-bit data
+*/
+/**************************************************************************/
+static inline void lcdBus8Command(uint16_t command, uint16_t data)
+{
+  lcdBus8WriteCmd(command);
+  lcdBus8WriteData(data);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Sets the GRAM address (in GRAM, not screen, co-ordinates)
+            and selects the GRAM data register for writing or reading
+*/
+/**************************************************************************/
+static inline void lcdBus8SetCursor(uint16_t gramX, uint16_t gramY)
+{
+  lcdBus8Command(LCDBUS8_REG_GRAMX, gramX);
+  lcdBus8Command(LCDBUS8_REG_GRAMY, gramY);
+  lcdBus8WriteCmd(LCDBUS8_REG_GRAMDATA);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Enables or disables the LCD backlight
+*/
+/**************************************************************************/
+static inline void lcdBus8Backlight(bool state)
+{
+  gpioSetValue(LCDBUS8_BL_PORT, LCDBUS8_BL_PIN, state ? 0 : 1);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Configures the bus pins, turns the backlight on and
+            pulses the LCD's reset line
+*/
+/**************************************************************************/
+static inline void lcdBus8Init(void)
+{
+  // Set control line pins to output
+  gpioSetDir(LCDBUS8_CS_PORT, LCDBUS8_CS_PIN, 1);
+  gpioSetDir(LCDBUS8_CD_PORT, LCDBUS8_CD_PIN, 1);
+  gpioSetDir(LCDBUS8_WR_PORT, LCDBUS8_WR_PIN, 1);
+  gpioSetDir(LCDBUS8_RD_PORT, LCDBUS8_RD_PIN, 1);
+  
+  // Set data port pins to output
+  LCDBUS8_GPIO2DATA_SETOUTPUT;
+
+  // Disable pullups
+  LCDBUS8_DISABLEPULLUPS();
+  
+  // Set backlight pin to output and turn it on
+  gpioSetDir(LCDBUS8_BL_PORT, LCDBUS8_BL_PIN, 1);      // set to output
+  lcdBus8Backlight(TRUE);
+
+  // Set reset pin to output
+  gpioSetDir(LCDBUS8_RES_PORT, LCDBUS8_RES_PIN, 1);    // Set to output
+  gpioSetValue(LCDBUS8_RES_PORT, LCDBUS8_RES_PIN, 0);  // Low to reset
+  systickDelay(50);
+  gpioSetValue(LCDBUS8_RES_PORT, LCDBUS8_RES_PIN, 1);  // High to exit
+}
+
+#endif
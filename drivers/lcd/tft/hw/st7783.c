@@ -49,6 +49,7 @@
 
 static lcdOrientation_t lcdOrientation = LCD_ORIENTATION_PORTRAIT;
 static lcdProperties_t st7783Properties = { 240, 320, TRUE, TRUE, FALSE };
+static uint16_t st7783EntryMode = 0x1030;
 
 /*************************************************/
 /* Private Methods                               */
@@ -65,130 +66,44 @@ void st7783Delay(unsigned int t)
   }
 }
 
-/*************************************************/
-void st7783WriteCmd(uint16_t command) 
-{
-  // Compiled with -Os on GCC 4.4 this works out to 25 cycles
-  // (versus 36 compiled with no optimisations).  I'm not sure it
-  // can be improved further, so that means 25 cycles/350nS for
-  // continuous writes (cmd, data, data, data, ...) or ~150 cycles/
-  // ~2.1uS for a random pixel (Set X [cmd+data], Set Y [cmd+data],
-  // Set color [cmd+data]) (times assumes 72MHz clock).
-
-  CLR_CS_CD_SET_RD_WR;  // Saves 18 commands compared to "CLR_CS; CLR_CD; SET_RD; SET_WR;" 
-  ST7783_GPIO2DATA_DATA = (command >> (8 - ST7783_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ST7783_GPIO2DATA_DATA = command << ST7783_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR; SET_CS;"
-}
-
-/*************************************************/
-void st7783WriteData(uint16_t data)
-{
-  CLR_CS_SET_CD_RD_WR;  // Saves 18 commands compared to SET_CD; SET_RD; SET_WR; CLR_CS"
-  ST7783_GPIO2DATA_DATA = (data >> (8 - ST7783_DATA_OFFSET));
-  CLR_WR;
-  SET_WR;
-  ST7783_GPIO2DATA_DATA = data << ST7783_DATA_OFFSET;
-  CLR_WR;
-  SET_WR_CS;            // Saves 7 commands compared to "SET_WR, SET_CS;"
-}
-
-/*************************************************/
-uint16_t st7783ReadData(void)
-{
-  // ToDo: Optimise this method!
-
-  uint16_t high, low;
-  high = low = 0;
-  uint16_t d;
-
-  SET_CD_RD_WR;   // Saves 14 commands compared to "SET_CD; SET_RD; SET_WR"
-  CLR_CS;
-  
-  // set inputs
-  ST7783_GPIO2DATA_SETINPUT;
-  CLR_RD;
-  st7783Delay(100);
-  high = ST7783_GPIO2DATA_DATA;  
-  high >>= ST7783_DATA_OFFSET;
-  high &= 0xFF;
-  SET_RD;
-  
-  CLR_RD;
-  st7783Delay(100);
-  low = ST7783_GPIO2DATA_DATA;
-  low >>= ST7783_DATA_OFFSET;
-  low &=0xFF;
-  SET_RD;
-  
-  SET_CS;
-  ST7783_GPIO2DATA_SETOUTPUT;
-
-  d = high;
-  d <<= 8;
-  d |= low;
-  
-  return d;
-}
-
-/*************************************************/
-uint16_t st7783Read(uint16_t addr)
-{
-  st7783WriteCmd(addr);
-  return st7783ReadData();
-}
-
-/*************************************************/
-void st7783Command(uint16_t command, uint16_t data)
-{
-  st7783WriteCmd(command);
-  st7783WriteData(data);
-}
-
 /*************************************************/
 /* Returns the 4-hexdigit controller code        */
 /*************************************************/
 uint16_t st7783Type(void)
 {
-  st7783WriteCmd(0x0);
-  return st7783ReadData();
+  lcdBus8WriteCmd(0x0);
+  return lcdBus8ReadData();
 }
 
 /*************************************************/
 void st7783SetCursor(uint16_t x, uint16_t y)
 {
-  uint16_t he, ve, al, ah;
+  uint16_t al, ah;
   
+  // GRAM is always addressed in portrait co-ordinates, with the panel
+  // rotation handled by the SS/GS bits (see lcdSetOrientation)
   switch (lcdOrientation) 
   {
   case LCD_ORIENTATION_LANDSCAPE:
-          he = st7783Properties.width-1-y;
-          ve = st7783Properties.height-1-x;
+  case LCD_ORIENTATION_LANDSCAPE_INVERTED:
           al = y;
           ah = x;
           break;
   case LCD_ORIENTATION_PORTRAIT:
+  case LCD_ORIENTATION_PORTRAIT_INVERTED:
   default:
-          he = st7783Properties.width-1;
-          ve = st7783Properties.height-1;
           al = x;
           ah = y;
           break;
   }
-  st7783Command(0x0051, he);
-  st7783Command(0x0053, ve);
-  st7783Command(0x0020, al);
-  st7783Command(0x0021, ah);
+  lcdBus8SetCursor(al, ah);     // Also selects the GRAM data register (R22h)
 }
 
 /*************************************************/
 void st7783InitDisplay(void)
 {
   // Clear data line
-  GPIO_GPIO2DATA &= ~ST7783_DATA_MASK;
+  GPIO_GPIO2DATA &= ~LCDBUS8_DATA_MASK;
     
   SET_RD;
   SET_WR;
@@ -201,72 +116,71 @@ void st7783InitDisplay(void)
   SET_RESET;
   st7783Delay(500);
 
-  st7783Command(0x00FF, 0x0001);
-  st7783Command(0x00F3, 0x0008);
-  st7783WriteCmd(0x00F3);
-
-  st7783Command(0x0001, 0x0100);     // Driver Output Control Register (R01h)
-  st7783Command(0x0002, 0x0700);     // LCD Driving Waveform Control (R02h)
-  st7783Command(0x0003, 0x1030);     // Entry Mode (R03h)  
-  st7783Command(0x0008, 0x0302);
-  st7783Command(0x0009, 0x0000);
-  st7783Command(0x0010, 0x0000);     // Power Control 1 (R10h)
-  st7783Command(0x0011, 0x0007);     // Power Control 2 (R11h)  
-  st7783Command(0x0012, 0x0000);     // Power Control 3 (R12h)
-  st7783Command(0x0013, 0x0000);     // Power Control 4 (R13h)
+  lcdBus8Command(0x00FF, 0x0001);
+  lcdBus8Command(0x00F3, 0x0008);
+  lcdBus8WriteCmd(0x00F3);
+
+  lcdBus8Command(0x0001, 0x0100);     // Driver Output Control Register (R01h)
+  lcdBus8Command(0x0002, 0x0700);     // LCD Driving Waveform Control (R02h)
+  lcdBus8Command(0x0003, 0x1030);     // Entry Mode (R03h)  
+  lcdBus8Command(0x0008, 0x0302);
+  lcdBus8Command(0x0009, 0x0000);
+  lcdBus8Command(0x0010, 0x0000);     // Power Control 1 (R10h)
+  lcdBus8Command(0x0011, 0x0007);     // Power Control 2 (R11h)  
+  lcdBus8Command(0x0012, 0x0000);     // Power Control 3 (R12h)
+  lcdBus8Command(0x0013, 0x0000);     // Power Control 4 (R13h)
   st7783Delay(1000);  
-  st7783Command(0x0010, 0x14B0);     // Power Control 1 (R10h)  
+  lcdBus8Command(0x0010, 0x14B0);     // Power Control 1 (R10h)  
   st7783Delay(500);  
-  st7783Command(0x0011, 0x0007);     // Power Control 2 (R11h)  
+  lcdBus8Command(0x0011, 0x0007);     // Power Control 2 (R11h)  
   st7783Delay(500);  
-  st7783Command(0x0012, 0x008E);     // Power Control 3 (R12h)
-  st7783Command(0x0013, 0x0C00);     // Power Control 4 (R13h)
-  st7783Command(0x0029, 0x0015);     // NVM read data 2 (R29h)
+  lcdBus8Command(0x0012, 0x008E);     // Power Control 3 (R12h)
+  lcdBus8Command(0x0013, 0x0C00);     // Power Control 4 (R13h)
+  lcdBus8Command(0x0029, 0x0015);     // NVM read data 2 (R29h)
   st7783Delay(500);
-  st7783Command(0x0030, 0x0000);     // Gamma Control 1
-  st7783Command(0x0031, 0x0107);     // Gamma Control 2
-  st7783Command(0x0032, 0x0000);     // Gamma Control 3
-  st7783Command(0x0035, 0x0203);     // Gamma Control 6
-  st7783Command(0x0036, 0x0402);     // Gamma Control 7
-  st7783Command(0x0037, 0x0000);     // Gamma Control 8
-  st7783Command(0x0038, 0x0207);     // Gamma Control 9
-  st7783Command(0x0039, 0x0000);     // Gamma Control 10
-  st7783Command(0x003C, 0x0203);     // Gamma Control 13
-  st7783Command(0x003D, 0x0403);     // Gamma Control 14
-  st7783Command(0x0050, 0x0000);     // Window Horizontal RAM Address Start (R50h)
-  st7783Command(0x0051, st7783Properties.width - 1);    // Window Horizontal RAM Address End (R51h)
-  st7783Command(0x0052, 0X0000);     // Window Vertical RAM Address Start (R52h)
-  st7783Command(0x0053, st7783Properties.height - 1);    // Window Vertical RAM Address End (R53h)
-  st7783Command(0x0060, 0xa700);     // Driver Output Control (R60h)
-  st7783Command(0x0061, 0x0001);     // Driver Output Control (R61h)
-  st7783Command(0x0090, 0X0029);     // Panel Interface Control 1 (R90h)
+  lcdBus8Command(0x0030, 0x0000);     // Gamma Control 1
+  lcdBus8Command(0x0031, 0x0107);     // Gamma Control 2
+  lcdBus8Command(0x0032, 0x0000);     // Gamma Control 3
+  lcdBus8Command(0x0035, 0x0203);     // Gamma Control 6
+  lcdBus8Command(0x0036, 0x0402);     // Gamma Control 7
+  lcdBus8Command(0x0037, 0x0000);     // Gamma Control 8
+  lcdBus8Command(0x0038, 0x0207);     // Gamma Control 9
+  lcdBus8Command(0x0039, 0x0000);     // Gamma Control 10
+  lcdBus8Command(0x003C, 0x0203);     // Gamma Control 13
+  lcdBus8Command(0x003D, 0x0403);     // Gamma Control 14
+  lcdBus8Command(0x0050, 0x0000);     // Window Horizontal RAM Address Start (R50h)
+  lcdBus8Command(0x0051, st7783Properties.width - 1);    // Window Horizontal RAM Address End (R51h)
+  lcdBus8Command(0x0052, 0X0000);     // Window Vertical RAM Address Start (R52h)
+  lcdBus8Command(0x0053, st7783Properties.height - 1);    // Window Vertical RAM Address End (R53h)
+  lcdBus8Command(0x0060, 0xa700);     // Driver Output Control (R60h)
+  lcdBus8Command(0x0061, 0x0001);     // Driver Output Control (R61h)
+  lcdBus8Command(0x0090, 0X0029);     // Panel Interface Control 1 (R90h)
 
   // Display On
-  st7783Command(0x0007, 0x0133);     // Display Control (R07h)
+  lcdBus8Command(0x0007, 0x0133);     // Display Control (R07h)
   st7783Delay(500);
-  st7783WriteCmd(0x0022);
+  lcdBus8WriteCmd(0x0022);
 }
 
 /*************************************************/
 void st7783Home(void)
 {
   st7783SetCursor(0, 0);
-  st7783WriteCmd(0x0022);            // Write Data to GRAM (R22h)
 }
 
 /*************************************************/
 void st7783SetWindow(uint16_t x, uint16_t y, uint16_t height, uint16_t width)
 {
   // Window horizontal RAM address start
-  if (x >= height) st7783Command(0x50, (x - height + 1));
-  else st7783Command(0x50, 0);
+  if (x >= height) lcdBus8Command(0x50, (x - height + 1));
+  else lcdBus8Command(0x50, 0);
   // Window horizontal GRAM address end
-  st7783Command(0x51, x);
+  lcdBus8Command(0x51, x);
   // Window vertical GRAM address start
-  if (y >= width) st7783Command(0x52, (y - width + 1));
-  else st7783Command(0x52, 0);
+  if (y >= width) lcdBus8Command(0x52, (y - width + 1));
+  else lcdBus8Command(0x52, 0);
   // Window vertical GRAM address end
-  st7783Command(0x53, y);
+  lcdBus8Command(0x53, y);
 
   st7783SetCursor(x, y);
 }
@@ -278,27 +192,8 @@ void st7783SetWindow(uint16_t x, uint16_t y, uint16_t height, uint16_t width)
 /*************************************************/
 void lcdInit(void)
 {
-  // Set control line pins to output
-  gpioSetDir(ST7783_CS_PORT, ST7783_CS_PIN, 1);
-  gpioSetDir(ST7783_CD_PORT, ST7783_CD_PIN, 1);
-  gpioSetDir(ST7783_WR_PORT, ST7783_WR_PIN, 1);
-  gpioSetDir(ST7783_RD_PORT, ST7783_RD_PIN, 1);
-  
-  // Set data port pins to output
-  ST7783_GPIO2DATA_SETOUTPUT;
-
-  // Disable pullups
-  ST7783_DISABLEPULLUPS();
-  
-  // Set backlight pin to output and turn it on
-  gpioSetDir(ST7783_BL_PORT, ST7783_BL_PIN, 1);      // set to output
-  lcdBacklight(TRUE);
-
-  // Set reset pin to output
-  gpioSetDir(ST7783_RES_PORT, ST7783_RES_PIN, 1);    // Set to output
-  gpioSetValue(ST7783_RES_PORT, ST7783_RES_PIN, 0);  // Low to reset
-  systickDelay(50);
-  gpioSetValue(ST7783_RES_PORT, ST7783_RES_PIN, 1);  // High to exit
+  // Configure the bus pins, turn the backlight on and reset the LCD
+  lcdBus8Init();
 
   // Initialize the display
   st7783InitDisplay();
@@ -317,7 +212,7 @@ void lcdInit(void)
 void lcdBacklight(bool state)
 {
   // Set the backlight
-  gpioSetValue(ST7783_BL_PORT, ST7783_BL_PIN, state ? 0 : 1);
+  lcdBus8Backlight(state);
 }
 
 /*************************************************/
@@ -330,14 +225,14 @@ void lcdTest(void)
   {
     for(j=0;j<240;j++)
     {
-      if(i>279)st7783WriteData(COLOR_WHITE);
-      else if(i>239)st7783WriteData(COLOR_BLUE);
-      else if(i>199)st7783WriteData(COLOR_GREEN);
-      else if(i>159)st7783WriteData(COLOR_CYAN);
-      else if(i>119)st7783WriteData(COLOR_RED);
-      else if(i>79)st7783WriteData(COLOR_MAGENTA);
-      else if(i>39)st7783WriteData(COLOR_YELLOW);
-      else st7783WriteData(COLOR_BLACK);
+      if(i>279)lcdBus8WriteData(COLOR_WHITE);
+      else if(i>239)lcdBus8WriteData(COLOR_BLUE);
+      else if(i>199)lcdBus8WriteData(COLOR_GREEN);
+      else if(i>159)lcdBus8WriteData(COLOR_CYAN);
+      else if(i>119)lcdBus8WriteData(COLOR_RED);
+      else if(i>79)lcdBus8WriteData(COLOR_MAGENTA);
+      else if(i>39)lcdBus8WriteData(COLOR_YELLOW);
+      else lcdBus8WriteData(COLOR_BLACK);
     }
   }
 }
@@ -345,22 +240,15 @@ void lcdTest(void)
 /*************************************************/
 void lcdFillRGB(uint16_t data)
 {
-  unsigned int i;
   st7783Home();
-  
-  uint32_t pixels = 320*240;
-  for ( i=0; i < pixels; i++ )
-  {
-    st7783WriteData(data);
-  } 
+  lcdBus8WriteRepeat(data, 320*240);
 }
 
 /*************************************************/
 void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 {
   st7783SetCursor(x, y);
-  st7783WriteCmd(0x0022);  // Write Data to GRAM (R22h)
-  st7783WriteData(color);
+  lcdBus8WriteData(color);
 }
 
 /**************************************************************************/
@@ -371,21 +259,15 @@ void lcdDrawPixel(uint16_t x, uint16_t y, uint16_t color)
 /**************************************************************************/
 void lcdDrawPixels(uint16_t x, uint16_t y, uint16_t *data, uint32_t len)
 {
-  uint32_t i = 0;
   st7783SetCursor(x, y);
-  st7783WriteCmd(0x0022);  // Write Data to GRAM (R22h)
-  do
-  {
-    st7783WriteData(data[i]);
-    i++;
-  } while (i<len);
+  lcdBus8WritePixels(data, len);
 }
 
 /*************************************************/
 void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
 {
   // Allows for slightly better performance than setting individual pixels
-  uint16_t x, pixels;
+  uint16_t x;
 
   if (x1 < x0)
   {
@@ -395,27 +277,39 @@ void lcdDrawHLine(uint16_t x0, uint16_t x1, uint16_t y, uint16_t color)
     x0 = x;
   }
   st7783SetCursor(x0, y);
-  st7783WriteCmd(0x0022);  // Write Data to GRAM (R22h)
-  for (pixels = 0; pixels < x1 - x0 + 1; pixels++)
-  {
-    st7783WriteData(color);
-  }
+  lcdBus8WriteRepeat(color, x1 - x0 + 1);
 }
 
 /*************************************************/
 void lcdDrawVLine(uint16_t x, uint16_t y0, uint16_t y1, uint16_t color)
 {
   // Allows for slightly better performance than setting individual pixels
-  lcdOrientation_t orientation = lcdOrientation;
+  uint16_t y;
 
-  // Switch orientation
-  lcdSetOrientation(orientation == LCD_ORIENTATION_PORTRAIT ? LCD_ORIENTATION_LANDSCAPE : LCD_ORIENTATION_PORTRAIT);
+  if (y1 < y0)
+  {
+    // Switch y1 and y0
+    y = y1;
+    y1 = y0;
+    y0 = y;
+  }
 
-  // Draw horizontal line like usual
-  lcdDrawHLine(y0, y1, lcdGetHeight() - x, color);
+  // Check limits
+  if (y1 >= lcdGetHeight())
+  {
+    y1 = lcdGetHeight() - 1;
+  }
+  if (y0 >= lcdGetHeight())
+  {
+    y0 = lcdGetHeight() - 1;
+  }
 
-  // Switch orientation back
-  lcdSetOrientation(orientation);
+  // Toggle the AM bit so that the GRAM address auto-increments along
+  // the y axis, draw the line in one burst, then restore the entry mode
+  lcdBus8Command(0x0003, st7783EntryMode ^ 0x0008);
+  st7783SetCursor(x, y0);
+  lcdBus8WriteRepeat(color, y1 - y0 + 1);
+  lcdBus8Command(0x0003, st7783EntryMode);
 }
 
 /*************************************************/
@@ -424,31 +318,50 @@ uint16_t lcdGetPixel(uint16_t x, uint16_t y)
   uint16_t preFetch = 0;
 
   st7783SetCursor(x, y);
-  st7783WriteCmd(0x0022);
-  preFetch = st7783ReadData();
+  preFetch = lcdBus8ReadData();
 
   // Eeek ... why does this need to be done twice for a proper value?!?
   st7783SetCursor(x, y);
-  st7783WriteCmd(0x0022);
-  return st7783ReadData();
+  return lcdBus8ReadData();
 }
 
 /*************************************************/
 void lcdSetOrientation(lcdOrientation_t orientation)
 {
   uint16_t entryMode = 0x1030;
+  uint16_t outputControl = 0x0100;
+  uint16_t gateScan = 0xA700;
 
+  // Entry Mode (R03h) AM selects the GRAM auto-increment direction so
+  // that bursts always follow the x axis, while SS (R01h) and GS (R60h)
+  // set the source and gate scan directions to rotate the panel
   switch (orientation)
   {
     case LCD_ORIENTATION_PORTRAIT:
       entryMode = 0x1030;
+      outputControl = 0x0100;
+      gateScan = 0xA700;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
-      entryMode = 0x1028;
+      entryMode = 0x1038;
+      outputControl = 0x0000;
+      gateScan = 0xA700;
+      break;
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
+      entryMode = 0x1030;
+      outputControl = 0x0000;
+      gateScan = 0x2700;
+      break;
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+      entryMode = 0x1038;
+      outputControl = 0x0100;
+      gateScan = 0x2700;
       break;
   }
-  st7783WriteCmd(0x0003);
-  st7783WriteData(entryMode);
+  lcdBus8Command(0x0003, entryMode);       // Entry Mode (R03h)
+  lcdBus8Command(0x0001, outputControl);   // Driver Output Control (R01h)
+  lcdBus8Command(0x0060, gateScan);        // Driver Output Control (R60h)
+  st7783EntryMode = entryMode;
   lcdOrientation = orientation;
   st7783SetCursor(0, 0);
 }
@@ -465,9 +378,11 @@ uint16_t lcdGetWidth(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return st7783Properties.width;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return st7783Properties.height;
   }
@@ -479,9 +394,11 @@ uint16_t lcdGetHeight(void)
   switch (lcdOrientation) 
   {
     case LCD_ORIENTATION_PORTRAIT:
+    case LCD_ORIENTATION_PORTRAIT_INVERTED:
       return st7783Properties.height;
       break;
     case LCD_ORIENTATION_LANDSCAPE:
+    case LCD_ORIENTATION_LANDSCAPE_INVERTED:
     default:
       return st7783Properties.width;
   }
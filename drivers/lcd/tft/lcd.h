@@ -45,10 +45,15 @@
 // initialisation and pixel-setting details to be abstracted away from the
 // higher level drawing and graphics code.
 
+// Each orientation is rotated a further 90 degrees from the previous one.
+// The inverted modes allow panels that are mounted upside down to be used
+// without transforming co-ordinates in software.
 typedef enum 
 {
   LCD_ORIENTATION_PORTRAIT = 0,
-  LCD_ORIENTATION_LANDSCAPE = 1
+  LCD_ORIENTATION_LANDSCAPE = 1,
+  LCD_ORIENTATION_PORTRAIT_INVERTED = 2,    // Portrait rotated 180 degrees
+  LCD_ORIENTATION_LANDSCAPE_INVERTED = 3    // Landscape rotated 180 degrees (270 degrees)
 } lcdOrientation_t;
 
 // This struct is used to indicate the capabilities of different LCDs
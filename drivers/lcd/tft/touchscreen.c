@@ -265,6 +265,7 @@ int setCalibrationMatrix( tsPoint_t * displayPtr, tsPoint_t * screenPtr, tsMatri
     eepromWriteS32(CFG_EEPROM_TOUCHSCREEN_CAL_FN, matrixPtr->Fn);
     eepromWriteS32(CFG_EEPROM_TOUCHSCREEN_CAL_DIVIDER, matrixPtr->Divider);
     eepromWriteU8(CFG_EEPROM_TOUCHSCREEN_CALIBRATED, 1);
+    eepromFlush();
   }
 
   return( retValue ) ;
@@ -303,16 +304,31 @@ int getDisplayPoint( tsPoint_t * displayPtr, tsPoint_t * screenPtr, tsMatrix_t *
     retValue = -1 ;
   }
 
-  // Adjust value if the screen is in landscape mode
+  // Adjust value if the screen is not in the default portrait mode
   lcdOrientation_t orientation;
   orientation = lcdGetOrientation();
-  if (orientation == LCD_ORIENTATION_LANDSCAPE)
+  if (orientation != LCD_ORIENTATION_PORTRAIT)
   {
       uint32_t oldx, oldy;
       oldx = displayPtr->x;
       oldy = displayPtr->y;
-      displayPtr->x = oldy;
-      displayPtr->y = lcdGetHeight() - oldx;
+      switch (orientation)
+      {
+        case LCD_ORIENTATION_LANDSCAPE:
+          displayPtr->x = oldy;
+          displayPtr->y = lcdGetHeight() - oldx;
+          break;
+        case LCD_ORIENTATION_PORTRAIT_INVERTED:
+          displayPtr->x = lcdGetWidth() - oldx;
+          displayPtr->y = lcdGetHeight() - oldy;
+          break;
+        case LCD_ORIENTATION_LANDSCAPE_INVERTED:
+          displayPtr->x = lcdGetWidth() - oldy;
+          displayPtr->y = oldx;
+          break;
+        default:
+          break;
+      }
   }
   
   return( retValue ) ;
@@ -580,6 +596,7 @@ int tsSetThreshhold(uint8_t value)
 
   // Persist to EEPROM
   eepromWriteU8(CFG_EEPROM_TOUCHSCREEN_THRESHHOLD, value);
+  eepromFlush();
 
   return 0;
 }
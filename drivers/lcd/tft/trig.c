@@ -0,0 +1,114 @@
+/**************************************************************************/
+/*! 
+    @file     trig.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#include "trig.h"
+
+/* sin(0..90 degrees) in Q15 ... the other quadrants are mirrored */
+static const uint16_t trigSinTable[91] =
+{
+      0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+   5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+  11207, 11743, 12275, 12803, 13328, 13848, 14365, 14876, 15384, 15886,
+  16384, 16877, 17364, 17847, 18324, 18795, 19261, 19720, 20174, 20622,
+  21063, 21498, 21926, 22348, 22763, 23170, 23571, 23965, 24351, 24730,
+  25102, 25466, 25822, 26170, 26510, 26842, 27166, 27482, 27789, 28088,
+  28378, 28660, 28932, 29197, 29452, 29698, 29935, 30163, 30382, 30592,
+  30792, 30983, 31164, 31336, 31499, 31651, 31795, 31928, 32052, 32166,
+  32270, 32365, 32449, 32524, 32588, 32643, 32688, 32723, 32748, 32763,
+  32768
+};
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the sine of the supplied angle as a Q15 fixed-point
+            value (-TRIG_ONE..TRIG_ONE)
+
+    This is a simple table lookup, so it is safe to call for every
+    span or pixel without pulling in the soft-float libraries.
+
+    @param[in]  degrees
+                Angle in degrees (any value, including negative angles)
+
+    @section Example
+
+    @code 
+
+    // Point 'len' pixels from (x, y) at 'angle' degrees
+    px = x + ((len * trigCos(angle)) >> TRIG_SHIFT);
+    py = y + ((len * trigSin(angle)) >> TRIG_SHIFT);
+
+    @endcode
+*/
+/**************************************************************************/
+int32_t trigSin(int16_t degrees)
+{
+  int16_t a = degrees % 360;
+
+  if (a < 0)
+  {
+    a += 360;
+  }
+
+  if (a <= 90)
+  {
+    return trigSinTable[a];
+  }
+  else if (a <= 180)
+  {
+    return trigSinTable[180 - a];
+  }
+  else if (a <= 270)
+  {
+    return -(int32_t)trigSinTable[a - 180];
+  }
+  else
+  {
+    return -(int32_t)trigSinTable[360 - a];
+  }
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Returns the cosine of the supplied angle as a Q15 fixed-point
+            value (-TRIG_ONE..TRIG_ONE)
+
+    @param[in]  degrees
+                Angle in degrees (any value, including negative angles)
+*/
+/**************************************************************************/
+int32_t trigCos(int16_t degrees)
+{
+  return trigSin((degrees % 360) + 90);
+}
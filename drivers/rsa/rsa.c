@@ -14,14 +14,9 @@
     For details on how to generate a valid RSA key pair, see:
     http://www.microbuilder.eu/Tutorials/SoftwareDevelopment/RSAEncryption.aspx
 
-    @warning  Most versions of libc used for embedded systems do not
-              include support for 64-bit integers with printf, etc. (to
-              keep the compiled code size and memory usage as small as
-              possible).  Unless you have explicitly added long long
-              support for printf, you should not try to display 64-bit
-              values with it (%lld, etc.).  Using 32-bit values (changing
-              the definition of huge_t to uint32_t) will avoid this issue
-              entirely, though at the expense of weaker encryption.
+    @note     64-bit values can be displayed with %lld/%llu when using the
+              printf in core/libc/stdio.c.  Other embedded C libraries
+              often leave out long long support to save code space.
 */
 /**************************************************************************/
 
@@ -80,7 +75,7 @@ void rsaTest()
   #endif
   
   #if CFG_RSA_BITS == 64
-  printf("Starting RSA encryption/decryption test %s", CFG_PRINTF_NEWLINE);
+  printf("d=%llu, e=%llu, n=%llu %s", (unsigned long long)privateKey.d, (unsigned long long)publicKey.e, (unsigned long long)publicKey.n, CFG_PRINTF_NEWLINE);  
   #endif
   #if CFG_RSA_BITS == 32
   printf("d=%u, e=%u, n=%u %s", (unsigned int)privateKey.d, (unsigned int)publicKey.e, (unsigned int)publicKey.n, CFG_PRINTF_NEWLINE);  
@@ -95,7 +90,7 @@ void rsaTest()
     if (rsaOrig == rsaDecrypted)
     {
       #if CFG_RSA_BITS == 64
-      printf("Encrypted and decrypted %d %s", i, CFG_PRINTF_NEWLINE);
+      printf("In=%5llu, Encrypted=%10llu, Out=%5llu (OK) %s", (unsigned long long)rsaOrig, (unsigned long long)rsaEncrypted, (unsigned long long)rsaDecrypted, CFG_PRINTF_NEWLINE);
       #endif
       #if CFG_RSA_BITS == 32
       printf("In=%5u, Encrypted=%5u, Out=%5u (OK) %s", (unsigned int)rsaOrig, (unsigned int)rsaEncrypted, (unsigned int)rsaDecrypted, CFG_PRINTF_NEWLINE);
@@ -104,7 +99,7 @@ void rsaTest()
     else
     {
       #if CFG_RSA_BITS == 64
-      printf("Failed to decrypt %d %s", i, CFG_PRINTF_NEWLINE);
+      printf("In=%5llu, Encrypted=%10llu, Out=%5llu (ERROR) %s", (unsigned long long)rsaOrig, (unsigned long long)rsaEncrypted, (unsigned long long)rsaDecrypted, CFG_PRINTF_NEWLINE);
       #endif
       #if CFG_RSA_BITS == 32
       printf("In=%5u, Encrypted=%5u, Out=%5u (ERROR) %s", (unsigned int)rsaOrig, (unsigned int)rsaEncrypted, (unsigned int)rsaDecrypted, CFG_PRINTF_NEWLINE);
@@ -83,12 +83,6 @@
 
 #include "lm75b.h"
 
-extern volatile uint8_t   I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t   I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t  I2CReadLength, I2CWriteLength;
-
-uint32_t i;
-
 static bool _lm75bInitialised = false;
 
 /**************************************************************************/
@@ -98,18 +92,8 @@ static bool _lm75bInitialised = false;
 /**************************************************************************/
 lm75bError_e lm75bWrite8 (uint8_t reg, uint32_t value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 3;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = LM75B_ADDRESS;             // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  I2CMasterBuffer[2] = (value & 0xFF);            // Value to write
-  i2cEngine();
+  uint8_t data = (value & 0xFF);                 // Value to write
+  i2cWriteReg(LM75B_ADDRESS, reg, 1, &data, 1);
   return LM75B_ERROR_OK;
 }
 
@@ -120,25 +104,14 @@ lm75bError_e lm75bWrite8 (uint8_t reg, uint32_t value)
 /**************************************************************************/
 lm75bError_e lm75bRead16(uint8_t reg, int32_t *value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 2;
-  I2CReadLength = 2;
-  I2CMasterBuffer[0] = LM75B_ADDRESS;             // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  // Append address w/read bit
-  I2CMasterBuffer[2] = LM75B_ADDRESS | LM75B_READBIT;  
-  i2cEngine();
+  uint8_t data[2];
+  i2cReadReg(LM75B_ADDRESS, reg, 1, data, sizeof(data));
 
   // Shift values to create properly formed integer
-  *value = ((I2CSlaveBuffer[0] << 8) | I2CSlaveBuffer[1]) >> 5;
+  *value = ((data[0] << 8) | data[1]) >> 5;
 
   //  Sign extend negative numbers
-  if (I2CSlaveBuffer[0] & 0x80)
+  if (data[0] & 0x80)
   {
     // Negative number
     *value |= 0xFFFFFC00;
@@ -132,7 +132,7 @@ pn532_error_t pn532SendCommand(const byte_t * pbtData, const size_t szData)
   byte_t abtRxBuf[6];
   uart_pcb_t *uart = uartGetPCB();
   systickDelay(10);   // FIXME: How long should we wait for ACK?
-  if (uart->rxfifo.len < 6) 
+  if (ringbufCount(&uart->rxfifo) < 6) 
   {
     // Unable to read ACK
     PN532_DEBUG ("Unable to read ACK%s", CFG_PRINTF_NEWLINE);
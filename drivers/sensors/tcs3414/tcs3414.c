@@ -49,12 +49,6 @@
 #include "tcs3414.h"
 #include "core/systick/systick.h"
 
-extern volatile uint8_t   I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t   I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t  I2CReadLength, I2CWriteLength;
-
-uint32_t i;
-
 static bool _tcs3414Initialised = false;
 
 /**************************************************************************/
@@ -64,17 +58,7 @@ static bool _tcs3414Initialised = false;
 /**************************************************************************/
 tcs3414Error_e tcs3414WriteCmd (uint8_t cmd)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 2;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = TCS3414_ADDRESS;       // I2C device address
-  I2CMasterBuffer[1] = cmd;                   // Command register
-  i2cEngine();
+  i2cWriteReg(TCS3414_ADDRESS, cmd, 1, NULL, 0);          // Command register only
   return TCS3414_ERROR_OK;
 }
 
@@ -85,18 +69,8 @@ tcs3414Error_e tcs3414WriteCmd (uint8_t cmd)
 /**************************************************************************/
 tcs3414Error_e tcs3414Write8 (uint8_t reg, uint32_t value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 3;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = TCS3414_ADDRESS;           // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  I2CMasterBuffer[2] = (value & 0xFF);            // Value to write
-  i2cEngine();
+  uint8_t data = (value & 0xFF);                 // Value to write
+  i2cWriteReg(TCS3414_ADDRESS, reg, 1, &data, 1);
   return TCS3414_ERROR_OK;
 }
 
@@ -107,22 +81,11 @@ tcs3414Error_e tcs3414Write8 (uint8_t reg, uint32_t value)
 /**************************************************************************/
 tcs3414Error_e tcs3414Read16(uint8_t reg, uint16_t *value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 2;
-  I2CReadLength = 2;
-  I2CMasterBuffer[0] = TCS3414_ADDRESS;             // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  // Append address w/read bit
-  I2CMasterBuffer[2] = TCS3414_ADDRESS | TCS3414_READBIT;  
-  i2cEngine();
+  uint8_t data[2];
+  i2cReadReg(TCS3414_ADDRESS, reg, 1, data, sizeof(data));
 
   // Shift values to create properly formed integer (low byte first)
-  *value = (I2CSlaveBuffer[0] | (I2CSlaveBuffer[1] << 8));
+  *value = (data[0] | (data[1] << 8));
 
   return TCS3414_ERROR_OK;
 }
@@ -67,12 +67,6 @@
 #include "tsl2561.h"
 #include "core/systick/systick.h"
 
-extern volatile uint8_t   I2CMasterBuffer[I2C_BUFSIZE];
-extern volatile uint8_t   I2CSlaveBuffer[I2C_BUFSIZE];
-extern volatile uint32_t  I2CReadLength, I2CWriteLength;
-
-uint32_t i;
-
 static bool _tsl2561Initialised = false;
 static tsl2561IntegrationTime_t _tsl2561IntegrationTime = TSL2561_INTEGRATIONTIME_402MS;
 static tsl2561Gain_t _tsl2561Gain = TSL2561_GAIN_0X;
@@ -84,17 +78,7 @@ static tsl2561Gain_t _tsl2561Gain = TSL2561_GAIN_0X;
 /**************************************************************************/
 tsl2561Error_t tsl2561WriteCmd (uint8_t cmd)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 2;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = TSL2561_ADDRESS;       // I2C device address
-  I2CMasterBuffer[1] = cmd;                   // Command register
-  i2cEngine();
+  i2cWriteReg(TSL2561_ADDRESS, cmd, 1, NULL, 0);          // Command register only
   return TSL2561_ERROR_OK;
 }
 
@@ -105,18 +89,8 @@ tsl2561Error_t tsl2561WriteCmd (uint8_t cmd)
 /**************************************************************************/
 tsl2561Error_t tsl2561Write8 (uint8_t reg, uint32_t value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 3;
-  I2CReadLength = 0;
-  I2CMasterBuffer[0] = TSL2561_ADDRESS;           // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  I2CMasterBuffer[2] = (value & 0xFF);            // Value to write
-  i2cEngine();
+  uint8_t data = (value & 0xFF);                 // Value to write
+  i2cWriteReg(TSL2561_ADDRESS, reg, 1, &data, 1);
   return TSL2561_ERROR_OK;
 }
 
@@ -127,22 +101,11 @@ tsl2561Error_t tsl2561Write8 (uint8_t reg, uint32_t value)
 /**************************************************************************/
 tsl2561Error_t tsl2561Read16(uint8_t reg, uint16_t *value)
 {
-  // Clear write buffers
-  for ( i = 0; i < I2C_BUFSIZE; i++ )
-  {
-    I2CMasterBuffer[i] = 0x00;
-  }
-
-  I2CWriteLength = 2;
-  I2CReadLength = 2;
-  I2CMasterBuffer[0] = TSL2561_ADDRESS;             // I2C device address
-  I2CMasterBuffer[1] = reg;                       // Command register
-  // Append address w/read bit
-  I2CMasterBuffer[2] = TSL2561_ADDRESS | TSL2561_READBIT;  
-  i2cEngine();
+  uint8_t data[2];
+  i2cReadReg(TSL2561_ADDRESS, reg, 1, data, sizeof(data));
 
   // Shift values to create properly formed integer (low byte first)
-  *value = (I2CSlaveBuffer[0] | (I2CSlaveBuffer[1] << 8));
+  *value = (data[0] | (data[1] << 8));
 
   return TSL2561_ERROR_OK;
 }
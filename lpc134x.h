@@ -2019,6 +2019,11 @@ static inline void NVIC_DisableIRQ(IRQn_t IRQn)
   NVIC->ICER[((uint32_t)(IRQn) >> 5)] = (1 << ((uint32_t)(IRQn) & 0x1F));
 }
 
+static inline void NVIC_SetPendingIRQ(IRQn_t IRQn)
+{
+  NVIC->ISPR[((uint32_t)(IRQn) >> 5)] = (1 << ((uint32_t)(IRQn) & 0x1F));
+}
+
 /*##############################################################################
 ## GPIO - General Purpose I/O
 ##############################################################################*/
@@ -41,12 +41,21 @@
 #include "sysinit.h"
 
 #include "core/gpio/gpio.h"
+#include "core/i2c/i2c.h"
 #include "core/systick/systick.h"
 
 #ifdef CFG_INTERFACE
   #include "core/cmd/cmd.h"
 #endif
 
+#ifdef CFG_TRACE
+  #include "core/trace/trace.h"
+#endif
+
+#if (defined CFG_I2CEEPROM || defined CFG_SPIEEPROM) && CFG_EEPROM_CACHE_SIZE > 0
+  #include "drivers/eeprom/eeprom.h"
+#endif
+
 /**************************************************************************/
 /*! 
     Approximates a 1 millisecond delay using "nop".  This is less
@@ -104,6 +113,22 @@ int main(void)
     #ifdef CFG_INTERFACE 
       cmdPoll(); 
     #endif
+
+    // Abort any I2C transfer that has timed out
+    i2cPoll();
+
+    // Report any registers written by an I2C master in slave mode
+    i2cSlavePoll();
+
+    // Write back any EEPROM settings held in the RAM cache
+    #if (defined CFG_I2CEEPROM || defined CFG_SPIEEPROM) && CFG_EEPROM_CACHE_SIZE > 0
+      eepromPoll();
+    #endif
+
+    // Send any pending trace records if CFG_TRACE is enabled
+    #ifdef CFG_TRACE
+      tracePoll();
+    #endif
   }
 
   return 0;
@@ -48,8 +48,10 @@
 // Function prototypes for the command table
 void cmd_help(uint8_t argc, char **argv);         // handled by core/cmd/cmd.c
 void cmd_sysinfo(uint8_t argc, char **argv);
+void cmd_stream(uint8_t argc, char **argv);
 
 #ifdef CFG_TFTLCD
+void cmd_arc(uint8_t argc, char **argv);
 void cmd_button(uint8_t argc, char **argv);
 void cmd_circle(uint8_t argc, char **argv);
 void cmd_clear(uint8_t argc, char **argv);
@@ -75,7 +77,7 @@ void cmd_chibi_addr(uint8_t argc, char **argv);
 void cmd_chibi_tx(uint8_t argc, char **argv);
 #endif
 
-#ifdef CFG_I2CEEPROM
+#if defined CFG_I2CEEPROM || defined CFG_SPIEEPROM
 void cmd_i2ceeprom_read(uint8_t argc, char **argv);
 void cmd_i2ceeprom_write(uint8_t argc, char **argv);
 void cmd_uart(uint8_t argc, char **argv);
@@ -85,8 +87,13 @@ void cmd_uart(uint8_t argc, char **argv);
 void cmd_lm75b_gettemp(uint8_t argc, char **argv);
 #endif
 
+#if CFG_I2C_STATS > 0
+void cmd_i2c_stats(uint8_t argc, char **argv);
+#endif
+
 #ifdef CFG_SDCARD
 void cmd_sd_dir(uint8_t argc, char **argv);
+void cmd_sd_run(uint8_t argc, char **argv);
 #endif
 
 #define CMD_NOPARAMS "This command has no parameters"
@@ -105,14 +112,16 @@ cmd_t cmd_tbl[] =
   // command name, min args, max args, hidden, function name, command description, syntax
   { "?",    0,  0,  0, cmd_help              , "Help"                           , CMD_NOPARAMS },
   { "V",    0,  0,  0, cmd_sysinfo           , "System Info"                    , CMD_NOPARAMS },
+  { "D",    1,  1,  1, cmd_stream            , "Stream Test Data"               , "'D <bytes>'" },
 
-  #ifdef CFG_I2CEEPROM
-  { "e",    1,  1,  0, cmd_i2ceeprom_read    , "EEPROM Read"                    , "'e <addr>'" },
+  #if defined CFG_I2CEEPROM || defined CFG_SPIEEPROM
+  { "e",    1,  2,  0, cmd_i2ceeprom_read    , "EEPROM Read"                    , "'e <addr> [<len>]'" },
   { "w",    2,  2,  0, cmd_i2ceeprom_write   , "EEPROM Write"                   , "'w <addr> <val>'" },
   { "U",    0,  1,  0, cmd_uart              , "UART baud rate"                 , "'U [<val>]'" },
   #endif
 
   #ifdef CFG_TFTLCD
+  { "a",    7,  7,  0, cmd_arc               , "Arc"                            , "'a <x> <y> <r_in> <r_out> <start> <end> <color>'" },
   { "b",    7,  99, 0, cmd_button            , "Button"                         , "'b <x> <y> <w> <h> <brdrclr> <fillclr> <fontclr> [<txt>]'" },
   #ifdef CFG_SDCARD
   { "B",    3,  3,  0, cmd_bmp               , "Bitmap (SD Card)"               , "'B <x> <y> <file>'" },
@@ -121,7 +130,7 @@ cmd_t cmd_tbl[] =
   { "C",    0,  0,  0, cmd_calibrate         , "Calibrate Touch Screen"         , CMD_NOPARAMS },
   { "F",    0,  1,  0, cmd_clear             , "Fill"                           , "'F [<color>]'" },
   { "l",    5,  7,  0, cmd_line              , "Line"                           , "'l <x1> <y1> <x2> <y2> <color> [<empty> <solid>]'" },
-  { "o",    0,  1,  0, cmd_orientation       , "LCD Orientation"                , "'o [<0|1>]'" },
+  { "o",    0,  1,  0, cmd_orientation       , "LCD Orientation"                , "'o [<0|1|2|3>]'" },
   { "p",    3,  3,  0, cmd_pixel             , "Draw Pixel"                     , "'p <x> <y> <color>'" },
   { "P",    9,  9,  0, cmd_progress          , "Progress Bar"                   , "'P <x> <y> <w> <h> <%> <bclr> <bfillclr> <pbrdclr> <pfillclr>'" },
   { "r",    5,  7,  0, cmd_rectangle         , "Rectangle"                      , "'r <x1> <y1> <x2> <y2> <color> [<filled[0|1]> <bcolor>]'" },
@@ -142,8 +151,13 @@ cmd_t cmd_tbl[] =
   { "m",    0,  0,  0, cmd_lm75b_gettemp     , "Temp (C)"                       , CMD_NOPARAMS },
   #endif
 
+  #if CFG_I2C_STATS > 0
+  { "I",    0,  1,  0, cmd_i2c_stats         , "I2C Statistics"                 , "'I [<reset[0|1]>]'" },
+  #endif
+
   #ifdef CFG_SDCARD
   { "d",    0,  1,  0,  cmd_sd_dir           , "Dir (SD Card)"                  , "'d [<path>]'" },
+  { "X",    1,  1,  0,  cmd_sd_run           , "Run Script (SD Card)"           , "'X <file>'" },
   #endif
 };
 
@@ -46,74 +46,204 @@
 
 /**************************************************************************/
 /*!
-    @brief  Attempts to convert the supplied decimal or hexadecimal
-          string to the matching 32-bit value.  All hexadecimal values
-          must be preceded by either '0x' or '0X' to be properly parsed.
+    @brief  Converts a decimal (with optional '-') or hexadecimal string
+            to a 32-bit value without printing anything.  Hexadecimal
+            values must be preceded by '0x' or '0X' unless hexOnly is set.
+
+    @returns  false if the string is empty, contains an invalid digit or
+              doesn't fit in 32 bits
+*/
+/**************************************************************************/
+static bool parseNumber (const char *s, bool hexOnly, int32_t *result)
+{
+  uint32_t value = 0;
+  uint32_t digit;
+  bool negative = false;
+
+  if (!s || !*s)
+    return false;
+
+  // Check if this is a hexadecimal value
+  if ((s[0] == '0') && ((s[1] == 'x') || (s[1] == 'X')))
+  {
+    hexOnly = true;
+    s += 2;
+    if (!*s)
+      return false;
+  }
+
+  if (hexOnly)
+  {
+    for (; *s; s++)
+    {
+      if (!isxdigit((uint8_t)*s) || (value >> 28))
+        return false;
+      digit = isdigit((uint8_t)*s) ? *s - '0' : (toupper((uint8_t)*s) - 'A' + 10);
+      value = (value << 4) | digit;
+    }
+    *result = (int32_t)value;
+    return true;
+  }
+
+  // Check for negative sign
+  if (*s == '-')
+  {
+    negative = true;
+    s++;
+    if (!*s)
+      return false;
+  }
+
+  for (; *s; s++)
+  {
+    if (!isdigit((uint8_t)*s))
+      return false;
+    digit = *s - '0';
+    // Largest magnitude is 2147483647, or 2147483648 when negative
+    if (value > (0x80000000 - digit - !negative) / 10)
+      return false;
+    value = (value * 10) + digit;
+  }
+
+  *result = negative ? (int32_t)(0 - value) : (int32_t)value;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a decimal or hexadecimal ('0x') argument to an
+            integer and checks that it's within the supplied range.  If
+            it isn't, "Invalid <name>" is displayed.
 
     @param[in]  s
-                Input string
+                Argument string
+    @param[in]  name
+                Name of the argument, used in the error message
+    @param[in]  min
+                Smallest valid value
+    @param[in]  max
+                Largest valid value
     @param[out] result
-                Signed 32-bit integer to hold the conversion results
+                Converted value (only set if valid)
+
+    @returns  true if the argument was valid
 
     @section Example
 
     @code
-    char *hex = "0xABCD";
-    char *dec = "1234";
-
-    // Convert supplied values to integers
-    int32_t hexValue, decValue;
-    getNumber (hex, &hexValue);
-    getNumber (dec, &decValue);
-
+    int32_t r;
+    if (!getArgInt(argv[2], "Radius", 1, 320, &r)) return;
     @endcode
 */
 /**************************************************************************/
-int getNumber (char *s, int32_t *result)
+bool getArgInt (char *s, const char *name, int32_t min, int32_t max, int32_t *result)
 {
   int32_t value;
-  uint32_t mustBeHex = FALSE;
-  uint32_t sgn = 1;
-  const unsigned char hexToDec [] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 255, 255, 255, 255, 255, 255, 255, 10, 11, 12, 13, 14, 15};
 
-  if (!s)
-    return 0;
-
-  // Check if this is a hexadecimal value
-  if ((strlen (s) > 2) && (!strncmp (s, "0x", 2) || !strncmp (s, "0X", 2)))
+  if (!parseNumber(s, false, &value) || (value < min) || (value > max))
   {
-    mustBeHex = TRUE;
-    s += 2;
+    printf("Invalid %s%s", name, CFG_PRINTF_NEWLINE);
+    return false;
   }
 
-  // Check for negative sign
-  if (!mustBeHex && *s && (*s == '-'))
+  *result = value;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Converts a color argument, either an RGB565 value (decimal or
+            '0x' hex, 0..0xFFFF) or a 24-bit '#RRGGBB' value that is
+            converted to RGB565.  If it isn't valid, "Invalid <name>" is
+            displayed.
+
+    @returns  true if the argument was valid
+*/
+/**************************************************************************/
+bool getArgColor (char *s, const char *name, uint16_t *result)
+{
+  int32_t value;
+
+  if (s && (s[0] == '#'))
   {
-    sgn = -1;
-    s++;
+    if ((strlen(s) == 7) && parseNumber(s + 1, true, &value))
+    {
+      *result = ((value >> 8) & 0xF800) | ((value >> 5) & 0x07E0) | ((value >> 3) & 0x001F);
+      return true;
+    }
+  }
+  else if (parseNumber(s, false, &value) && (value >= 0) && (value <= 0xFFFF))
+  {
+    *result = (uint16_t)value;
+    return true;
   }
 
-  // Try to convert value
-  for (value = 0; *s; s++)
+  printf("Invalid %s%s", name, CFG_PRINTF_NEWLINE);
+  return false;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Joins the remaining arguments of a command (such as the
+            message for 't' or 'S') back into a single string, separated
+            by spaces.  The text is truncated if it doesn't fit.
+
+    @param[in]  argc
+                Number of arguments to join
+    @param[in]  argv
+                The first argument to join
+    @param[out] buffer
+                Destination for the NULL-terminated text
+    @param[in]  size
+                Size of buffer in bytes
+
+    @returns  The length of the text (not including the NULL)
+*/
+/**************************************************************************/
+uint32_t getArgText (uint8_t argc, char **argv, char *buffer, uint32_t size)
+{
+  uint32_t len = 0, n;
+  uint8_t i;
+
+  for (i = 0; (i < argc) && (len < size - 1); i++)
   {
-    if (mustBeHex && isxdigit ((uint8_t)*s))
-      value = (value << 4) | hexToDec [toupper((uint8_t)*s) - '0'];
-    else if (isdigit ((uint8_t)*s))
-      value = (value * 10) + ((uint8_t)*s - '0');
-    else
+    if (i > 0)
     {
-      printf ("Malformed number. Must be decimal number, or hex value preceeded by '0x'%s", CFG_PRINTF_NEWLINE);
-      return 0;
+      buffer[len++] = ' ';
     }
+    n = strlen(argv[i]);
+    if (n > size - 1 - len)
+    {
+      n = size - 1 - len;
+    }
+    memcpy(&buffer[len], argv[i], n);
+    len += n;
   }
+  buffer[len] = '\0';
 
-  // Set number to negative value if required
-  if (!mustBeHex)
-    value *= sgn;
+  return len;
+}
 
-  *result = value;
+/**************************************************************************/
+/*!
+    @brief  Converts a pixel coordinate argument and checks that it is
+            between 0 and limit - 1 (normally the width or height of the
+            display).  If it isn't, "Invalid <name>" is displayed.
+
+    @returns  true if the argument was valid
+*/
+/**************************************************************************/
+bool getArgCoord (char *s, const char *name, uint16_t limit, uint16_t *result)
+{
+  int32_t value;
+
+  if (!getArgInt(s, name, 0, (int32_t)limit - 1, &value))
+  {
+    return false;
+  }
 
-  return 1;
+  *result = (uint16_t)value;
+  return true;
 }
 
 
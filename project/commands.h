@@ -38,7 +38,10 @@
 
 #include "projectconfig.h"
 
-// Method Prototypes
-int getNumber (char *s, int32_t *result);
+// Typed argument parsers with range checking
+bool getArgInt   (char *s, const char *name, int32_t min, int32_t max, int32_t *result);
+bool getArgColor (char *s, const char *name, uint16_t *result);
+bool getArgCoord (char *s, const char *name, uint16_t limit, uint16_t *result);
+uint32_t getArgText (uint8_t argc, char **argv, char *buffer, uint32_t size);
 
 #endif
\ No newline at end of file
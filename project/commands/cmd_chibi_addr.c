@@ -60,12 +60,9 @@ void cmd_chibi_addr(uint8_t argc, char **argv)
   {
     // Try to convert supplied value to an integer
     int32_t addr;
-    getNumber (argv[0], &addr);
-    
-    // Check for invalid values (getNumber may complain about this as well)
-    if (addr <= 0 || addr > 0xFFFF)
+    if (!getArgInt(argv[0], "Address", 1, 0xFFFF, &addr))
     {
-      printf("Invalid Address: 1-65534 or 0x0001-0xFFFE required.%s", CFG_PRINTF_NEWLINE);
+      printf("1-65534 or 0x0001-0xFFFE required.%s", CFG_PRINTF_NEWLINE);
       return;
     }
     if (addr == 0xFFFF)
@@ -55,36 +55,22 @@
 /**************************************************************************/
 void cmd_chibi_tx(uint8_t argc, char **argv)
 {
-  uint8_t i, len, *data_ptr, data[50];
-  uint16_t addr;
+  char data[50];
+  uint32_t len;
 
-  // Try to convert supplied address to an integer
-  int32_t addr32;
-  getNumber (argv[0], &addr32);
-  
-  // Check for invalid values (getNumber may complain about this as well)
-  if (addr32 <= 0 || addr32 > 0xFFFF)
+  // Convert and validate the supplied address
+  int32_t addr;
+  if (!getArgInt(argv[0], "Address", 1, 0xFFFF, &addr))
   {
-    printf("Invalid Address: 1-65534 or 0x0001-0xFFFE required.%s", CFG_PRINTF_NEWLINE);
+    printf("1-65534 or 0x0001-0xFFFE required.%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
-  // Address seems to be OK
-  addr = (uint16_t)addr32;
-
   // Get message contents
-  data_ptr = data;
-  for (i=0; i<argc-1; i++)
-  {
-    len = strlen(argv[i+1]);
-    strcpy((char *)data_ptr, (char *)argv[i+1]);
-    data_ptr += len;
-    *data_ptr++ = ' ';
-  }
-  *data_ptr++ = '\0';
+  len = getArgText(argc - 1, &argv[1], data, sizeof(data));
 
-  // Send message
-  chb_write(addr, data, data_ptr - data);
+  // Send message (including the NULL terminator)
+  chb_write((uint16_t)addr, (uint8_t *)data, len + 1);
 }
 
 #endif
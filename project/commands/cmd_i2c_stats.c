@@ -0,0 +1,90 @@
+/**************************************************************************/
+/*! 
+    @file     cmd_i2c_stats.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @brief    Code to execute for cmd_i2c_stats in the 'core/cmd'
+              command-line interpretter.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#include <stdio.h>
+
+#include "projectconfig.h"
+#include "core/cmd/cmd.h"
+#include "project/commands.h"       // Generic helper functions
+
+#if CFG_I2C_STATS > 0
+  #include "core/i2c/i2c.h"
+
+/**************************************************************************/
+/*! 
+    Displays the I2C transfer statistics for each slave address, and
+    optionally clears them afterwards.
+*/
+/**************************************************************************/
+void cmd_i2c_stats(uint8_t argc, char **argv)
+{
+  i2cStats_t stats[CFG_I2C_STATS];
+  uint32_t count, i;
+  int32_t reset = 0;
+
+  if (argc > 0)
+  {
+    if (!getArgInt(argv[0], "reset", 0, 1, &reset))
+    {
+      return;
+    }
+  }
+
+  count = i2cGetStats(stats, CFG_I2C_STATS);
+  printf("Addr  Transfers  NACKs  Timeouts  ArbLoss  Bytes     Bus Time (us)%s", CFG_PRINTF_NEWLINE);
+  for (i = 0; i < count; i++)
+  {
+    printf("0x%02X  %-9u  %-5u  %-8u  %-7u  %-8u  %u%s",
+           stats[i].address,
+           (unsigned int)stats[i].transfers,
+           (unsigned int)stats[i].nacks,
+           (unsigned int)stats[i].timeouts,
+           (unsigned int)stats[i].arbLosses,
+           (unsigned int)stats[i].bytes,
+           (unsigned int)stats[i].busTime,
+           CFG_PRINTF_NEWLINE);
+  }
+  printf("%-25s : %u %s", "Bus Recoveries", (unsigned int)i2cGetRecoveries(), CFG_PRINTF_NEWLINE);
+
+  if (reset)
+  {
+    i2cResetStats();
+  }
+}
+
+#endif
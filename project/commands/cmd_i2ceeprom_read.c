@@ -42,35 +42,64 @@
 #include "core/cmd/cmd.h"
 #include "project/commands.h"       // Generic helper functions
 
-#ifdef CFG_I2CEEPROM
+#if defined CFG_I2CEEPROM || defined CFG_SPIEEPROM
   #include "drivers/eeprom/eeprom.h"
 
 /**************************************************************************/
 /*! 
-    Reads a single byte at the supplied EEPROM address
+    Reads a single byte at the supplied EEPROM address, or dumps a block
+    of bytes (16 per line) if a length is also supplied
 */
 /**************************************************************************/
 void cmd_i2ceeprom_read(uint8_t argc, char **argv)
 {
-  uint16_t addr;
-  uint8_t value;
+  int32_t addr, len;
+  uint8_t buffer[64];
+  uint32_t chunk, i;
 
-  // Try to convert supplied address to an integer
-  int32_t addr32;
-  getNumber (argv[0], &addr32);
-  
-  // Check for invalid values (getNumber may complain about this as well)
-  if (addr32 < 0 || eepromCheckAddress(addr32))
+  // Convert and validate the supplied address
+  if (!getArgInt(argv[0], "Address", 0, 0xFFFF, &addr))
+  {
+    return;
+  }
+  if (eepromCheckAddress(addr))
   {
     printf("Address out of range %s", CFG_PRINTF_NEWLINE);
     return;
   }
 
-  // Address seems to be OK
-  addr = (uint16_t)addr32;
-  value = eepromReadU8(addr);
+  if (argc == 1)
+  {
+    printf("0x%02X%s", eepromReadU8((uint16_t)addr), CFG_PRINTF_NEWLINE);
+    return;
+  }
+
+  if (!getArgInt(argv[1], "Length", 1, EEPROM_MAXADDR + 1 - addr, &len))
+  {
+    return;
+  }
 
-  printf("0x%02X%s", value, CFG_PRINTF_NEWLINE);
+  // Read the block a buffer at a time, with one sequential read each
+  while (len > 0)
+  {
+    chunk = len < sizeof(buffer) ? len : sizeof(buffer);
+    if (eepromReadBuffer((uint16_t)addr, buffer, chunk) != EEPROM_ERROR_OK)
+    {
+      printf("Read failed at 0x%04X%s", (unsigned int)addr, CFG_PRINTF_NEWLINE);
+      return;
+    }
+    for (i = 0; i < chunk; i++)
+    {
+      if ((i % 16) == 0)
+      {
+        printf("%s%04X:", i ? CFG_PRINTF_NEWLINE : "", (unsigned int)(addr + i));
+      }
+      printf(" %02X", buffer[i]);
+    }
+    printf("%s", CFG_PRINTF_NEWLINE);
+    addr += chunk;
+    len -= chunk;
+  }
 }
 
 #endif
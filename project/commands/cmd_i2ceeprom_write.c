@@ -42,7 +42,7 @@
 #include "core/cmd/cmd.h"
 #include "project/commands.h"       // Generic helper functions
 
-#ifdef CFG_I2CEEPROM
+#if defined CFG_I2CEEPROM || defined CFG_SPIEEPROM
   #include "drivers/eeprom/eeprom.h"
 
 /**************************************************************************/
@@ -52,23 +52,19 @@
 /**************************************************************************/
 void cmd_i2ceeprom_write(uint8_t argc, char **argv)
 {
-  uint16_t addr;
-  uint8_t val;
+  int32_t addr, val;
 
-  // Try to convert supplied address to an integer
-  int32_t addr32;
-  getNumber (argv[0], &addr32);
-  
-  // Check for invalid values (getNumber may complain about this as well)
-  if (addr32 < 0 || eepromCheckAddress(addr32))
+  // Convert and validate the supplied address
+  if (!getArgInt(argv[0], "Address", 0, 0xFFFF, &addr))
+  {
+    return;
+  }
+  if (eepromCheckAddress(addr))
   {
     printf("Address out of range %s", CFG_PRINTF_NEWLINE);
     return;
   }
 
-  // Address seems to be OK
-  addr = (uint16_t)addr32;
-
   // Make sure this isn't in the reserved system config space
   if (addr <= CFG_EEPROM_RESERVED)
   {
@@ -76,25 +72,18 @@ void cmd_i2ceeprom_write(uint8_t argc, char **argv)
     return;
   }
 
-  // Try to convert supplied data to an integer
-  int32_t val32;
-  getNumber (argv[1], &val32);
-  
-  // Check for invalid values (getNumber may complain about this as well)
-  if (val32 < 0 || val32 > 0xFF)
+  // Convert and validate the supplied data (0-255 or 0x00-0xFF)
+  if (!getArgInt(argv[1], "Data", 0, 0xFF, &val))
   {
-    printf("Invalid Data: 0-255 or 0x00-0xFF required.%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
-  // Data seems to be OK
-  val = (uint8_t)val32;
-
   // Write data at supplied address
-  eepromWriteU8(addr, val);
+  eepromWriteU8((uint16_t)addr, (uint8_t)val);
+  eepromFlush();
 
   // Write successful
-  printf("0x%02X written at 0x%04X%s", val, addr, CFG_PRINTF_NEWLINE);
+  printf("0x%02X written at 0x%04X%s", (unsigned int)val, (unsigned int)addr, CFG_PRINTF_NEWLINE);
 }
 
 #endif
@@ -0,0 +1,271 @@
+/**************************************************************************/
+/*! 
+    @file     cmd_sd_run.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @brief    Code to execute for cmd_sd_run in the 'core/cmd'
+              command-line interpretter.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "projectconfig.h"
+#include "core/cmd/cmd.h"
+#include "project/commands.h"           // Generic helper functions
+
+#ifdef CFG_SDCARD
+  #include "core/systick/systick.h"
+  #include "drivers/fatfs/diskio.h"
+  #include "drivers/fatfs/ff.h"
+
+  static FATFS Fatfs[1];
+  static FIL scriptFile;
+  static char scriptLine[CFG_INTERFACE_MAXMSGSIZE];
+  static bool scriptRunning = false;
+
+/**************************************************************************/
+/*! 
+    @brief  Executes one line of a script, skipping blank lines and
+            '#' comments.
+
+    @returns  The number of commands on the line that were rejected
+*/
+/**************************************************************************/
+static int runScriptLine(char *line, uint32_t lineNumber)
+{
+  int errors;
+
+  while ((*line == ' ') || (*line == '\t'))
+  {
+    line++;
+  }
+  if ((*line == '\0') || (*line == '#'))
+  {
+    return 0;
+  }
+
+  errors = cmdExecute(line);
+  if (errors)
+  {
+    printf("Error on line %u%s", (unsigned int)lineNumber, CFG_PRINTF_NEWLINE);
+  }
+
+  return errors;
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Executes the first len characters collected in scriptLine,
+            or reports the line if it was too long to collect.
+
+    @returns  The number of errors on the line
+*/
+/**************************************************************************/
+static int endScriptLine(uint32_t len, bool overflow, uint32_t lineNumber)
+{
+  scriptLine[len] = '\0';
+  if (overflow)
+  {
+    printf("Line %u too long%s", (unsigned int)lineNumber, CFG_PRINTF_NEWLINE);
+    return 1;
+  }
+
+  return runScriptLine(scriptLine, lineNumber);
+}
+
+/**************************************************************************/
+/*! 
+    @brief  Reads the line starting at *offset into scriptLine and
+            advances *offset past it.
+
+    The script is opened and closed again for every line, since
+    commands such as 'B' and 'd' remount volume 0 with their own
+    FATFS object, which invalidates any file that is still open.
+
+    @param[in]  path
+                The script to read
+    @param[in]  offset
+                The file offset of the line to read, which is
+                updated to the start of the next line
+    @param[out] len
+                The number of characters collected in scriptLine
+    @param[out] overflow
+                Set if the line didn't fit in scriptLine
+    @param[out] more
+                Set if the line ended with a newline, and cleared
+                at the end of the file
+
+    @returns  FR_OK, or the FatFs error that stopped the read
+*/
+/**************************************************************************/
+static FRESULT readScriptLine(const char *path, DWORD *offset, uint32_t *len, bool *overflow, bool *more)
+{
+  char chunk[64];
+  UINT bytesRead, i;
+  FRESULT res;
+
+  *len = 0;
+  *overflow = false;
+  *more = false;
+
+  res = f_mount(0, &Fatfs[0]);
+  if (res == FR_OK)
+  {
+    res = f_open(&scriptFile, path, FA_READ | FA_OPEN_EXISTING);
+  }
+  if (res != FR_OK)
+  {
+    return res;
+  }
+
+  res = f_lseek(&scriptFile, *offset);
+  while (res == FR_OK)
+  {
+    res = f_read(&scriptFile, chunk, sizeof(chunk), &bytesRead);
+    if ((res != FR_OK) || (bytesRead == 0))
+    {
+      break;
+    }
+    for (i = 0; i < bytesRead; i++)
+    {
+      if (chunk[i] == '\n')
+      {
+        *more = true;
+        break;
+      }
+      if (chunk[i] != '\r')
+      {
+        if (*len < sizeof(scriptLine) - 1)
+        {
+          scriptLine[(*len)++] = chunk[i];
+        }
+        else
+        {
+          *overflow = true;
+        }
+      }
+    }
+    if (*more)
+    {
+      // Skip past the newline
+      *offset += i + 1;
+      break;
+    }
+    *offset += bytesRead;
+  }
+
+  f_close(&scriptFile);
+  return res;
+}
+
+/**************************************************************************/
+/*! 
+    sd 'run' command handler
+
+    Executes a text file of commands from the SD card, one line at a
+    time, exactly as if each line had been entered at the prompt (so
+    several commands can be placed on one line, separated by ';').
+    Lines are not echoed and no prompt is displayed between them, and
+    the execution time is shown once the script has finished.
+
+    Lines starting with '#' are treated as comments.  The script is
+    closed while each line runs, so lines may use the other SD card
+    commands.
+*/
+/**************************************************************************/
+void cmd_sd_run(uint8_t argc, char **argv)
+{
+  uint32_t len, lineNumber = 1, errors = 0, start, ticks;
+  bool overflow, more;
+  DWORD offset = 0;
+  DSTATUS stat;
+
+  if (scriptRunning)
+  {
+    printf("Scripts can't be nested%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
+
+  // Initialise SD Card
+  stat = disk_initialize(0);
+  if (stat & STA_NOINIT) 
+  {
+    printf("SD init failed%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
+  if (stat & STA_NODISK) 
+  {
+    printf("No SD card%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
+  if (f_mount(0, &Fatfs[0]) != FR_OK)
+  {
+    printf("Failed to mount partition%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
+  if (f_open(&scriptFile, argv[0], FA_READ | FA_OPEN_EXISTING) != FR_OK)
+  {
+    printf("Failed to open '%s'%s", argv[0], CFG_PRINTF_NEWLINE);
+    return;
+  }
+  f_close(&scriptFile);
+
+  scriptRunning = true;
+  start = systickGetTicks();
+
+  // Read and execute one line at a time
+  do
+  {
+    if (readScriptLine(argv[0], &offset, &len, &overflow, &more) != FR_OK)
+    {
+      // Don't run a partly read line
+      printf("Failed to read '%s'%s", argv[0], CFG_PRINTF_NEWLINE);
+      errors++;
+      break;
+    }
+    // The last line may not end with a newline
+    if (more || (len > 0) || overflow)
+    {
+      errors += endScriptLine(len, overflow, lineNumber);
+      lineNumber++;
+    }
+  } while (more);
+
+  ticks = systickGetTicks() - start;
+  scriptRunning = false;
+
+  printf("%s: %u lines, %u errors, %u ms%s", argv[0], (unsigned int)(lineNumber - 1), 
+         (unsigned int)errors, (unsigned int)(ticks * CFG_SYSTICK_DELAY_IN_MS), CFG_PRINTF_NEWLINE);
+}
+
+#endif
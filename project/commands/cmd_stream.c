@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*! 
+    @file     cmd_stream.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @brief    Code to execute for cmd_stream in the 'core/cmd'
+              command-line interpretter.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#include <stdio.h>
+
+#include "projectconfig.h"
+#include "core/cmd/cmd.h"
+#include "project/commands.h"       // Generic helper functions
+
+/**************************************************************************/
+/*! 
+    Streams a test pattern to the active interface (USB CDC or UART) as
+    fast as it will go, for use with 'tools/cdcbench'.  An STX (0x02)
+    marks the start of the data, followed by the requested number of
+    bytes, where byte n is 'A' + (n % 26).
+*/
+/**************************************************************************/
+void cmd_stream(uint8_t argc, char **argv)
+{
+  char chunk[65];
+  int32_t count;
+  uint32_t i, n, pos;
+
+  if (!getArgInt(argv[0], "byte count", 1, 0x7FFFFFFF, &count))
+  {
+    return;
+  }
+
+  printf("%c", 0x02);
+  pos = 0;
+  while (count > 0)
+  {
+    n = count > 64 ? 64 : count;
+    for (i = 0; i < n; i++)
+    {
+      chunk[i] = 'A' + (pos++ % 26);
+    }
+    chunk[n] = '\0';
+    printf("%s", chunk);
+    count -= n;
+  }
+}
@@ -65,6 +65,10 @@
   #include "core/gpio/gpio.h"
 #endif
 
+#if (defined CFG_I2CEEPROM || defined CFG_SPIEEPROM) && CFG_EEPROM_CACHE_SIZE > 0
+  #include "drivers/eeprom/eeprom.h"
+#endif
+
 /**************************************************************************/
 /*! 
     'sysinfo' command handler
@@ -123,4 +127,13 @@ void cmd_sysinfo(uint8_t argc, char **argv)
   #ifdef CFG_SDCARD
     printf("%-25s : %s %s", "SD Card Present", gpioGetValue(CFG_SDCARD_CDPORT, CFG_SDCARD_CDPIN) ? "True" : "False", CFG_PRINTF_NEWLINE);
   #endif
+
+  // EEPROM RAM cache usage
+  #if (defined CFG_I2CEEPROM || defined CFG_SPIEEPROM) && CFG_EEPROM_CACHE_SIZE > 0
+    eepromCacheStats_t stats;
+    eepromGetCacheStats(&stats);
+    printf("%-25s : %u hits, %u misses %s", "EEPROM Cache Reads", (unsigned int)stats.readHits, (unsigned int)stats.readMisses, CFG_PRINTF_NEWLINE);
+    printf("%-25s : %u hits, %u misses %s", "EEPROM Cache Writes", (unsigned int)stats.writeHits, (unsigned int)stats.writeMisses, CFG_PRINTF_NEWLINE);
+    printf("%-25s : %u flushes, %u pages %s", "EEPROM Cache Flushes", (unsigned int)stats.flushes, (unsigned int)stats.pagesWritten, CFG_PRINTF_NEWLINE);
+  #endif
 }
@@ -42,7 +42,7 @@
 #include "core/cmd/cmd.h"
 #include "project/commands.h"       // Generic helper functions
 
-#ifdef CFG_I2CEEPROM
+#if defined CFG_I2CEEPROM || defined CFG_SPIEEPROM
   #include "drivers/eeprom/eeprom.h"
   #include "core/uart/uart.h"
 
@@ -57,18 +57,16 @@ void cmd_uart(uint8_t argc, char **argv)
   {
     // Try to convert supplied value to an integer
     int32_t speed;
-    getNumber (argv[0], &speed);
-    
-    // Check for invalid values (getNumber may complain about this as well)
-    if (speed < 9600 || speed  > 115200)
+    if (!getArgInt(argv[0], "baud rate", 9600, UART_BAUDRATE_MAX, &speed))
     {
-      printf("Invalid baud rate: 9600-115200 required.%s", CFG_PRINTF_NEWLINE);
+      printf("9600-%d required.%s", UART_BAUDRATE_MAX, CFG_PRINTF_NEWLINE);
       return;
     }
 
     // Write baud rate to EEPROM and reinitialise UART if using it
     printf("Setting UART to: %d%s", (int)speed, CFG_PRINTF_NEWLINE);
     eepromWriteU32(CFG_EEPROM_UART_SPEED, speed);
+    eepromFlush();
     #ifdef CFG_PRINTF_UART
     uartInit(speed);
     #endif
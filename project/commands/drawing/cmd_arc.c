@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*! 
+    @file     cmd_arc.c
+    @author   K. Townsend (microBuilder.eu)
+
+    @brief    Code to execute for cmd_arc in the 'core/cmd'
+              command-line interpretter.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+#include <stdio.h>
+
+#include "projectconfig.h"
+#include "core/cmd/cmd.h"
+#include "project/commands.h"       // Generic helper functions
+
+#ifdef CFG_TFTLCD    
+  #include "drivers/lcd/tft/lcd.h"    
+  #include "drivers/lcd/tft/drawing.h"  
+
+/**************************************************************************/
+/*! 
+    Displays an arc, thick arc or pie segment on the LCD.
+*/
+/**************************************************************************/
+void cmd_arc(uint8_t argc, char **argv)
+{
+  int32_t r0, r1, start, end;
+  uint16_t x, y, c;
+
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgInt(argv[2], "Radius", 0, 0xFFFF, &r0) ||
+      !getArgInt(argv[3], "Radius", 1, 0xFFFF, &r1) ||
+      !getArgInt(argv[4], "Angle", -360, 360, &start) ||
+      !getArgInt(argv[5], "Angle", -360, 720, &end) ||
+      !getArgColor(argv[6], "Color", &c))
+  {
+    return;
+  }
+  if (r0 > r1)
+  {
+    printf("Invalid Radius%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
+
+  // An inner radius of 0 draws a pie segment
+  drawArcThick(x, y, r0, r1, start, end, c);
+}
+
+#endif  
@@ -53,12 +53,15 @@
 /**************************************************************************/
 void cmd_bmp(uint8_t argc, char **argv)
 {
-  int32_t x, y;
+  uint16_t x, y;
   char* filename;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y))
+  {
+    return;
+  }
   filename = argv[2];
 
   // Render image
@@ -60,40 +60,32 @@
 /**************************************************************************/
 void cmd_button(uint8_t argc, char **argv)
 {
-  int32_t x, y, w, h, border, fill, font;
-  
-  // ToDo: Validate data!
+  int32_t w, h;
+  uint16_t x, y, border, fill, font;
+  char text[50];
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
-  getNumber (argv[2], &w);
-  getNumber (argv[3], &h);
-  getNumber (argv[4], &border);
-  getNumber (argv[5], &fill);
-  getNumber (argv[6], &font);
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgInt(argv[2], "Width", 1, lcdGetWidth(), &w) ||
+      !getArgInt(argv[3], "Height", 1, lcdGetHeight(), &h) ||
+      !getArgColor(argv[4], "Border Color", &border) ||
+      !getArgColor(argv[5], "Fill Color", &fill) ||
+      !getArgColor(argv[6], "Font Color", &font))
+  {
+    return;
+  }
 
   if (argc == 7)
   {
     // Render the button with no text
-    drawButton(x, y, w, h, &dejaVuSans9ptFontInfo, 7, (uint16_t)border, (uint16_t)fill, (uint16_t)font, NULL);
+    drawButton(x, y, w, h, &dejaVuSans9ptFontInfo, 7, border, fill, font, NULL);
   }
   else
   {
-    // Get text contents
-    uint8_t i, len, *data_ptr, data[50];
-    data_ptr = data;
-    for (i = 0; i < argc - 7; i++)
-    {
-      len = strlen(argv[i + 7]);
-      strcpy((char *)data_ptr, (char *)argv[i + 7]);
-      data_ptr += len;
-      *data_ptr++ = ' ';
-    }
-    *data_ptr++ = '\0';
-
     // Render the button with text
-    drawButton(x, y, w, h, &dejaVuSans9ptFontInfo, 7, (uint16_t)border, (uint16_t)fill, (uint16_t)font, (char *)&data);
+    getArgText(argc - 7, &argv[7], text, sizeof(text));
+    drawButton(x, y, w, h, &dejaVuSans9ptFontInfo, 7, border, fill, font, text);
   }
 }
 
@@ -53,49 +53,36 @@
 /**************************************************************************/
 void cmd_circle(uint8_t argc, char **argv)
 {
-  int32_t x, y, r, c, filled, border;
+  int32_t r, filled;
+  uint16_t x, y, c, border;
   filled = 0;
   
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
-  getNumber (argv[2], &r);
-  getNumber (argv[3], &c);
-  if (argc >= 5)
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgInt(argv[2], "Radius", 1, 0xFFFF, &r) ||
+      !getArgColor(argv[3], "Color", &c))
   {
-    getNumber (argv[4], &filled);
-  }
-  if (argc == 6)
-  {
-    getNumber (argv[5], &border);
-    if (border < 0 || border > 0xFFFF)
-    {
-      printf("Invalid Border Color%s", CFG_PRINTF_NEWLINE);
-      return;
-    }
+    return;
   }
-
-  // ToDo: Validate data!
-  if (c < 0 || c > 0xFFFF)
+  if ((argc >= 5) && !getArgInt(argv[4], "Fill Flag", 0, 1, &filled))
   {
-    printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
     return;
   }
-  if (r < 1)
+  if ((argc == 6) && !getArgColor(argv[5], "Border Color", &border))
   {
-    printf("Invalid Radius%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
   if (filled)
-    drawCircleFilled(x, y, r, (uint16_t)c);
+    drawCircleFilled(x, y, r, c);
   else
-    drawCircle(x, y, r, (uint16_t)c);
+    drawCircle(x, y, r, c);
 
   // Draw border if requested
   if (argc == 6)
   {
-    drawCircle(x, y, r, (uint16_t)border);
+    drawCircle(x, y, r, border);
   }
 }
 
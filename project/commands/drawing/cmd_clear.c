@@ -53,22 +53,15 @@
 /**************************************************************************/
 void cmd_clear(uint8_t argc, char **argv)
 {
-  int32_t col = 0;
-  if (argc > 0)
+  uint16_t col = 0;
+
+  if ((argc > 0) && !getArgColor(argv[0], "Color", &col))
   {
-    // Try to convert supplied value to an integer
-    getNumber (argv[0], &col);
-    
-    // Check for invalid values (getNumber may complain about this as well)
-    if (col < 0 || col > 0xFFFF)
-    {
-      printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
-      return;
-    }
+    return;
   }
 
   // Fill the screen
-  drawFill((uint16_t)col);
+  drawFill(col);
 }
 
 #endif  
@@ -53,18 +53,25 @@
 /**************************************************************************/
 void cmd_line(uint8_t argc, char **argv)
 {
-  int32_t x1, y1, x2, y2, c, empty, solid;
+  int32_t empty, solid;
+  uint16_t x1, y1, x2, y2, c;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x1);
-  getNumber (argv[1], &y1);
-  getNumber (argv[2], &x2);
-  getNumber (argv[3], &y2);
-  getNumber (argv[4], &c);
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X1", lcdGetWidth(), &x1) ||
+      !getArgCoord(argv[1], "Y1", lcdGetHeight(), &y1) ||
+      !getArgCoord(argv[2], "X2", lcdGetWidth(), &x2) ||
+      !getArgCoord(argv[3], "Y2", lcdGetHeight(), &y2) ||
+      !getArgColor(argv[4], "Color", &c))
+  {
+    return;
+  }
   if (argc > 5)
   {
-    getNumber (argv[5], &empty);
-    getNumber (argv[6], &solid);
+    if (!getArgInt(argv[5], "Empty Length", 0, 0xFF, &empty) ||
+        !getArgInt(argv[6], "Solid Length", 0, 0xFF, &solid))
+    {
+      return;
+    }
   }
   else
   {
@@ -72,14 +79,7 @@ void cmd_line(uint8_t argc, char **argv)
     solid = 1;
   }
 
-  // ToDo: Validate data!
-  if (c < 0 || c > 0xFFFF)
-  {
-    printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
-    return;
-  }
-
-  drawLineDotted(x1, y1, x2, y2, empty, solid, (uint16_t)c);
+  drawLineDotted(x1, y1, x2, y2, empty, solid, c);
 }
 
 #endif  
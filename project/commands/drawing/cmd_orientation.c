@@ -62,7 +62,11 @@ void cmd_orientation(uint8_t argc, char **argv)
   }
 
   // Convert supplied parameters
-  getNumber (argv[0], &value);
+  if (!getArgInt(argv[0], "orientation", 0, 3, &value))
+  {
+    printf("0, 1, 2 or 3 required.%s", CFG_PRINTF_NEWLINE);
+    return;
+  }
 
   switch (value)
   {
@@ -72,8 +76,14 @@ void cmd_orientation(uint8_t argc, char **argv)
     case 1:
       lcdSetOrientation(LCD_ORIENTATION_LANDSCAPE);
       break;
+    case 2:
+      lcdSetOrientation(LCD_ORIENTATION_PORTRAIT_INVERTED);
+      break;
+    case 3:
+      lcdSetOrientation(LCD_ORIENTATION_LANDSCAPE_INVERTED);
+      break;
     default:
-      printf("Invalid value: Enter 0 or 1%s", CFG_PRINTF_NEWLINE);
+      printf("Invalid value: Enter 0, 1, 2 or 3%s", CFG_PRINTF_NEWLINE);
       return;
   }
 
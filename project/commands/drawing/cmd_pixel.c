@@ -53,21 +53,17 @@
 /**************************************************************************/
 void cmd_pixel(uint8_t argc, char **argv)
 {
-  int32_t x, y, c;
+  uint16_t x, y, c;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
-  getNumber (argv[2], &c);
-
-  // ToDo: Validate data!
-  if (c < 0 || c > 0xFFFF)
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgColor(argv[2], "Color", &c))
   {
-    printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
-  drawPixel(x, y, (uint16_t)c);
+  drawPixel(x, y, c);
 }
 
 /**************************************************************************/
@@ -77,11 +73,14 @@ void cmd_pixel(uint8_t argc, char **argv)
 /**************************************************************************/
 void cmd_getpixel(uint8_t argc, char **argv)
 {
-  int32_t x, y;
+  uint16_t x, y;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y))
+  {
+    return;
+  }
 
   uint16_t value = lcdGetPixel(x, y);
 
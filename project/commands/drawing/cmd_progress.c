@@ -53,28 +53,20 @@
 /**************************************************************************/
 void cmd_progress(uint8_t argc, char **argv)
 {
-  int32_t x, y, w, h, percent, border, borderfill, progressborder, progressfill;
+  int32_t w, h, percent;
+  uint16_t x, y, border, borderfill, progressborder, progressfill;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
-  getNumber (argv[2], &w);
-  getNumber (argv[3], &h);
-  getNumber (argv[4], &percent);
-  getNumber (argv[5], &border);
-  getNumber (argv[6], &borderfill);
-  getNumber (argv[7], &progressborder);
-  getNumber (argv[8], &progressfill);
-
-  // ToDo: Validate data!
-  if (border < 0 || border > 0xFFFF || borderfill < 0 || borderfill > 0xFFFF || progressborder < 0 || progressborder > 0xFFFF || progressfill < 0 || progressfill > 0xFFFF)
-  {
-    printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
-    return;
-  }
-  if (percent < 0 || percent > 100)
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgInt(argv[2], "Width", 1, lcdGetWidth(), &w) ||
+      !getArgInt(argv[3], "Height", 1, lcdGetHeight(), &h) ||
+      !getArgInt(argv[4], "Percentage", 0, 100, &percent) ||
+      !getArgColor(argv[5], "Color", &border) ||
+      !getArgColor(argv[6], "Color", &borderfill) ||
+      !getArgColor(argv[7], "Color", &progressborder) ||
+      !getArgColor(argv[8], "Color", &progressfill))
   {
-    printf("Invalid Percentage%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
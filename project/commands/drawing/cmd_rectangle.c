@@ -53,44 +53,36 @@
 /**************************************************************************/
 void cmd_rectangle(uint8_t argc, char **argv)
 {
-  int32_t x1, y1, x2, y2, c, filled, border;
+  int32_t filled;
+  uint16_t x1, y1, x2, y2, c, border;
   filled = 0;
 
-  // Convert supplied parameters
-  getNumber (argv[0], &x1);
-  getNumber (argv[1], &y1);
-  getNumber (argv[2], &x2);
-  getNumber (argv[3], &y2);
-  getNumber (argv[4], &c);
-  if (argc >= 6)
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X1", lcdGetWidth(), &x1) ||
+      !getArgCoord(argv[1], "Y1", lcdGetHeight(), &y1) ||
+      !getArgCoord(argv[2], "X2", lcdGetWidth(), &x2) ||
+      !getArgCoord(argv[3], "Y2", lcdGetHeight(), &y2) ||
+      !getArgColor(argv[4], "Color", &c))
   {
-    getNumber (argv[5], &filled);
+    return;
   }
-  if (argc == 7)
+  if ((argc >= 6) && !getArgInt(argv[5], "Fill Flag", 0, 1, &filled))
   {
-    getNumber (argv[6], &border);
-    if (border < 0 || border > 0xFFFF)
-    {
-      printf("Invalid Border Color%s", CFG_PRINTF_NEWLINE);
-      return;
-    }
+    return;
   }
-
-  // ToDo: Validate data!
-  if (c < 0 || c > 0xFFFF)
+  if ((argc == 7) && !getArgColor(argv[6], "Border Color", &border))
   {
-    printf("Invalid Color%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
   if (filled)
-    drawRectangleFilled(x1, y1, x2, y2, (uint16_t)c);
+    drawRectangleFilled(x1, y1, x2, y2, c);
   else
-    drawRectangle(x1, y1, x2, y2, (uint16_t)c);
+    drawRectangle(x1, y1, x2, y2, c);
 
   if (argc == 7)
   {
-    drawRectangle(x1, y1, x2, y2, (uint16_t)border);
+    drawRectangle(x1, y1, x2, y2, border);
   }
 }
 
@@ -55,30 +55,24 @@
 /**************************************************************************/
 void cmd_text(uint8_t argc, char **argv)
 {
-  int32_t x, y, color;
   int32_t font;
-  uint8_t i, len;
-  char *data_ptr, data[80];
+  uint16_t x, y, color;
+  char data[80];
   
-  // Convert supplied parameters
-  getNumber (argv[0], &x);
-  getNumber (argv[1], &y);
-  getNumber (argv[2], &color);
-  getNumber (argv[3], &font);
-
-  // Get message contents
-  data_ptr = data;
-  for (i=0; i<argc-4; i++)
+  // Convert and validate supplied parameters
+  if (!getArgCoord(argv[0], "X", lcdGetWidth(), &x) ||
+      !getArgCoord(argv[1], "Y", lcdGetHeight(), &y) ||
+      !getArgColor(argv[2], "Color", &color) ||
+      !getArgInt(argv[3], "Font", 0, 0xFF, &font))
   {
-    len = strlen(argv[i+4]);
-    strcpy((char *)data_ptr, (char *)argv[i+4]);
-    data_ptr += len;
-    *data_ptr++ = ' ';
+    return;
   }
-  *data_ptr++ = '\0';
+
+  // Get message contents
+  getArgText(argc - 4, &argv[4], data, sizeof(data));
 
   // Only Vera Mono 9 is used by default
-  drawString((uint16_t)x, (uint16_t)y, (uint16_t)color, &dejaVuSans9ptFontInfo, (char *)&data);
+  drawString(x, y, color, &dejaVuSans9ptFontInfo, data);
 }
 
 #endif  
@@ -56,22 +56,16 @@
 void cmd_textw(uint8_t argc, char **argv)
 {
   int32_t font;
-  uint8_t i, len;
-  char *data_ptr, data[80];
+  char data[80];
   
   // Convert supplied parameters
-  getNumber (argv[0], &font);
-
-  // Get message contents
-  data_ptr = data;
-  for (i=0; i<argc-1; i++)
+  if (!getArgInt(argv[0], "Font", 0, 0xFF, &font))
   {
-    len = strlen(argv[i+1]);
-    strcpy((char *)data_ptr, (char *)argv[i+1]);
-    data_ptr += len;
-    *data_ptr++ = ' ';
+    return;
   }
-  *data_ptr++ = '\0';
+
+  // Get message contents
+  getArgText(argc - 1, &argv[1], data, sizeof(data));
 
   // User Vera Mono 9 by default for now
   printf("%d %s", drawGetStringWidth(&dejaVuSans9ptFontInfo, data), CFG_PRINTF_NEWLINE);
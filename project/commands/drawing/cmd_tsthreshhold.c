@@ -66,10 +66,9 @@ void cmd_tsthreshhold(uint8_t argc, char **argv)
   }
 
   // Convert supplied parameters
-  getNumber (argv[0], &input);
-  if ((input < 0) || (input > 254))
+  if (!getArgInt(argv[0], "threshold", 0, 254, &input))
   {
-    printf("Invalid value: Enter 0..254%s", CFG_PRINTF_NEWLINE);
+    printf("0-254 required.%s", CFG_PRINTF_NEWLINE);
     return;
   }
   
@@ -58,19 +58,9 @@ void cmd_tswait(uint8_t argc, char **argv)
   int32_t delay;
   int32_t error = 0;
 
-  if (argc == 1)
+  delay = 0;
+  if ((argc == 1) && !getArgInt(argv[0], "timeout", 0, 0x7FFFFFFF, &delay))
   {
-    getNumber (argv[0], &delay);
-  }
-  else
-  {
-    delay = 0;
-  }
-
-  // Validate delay
-  if (delay < 0)
-  {
-    printf("Invalid timeout%s", CFG_PRINTF_NEWLINE);
     return;
   }
 
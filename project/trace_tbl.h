@@ -0,0 +1,52 @@
+/**************************************************************************/
+/*! 
+    @file     trace_tbl.h
+    @author   K. Townsend (microBuilder.eu)
+
+    @section DESCRIPTION
+
+    Format table for the binary trace log (see core/trace/trace.c).  Each
+    entry gives a message ID and the printf format used by the host
+    decoder (tools/tracedec) to display it.  Arguments are 32-bit values,
+    so only the %d, %i, %u, %x, %X and %c conversions can be used.
+
+    This file is included more than once with different definitions of
+    TRACE_MSG, so it has no include guard.  Add new entries at the end to
+    keep existing IDs unchanged, and rebuild the decoder afterwards.
+
+    @section LICENSE
+
+    Software License Agreement (BSD License)
+
+    Copyright (c) 2010, microBuilder SARL
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+    1. Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in the
+    documentation and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holders nor the
+    names of its contributors may be used to endorse or promote products
+    derived from this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+    EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+    DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+    (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+    ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/**************************************************************************/
+
+/*         ID                        Format                                   */
+TRACE_MSG( TRACE_SYSTEM_INIT,        "System initialised (%u Hz)"             )
+TRACE_MSG( TRACE_USB_CONFIGURED,     "USB configured (configuration %u)"      )
+TRACE_MSG( TRACE_CMD_START,          "Command '%c' started (%u args)"         )
+TRACE_MSG( TRACE_CMD_END,            "Command '%c' finished"                  )
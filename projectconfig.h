@@ -167,22 +167,47 @@
                               another value is stored in EEPROM!
     CFG_UART_BUFSIZE          The length in bytes of the UART RX FIFO. This
                               will determine the maximum number of received
-                              characters to store in memory.
+                              characters to store in memory.  Must be a
+                              power of two.
+    CFG_UART_TXBUFSIZE        The length in bytes of the UART TX buffer,
+                              which is drained in the background by the
+                              THRE interrupt so that uartSend and printf
+                              don't wait for the wire.  Must be a power
+                              of two.
+    CFG_UART_RXTRIGGER        Number of bytes (1, 4, 8 or 14) the hardware
+                              RX FIFO collects before raising an
+                              interrupt.  Higher levels take fewer
+                              interrupts at high baud rates.  Anything
+                              left below the trigger level is collected
+                              by the character timeout interrupt.
+    CFG_UART_TXPOLICY         What to do when the TX buffer is full:
+                              0 = block until space is freed
+                              1 = drop the bytes that don't fit
+                              2 = overwrite the oldest queued bytes
 
     -----------------------------------------------------------------------*/
     #ifdef CFG_BRD_LPC1343_REFDESIGN
       #define CFG_UART_BAUDRATE           (115200)
       #define CFG_UART_BUFSIZE            (512)
+      #define CFG_UART_TXBUFSIZE          (256)
+      #define CFG_UART_RXTRIGGER          (8)
+      #define CFG_UART_TXPOLICY           (0)
     #endif
 
     #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
       #define CFG_UART_BAUDRATE           (115200)
       #define CFG_UART_BUFSIZE            (512)
+      #define CFG_UART_TXBUFSIZE          (256)
+      #define CFG_UART_RXTRIGGER          (8)
+      #define CFG_UART_TXPOLICY           (0)
     #endif
 
     #ifdef CFG_BRD_LPC1343_802154USBSTICK
       #define CFG_UART_BAUDRATE           (115200)
       #define CFG_UART_BUFSIZE            (512)
+      #define CFG_UART_TXBUFSIZE          (256)
+      #define CFG_UART_RXTRIGGER          (8)
+      #define CFG_UART_TXPOLICY           (0)
     #endif
 /*=========================================================================*/
 
@@ -212,6 +237,37 @@
 /*=========================================================================*/
 
 
+/*=========================================================================
+    I2C
+    -----------------------------------------------------------------------
+
+    CFG_I2C_TIMEOUT_MS        The default deadline in ms for an I2C
+                              transfer whose timeout is 0 (plus 1ms per
+                              10 bytes).  i2cPoll aborts transfers that
+                              take longer and recovers the bus.
+    CFG_I2C_STATS             The number of slave addresses for which
+                              transfer counts and bus time are kept (see
+                              i2cGetStats and the 'I' command).  Set to
+                              0 to disable the statistics.
+
+    -----------------------------------------------------------------------*/
+    #ifdef CFG_BRD_LPC1343_REFDESIGN
+      #define CFG_I2C_TIMEOUT_MS          (20)
+      #define CFG_I2C_STATS               (8)
+    #endif
+
+    #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
+      #define CFG_I2C_TIMEOUT_MS          (20)
+      #define CFG_I2C_STATS               (8)
+    #endif
+
+    #ifdef CFG_BRD_LPC1343_802154USBSTICK
+      #define CFG_I2C_TIMEOUT_MS          (20)
+      #define CFG_I2C_STATS               (8)
+    #endif
+/*=========================================================================*/
+
+
 /*=========================================================================
     ON-BOARD LED
     -----------------------------------------------------------------------
@@ -256,6 +312,8 @@
                               saving some flash space.
     CFG_SDCARD_CDPORT         The card detect port number
     CFG_SDCARD_CDPIN          The card detect pin number
+    CFG_SDCARD_CSPORT         The chip select port number
+    CFG_SDCARD_CSPIN          The chip select pin number
 
     NOTE:                     All config settings for FAT32 are defined
                               in ffconf.h
@@ -267,13 +325,17 @@
                               can be seen in the following schematic:
                               /tools/schematics/Breakout_TFTLCD_ILI9325_v1.3
 
-    DEPENDENCIES:             SDCARD requires the use of SSP0.
+    DEPENDENCIES:             SDCARD requires the use of SSP0.  SSP0 can
+                              be shared with CHIBI and CFG_SPIEEPROM as
+                              long as each device has its own chip select.
     -----------------------------------------------------------------------*/
     #ifdef CFG_BRD_LPC1343_REFDESIGN
       // #define CFG_SDCARD
       #define CFG_SDCARD_READONLY         (1)   // Must be 0 or 1
       #define CFG_SDCARD_CDPORT           (3)
       #define CFG_SDCARD_CDPIN            (0)
+      #define CFG_SDCARD_CSPORT           (0)
+      #define CFG_SDCARD_CSPIN            (2)
     #endif
 
     #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
@@ -281,6 +343,8 @@
       #define CFG_SDCARD_READONLY         (1)   // Must be 0 or 1
       #define CFG_SDCARD_CDPORT           (3)
       #define CFG_SDCARD_CDPIN            (0)
+      #define CFG_SDCARD_CSPORT           (0)
+      #define CFG_SDCARD_CSPIN            (2)
     #endif
 
     #ifdef CFG_BRD_LPC1343_802154USBSTICK
@@ -288,6 +352,8 @@
       #define CFG_SDCARD_READONLY         (1)   // Must be 0 or 1
       #define CFG_SDCARD_CDPORT           (3)
       #define CFG_SDCARD_CDPIN            (0)
+      #define CFG_SDCARD_CSPORT           (0)
+      #define CFG_SDCARD_CSPIN            (2)
     #endif
 /*=========================================================================*/
 
@@ -310,7 +376,8 @@
                               printf data until it can be sent out in
                               64 byte frames.  The buffer is required since
                               only one frame per ms can be sent using USB
-                              CDC (see 'puts' in systeminit.c).
+                              CDC (see 'puts' in systeminit.c).  Must be
+                              a power of two.
 
     -----------------------------------------------------------------------*/
     #define CFG_USB_VID                   (0x239A)
@@ -378,6 +445,41 @@
 /*=========================================================================*/
 
 
+/*=========================================================================
+    BINARY TRACE LOG
+    -----------------------------------------------------------------------
+
+    CFG_TRACE                 If this field is defined, TRACEn() calls
+                              (see core/trace/trace.h) store binary
+                              records in RAM, which are sent over the
+                              printf link from the main loop and decoded
+                              on the host with tools/tracedec.  If it
+                              isn't defined, trace calls are removed.
+    CFG_TRACE_BUFSIZE         The size of the trace buffer in bytes.
+                              Must be a power of two.
+
+    NOTE:                     The records are binary, so a terminal will
+                              display them as garbage.  Use tracedec to
+                              view the link instead, which also passes
+                              normal text through.
+    -----------------------------------------------------------------------*/
+    #ifdef CFG_BRD_LPC1343_REFDESIGN
+      // #define CFG_TRACE
+      #define CFG_TRACE_BUFSIZE           (512)
+    #endif
+
+    #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
+      // #define CFG_TRACE
+      #define CFG_TRACE_BUFSIZE           (512)
+    #endif
+
+    #ifdef CFG_BRD_LPC1343_802154USBSTICK
+      // #define CFG_TRACE
+      #define CFG_TRACE_BUFSIZE           (512)
+    #endif
+/*=========================================================================*/
+
+
 /*=========================================================================
     COMMAND LINE INTERFACE
     -----------------------------------------------------------------------
@@ -405,6 +507,11 @@
                               new command can safely be sent.
     CFG_INTERFACE_IRQPORT     The gpio port for the IRQ/busy pin
     CFG_INTERFACE_IRQPIN      The gpio pin number for the IRQ/busy pin
+    CFG_INTERFACE_FRAMES      If this is set to 1 the command-line will
+                              also accept COBS encoded binary request
+                              frames (delimited by 0x00), with CRC-checked
+                              responses containing the command output.
+                              See core/cmd/cmdframe.c for the format.
 
     NOTE:                     The command-line interface will use either
                               USB-CDC or UART depending on whether
@@ -419,6 +526,7 @@
       #define CFG_INTERFACE_ENABLEIRQ     (0)
       #define CFG_INTERFACE_IRQPORT       (2)
       #define CFG_INTERFACE_IRQPIN        (0)
+      #define CFG_INTERFACE_FRAMES        (1)
     #endif
 
     #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
@@ -429,6 +537,7 @@
       #define CFG_INTERFACE_ENABLEIRQ     (1)
       #define CFG_INTERFACE_IRQPORT       (2)
       #define CFG_INTERFACE_IRQPIN        (0)
+      #define CFG_INTERFACE_FRAMES        (1)
     #endif
 
     #ifdef CFG_BRD_LPC1343_802154USBSTICK
@@ -439,6 +548,7 @@
       #define CFG_INTERFACE_ENABLEIRQ     (0)
       #define CFG_INTERFACE_IRQPORT       (2)
       #define CFG_INTERFACE_IRQPIN        (0)
+      #define CFG_INTERFACE_FRAMES        (0)
     #endif
 /*=========================================================================*/
 
@@ -513,21 +623,52 @@
     CFG_I2CEEPROM             If defined, drivers for the onboard EEPROM
                               will be included during build
     CFG_I2CEEPROM_SIZE        The number of bytes available on the EEPROM
+    CFG_SPIEEPROM             If defined, settings are stored in an
+                              AT25040 SPI EEPROM on SSP0 instead of the
+                              I2C EEPROM (only one can be defined)
+    CFG_SPIEEPROM_SIZE        The number of bytes available on the SPI
+                              EEPROM
+    CFG_SPIEEPROM_CSPORT      The port of the SPI EEPROM's chip select
+    CFG_SPIEEPROM_CSPIN       The pin of the SPI EEPROM's chip select
+    CFG_EEPROM_CACHE_START    The first EEPROM address held in the RAM
+                              cache used by drivers/eeprom/eeprom.c
+    CFG_EEPROM_CACHE_SIZE     The number of bytes held in the RAM cache.
+                              Reads in this range are served from RAM, and
+                              writes are collected and written back a page
+                              at a time by eepromFlush.  Set to 0 to
+                              disable the cache.
+    CFG_EEPROM_CACHE_FLUSHMS  The delay in ms after the first uncommitted
+                              write before eepromPoll writes the cache back
+                              to EEPROM.  Set to 0 to only write changes
+                              when eepromFlush is called.
 
     -----------------------------------------------------------------------*/
     #ifdef CFG_BRD_LPC1343_REFDESIGN
       #define CFG_I2CEEPROM
       #define CFG_I2CEEPROM_SIZE          (3072)
+      // #define CFG_SPIEEPROM
+      // #define CFG_SPIEEPROM_SIZE          (512)
+      // #define CFG_SPIEEPROM_CSPORT        (0)
+      // #define CFG_SPIEEPROM_CSPIN         (2)
+      #define CFG_EEPROM_CACHE_START      (0x0000)
+      #define CFG_EEPROM_CACHE_SIZE       (128)
+      #define CFG_EEPROM_CACHE_FLUSHMS    (1000)
     #endif
 
     #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
       #define CFG_I2CEEPROM
       #define CFG_I2CEEPROM_SIZE          (3072)
+      #define CFG_EEPROM_CACHE_START      (0x0000)
+      #define CFG_EEPROM_CACHE_SIZE       (128)
+      #define CFG_EEPROM_CACHE_FLUSHMS    (1000)
     #endif
 
     #ifdef CFG_BRD_LPC1343_802154USBSTICK
       #define CFG_I2CEEPROM
       #define CFG_I2CEEPROM_SIZE          (3072)
+      #define CFG_EEPROM_CACHE_START      (0x0000)
+      #define CFG_EEPROM_CACHE_SIZE       (128)
+      #define CFG_EEPROM_CACHE_FLUSHMS    (1000)
     #endif
 /*=========================================================================*/
 
@@ -619,11 +760,17 @@
                                 0 to disable it.  If promiscuous mode is
                                 enabled be sure to set CFG_CHIBI_BUFFERSIZE
                                 to an appropriately large value (ex. 1024)
-    CFG_CHIBI_BUFFERSIZE        The size of the message buffer in bytes
+    CFG_CHIBI_BUFFERSIZE        The size of the message buffer in bytes,
+                                which must be a power of two
+    CFG_CHIBI_CSPORT            The port of the transceiver's chip select
+    CFG_CHIBI_CSPIN             The pin of the transceiver's chip select
 
     DEPENDENCIES:               Chibi requires the use of SSP0, 16-bit timer
                                 0 and pins 3.1, 3.2, 3.3.  It also requires
-                                the presence of CFG_I2CEEPROM.
+                                the presence of CFG_I2CEEPROM or
+                                CFG_SPIEEPROM.  If CFG_SDCARD or
+                                CFG_SPIEEPROM is also defined, the
+                                transceiver needs its own chip select pin.
 
     NOTE:                       These settings are not relevant to all boards!
                                 'tools/schematics/AT86RF212LPC1114_v1.6.pdf'
@@ -637,6 +784,8 @@
       #define CFG_CHIBI_PANID             (0x1234)
       #define CFG_CHIBI_PROMISCUOUS       (0)
       #define CFG_CHIBI_BUFFERSIZE        (128)
+      #define CFG_CHIBI_CSPORT            (0)
+      #define CFG_CHIBI_CSPIN             (2)
     #endif
 
     #ifdef CFG_BRD_LPC1343_TFTLCDSTANDALONE
@@ -647,6 +796,8 @@
       #define CFG_CHIBI_PANID             (0x1234)
       #define CFG_CHIBI_PROMISCUOUS       (0)
       #define CFG_CHIBI_BUFFERSIZE        (128)
+      #define CFG_CHIBI_CSPORT            (0)
+      #define CFG_CHIBI_CSPIN             (2)
     #endif
 
     #ifdef CFG_BRD_LPC1343_802154USBSTICK
@@ -657,6 +808,8 @@
       #define CFG_CHIBI_PANID             (0x1234)
       #define CFG_CHIBI_PROMISCUOUS       (0)
       #define CFG_CHIBI_BUFFERSIZE        (1024)
+      #define CFG_CHIBI_CSPORT            (0)
+      #define CFG_CHIBI_CSPIN             (2)
     #endif
 /*=========================================================================*/
 
@@ -764,8 +917,8 @@
                                 32-bit providing smaller encrypted text
                                 size.
                                   
-    NOTE:                       Please note that Printf can not be
-                                used to display 64-bit values (%lld)!
+    NOTE:                       64-bit values can be displayed with
+                                %lld/%llu (see core/libc/stdio.c).
     -----------------------------------------------------------------------*/
     #ifdef CFG_BRD_LPC1343_REFDESIGN
       // #define CFG_RSA
@@ -809,6 +962,35 @@
   #error "CFG_PRINTF_CDC requires CFG_USBCDC to be defined as well"
 #endif
 
+#if CFG_UART_RXTRIGGER != 1 && CFG_UART_RXTRIGGER != 4 && CFG_UART_RXTRIGGER != 8 && CFG_UART_RXTRIGGER != 14
+  #error "CFG_UART_RXTRIGGER must be 1, 4, 8 or 14"
+#endif
+
+#if CFG_UART_TXPOLICY < 0 || CFG_UART_TXPOLICY > 2
+  #error "CFG_UART_TXPOLICY must be 0 (block), 1 (drop) or 2 (overwrite)"
+#endif
+
+#if (CFG_UART_BUFSIZE & (CFG_UART_BUFSIZE - 1)) || (CFG_UART_TXBUFSIZE & (CFG_UART_TXBUFSIZE - 1))
+  #error "CFG_UART_BUFSIZE and CFG_UART_TXBUFSIZE must be powers of two"
+#endif
+
+#if defined CFG_USBCDC && (CFG_USBCDC_BUFFERSIZE & (CFG_USBCDC_BUFFERSIZE - 1))
+  #error "CFG_USBCDC_BUFFERSIZE must be a power of two"
+#endif
+
+#if defined CFG_CHIBI && (CFG_CHIBI_BUFFERSIZE & (CFG_CHIBI_BUFFERSIZE - 1))
+  #error "CFG_CHIBI_BUFFERSIZE must be a power of two"
+#endif
+
+#ifdef CFG_TRACE
+  #if CFG_TRACE_BUFSIZE & (CFG_TRACE_BUFSIZE - 1)
+    #error "CFG_TRACE_BUFSIZE must be a power of two"
+  #endif
+  #if !defined CFG_PRINTF_UART && !defined CFG_PRINTF_USBCDC
+    #error "CFG_TRACE requires CFG_PRINTF_UART or CFG_PRINTF_USBCDC to send the trace records"
+  #endif
+#endif
+
 #if defined CFG_USBCDC && defined CFG_USBHID
   #error "Only one USB class can be defined at a time (CFG_USBCDC or CFG_USBHID)"
 #endif
@@ -828,14 +1010,44 @@
   #if defined CFG_PRINTF_USBCDC && CFG_INTERFACE_SILENTMODE == 1
     #error "CFG_INTERFACE_SILENTMODE typically isn't enabled with CFG_PRINTF_USBCDC"
   #endif
+  #if CFG_INTERFACE_FRAMES != 0 && CFG_INTERFACE_FRAMES != 1
+    #error "CFG_INTERFACE_FRAMES must be 0 or 1"
+  #endif
+#endif
+
+#ifdef CFG_I2CEEPROM
+  #ifdef CFG_SPIEEPROM
+    #error "CFG_I2CEEPROM and CFG_SPIEEPROM can not be defined at the same time. Only one EEPROM can hold the settings."
+  #endif
+  #if CFG_EEPROM_CACHE_SIZE > 0 && CFG_EEPROM_CACHE_START + CFG_EEPROM_CACHE_SIZE > CFG_I2CEEPROM_SIZE
+    #error "CFG_EEPROM_CACHE_START and CFG_EEPROM_CACHE_SIZE must lie within CFG_I2CEEPROM_SIZE"
+  #endif
+#endif
+
+#ifdef CFG_SPIEEPROM
+  #if !defined CFG_SPIEEPROM_CSPORT || !defined CFG_SPIEEPROM_CSPIN
+    #error "CFG_SPIEEPROM requires CFG_SPIEEPROM_CSPORT and CFG_SPIEEPROM_CSPIN"
+  #endif
+  #if defined CFG_SDCARD && CFG_SPIEEPROM_CSPORT == CFG_SDCARD_CSPORT && CFG_SPIEEPROM_CSPIN == CFG_SDCARD_CSPIN
+    #error "CFG_SPIEEPROM_CSPORT/CSPIN and CFG_SDCARD_CSPORT/CSPIN must be different pins since both devices share SSP0"
+  #endif
+  #if CFG_SPIEEPROM_SIZE > 512
+    #error "CFG_SPIEEPROM_SIZE can not be larger than the 512 bytes of the AT25040"
+  #endif
+  #if CFG_EEPROM_CACHE_SIZE > 0 && CFG_EEPROM_CACHE_START + CFG_EEPROM_CACHE_SIZE > CFG_SPIEEPROM_SIZE
+    #error "CFG_EEPROM_CACHE_START and CFG_EEPROM_CACHE_SIZE must lie within CFG_SPIEEPROM_SIZE"
+  #endif
 #endif
 
 #ifdef CFG_CHIBI
-  #if !defined CFG_I2CEEPROM
-    #error "CFG_CHIBI requires CFG_I2CEEPROM to store and retrieve addresses"
+  #if !defined CFG_I2CEEPROM && !defined CFG_SPIEEPROM
+    #error "CFG_CHIBI requires CFG_I2CEEPROM or CFG_SPIEEPROM to store and retrieve addresses"
+  #endif
+  #if defined CFG_SDCARD && CFG_CHIBI_CSPORT == CFG_SDCARD_CSPORT && CFG_CHIBI_CSPIN == CFG_SDCARD_CSPIN
+    #error "CFG_CHIBI_CSPORT/CSPIN and CFG_SDCARD_CSPORT/CSPIN must be different pins since both devices share SSP0"
   #endif
-  #ifdef CFG_SDCARD
-    #error "CFG_CHIBI and CFG_SDCARD can not be defined at the same time. Only one SPI block is available on the LPC1343."
+  #if defined CFG_SPIEEPROM && CFG_CHIBI_CSPORT == CFG_SPIEEPROM_CSPORT && CFG_CHIBI_CSPIN == CFG_SPIEEPROM_CSPIN
+    #error "CFG_CHIBI_CSPORT/CSPIN and CFG_SPIEEPROM_CSPORT/CSPIN must be different pins since both devices share SSP0"
   #endif
   #ifdef CFG_TFTLCD
     #error "CFG_CHIBI and CFG_TFTLCD can not be defined at the same time since they both use pins 1.8, 1.9 and 1.10."
@@ -858,8 +1070,8 @@
   #ifdef CFG_PWM
     #error "CFG_TFTLCD and CFG_PWM can not be defined at the same time since they both use pin 1.9."
   #endif
-  #if !defined CFG_I2CEEPROM
-    #error "CFG_TFTLCD requires CFG_I2CEEPROM to store and retrieve configuration settings"
+  #if !defined CFG_I2CEEPROM && !defined CFG_SPIEEPROM
+    #error "CFG_TFTLCD requires CFG_I2CEEPROM or CFG_SPIEEPROM to store and retrieve configuration settings"
   #endif
 #endif
 
@@ -45,6 +45,8 @@
 #include "core/cpu/cpu.h"
 #include "core/pmu/pmu.h"
 #include "core/adc/adc.h"
+#include "core/trace/trace.h"
+#include "core/libc/printf.h"
 
 #ifdef CFG_PRINTF_UART
   #include "core/uart/uart.h"
@@ -63,7 +65,6 @@
 #endif
 
 #ifdef CFG_USBCDC
-  volatile unsigned int lastTick;
   #include "core/usbcdc/usb.h"
   #include "core/usbcdc/usbcore.h"
   #include "core/usbcdc/usbhw.h"
@@ -92,6 +93,11 @@
   #include "drivers/eeprom/eeprom.h"
 #endif
 
+#ifdef CFG_SPIEEPROM
+  #include "drivers/eeprom/at25040/at25040.h"
+  #include "drivers/eeprom/eeprom.h"
+#endif
+
 #ifdef CFG_PWM
   #include "core/pwm/pwm.h"
 #endif
@@ -126,6 +132,11 @@ void systemInit()
   pmuInit();                                // Configure power management
   adcInit();                                // Config adc pins to save power
 
+  // Initialise the trace buffer so TRACEn() can be used from here on
+  #ifdef CFG_TRACE
+    traceInit();
+  #endif
+
   // Set LED pin as output and turn LED off
   gpioSetDir(CFG_LED_PORT, CFG_LED_PIN, 1);
   gpioSetValue(CFG_LED_PORT, CFG_LED_PIN, CFG_LED_OFF);
@@ -134,11 +145,14 @@ void systemInit()
   #ifdef CFG_I2CEEPROM
     mcp24aaInit();
   #endif
+  #ifdef CFG_SPIEEPROM
+    at25Init();
+  #endif
 
   // Initialise UART with the default baud rate
   #ifdef CFG_PRINTF_UART
     uint32_t uart = eepromReadU32(CFG_EEPROM_UART_SPEED);
-    if ((uart == 0xFFFFFFFF) || (uart > 115200))
+    if ((uart == 0xFFFFFFFF) || (uart > UART_BAUDRATE_MAX))
     {
       uartInit(CFG_UART_BAUDRATE);  // Use default baud rate
     }
@@ -160,7 +174,6 @@ void systemInit()
 
   // Initialise USB CDC
   #ifdef CFG_USBCDC
-    lastTick = systickGetTicks();   // Used to control output/printf timing
     CDC_Init();                     // Initialise VCOM
     USB_Init();                     // USB Initialization
     USB_Connect(TRUE);              // USB Connect
@@ -208,6 +221,8 @@ void systemInit()
     // printf("%-40s : 0x%04X%s", "Chibi Initialised", pcb->src_addr, CFG_PRINTF_NEWLINE);
   #endif
 
+  TRACE1(TRACE_SYSTEM_INIT, CFG_CPU_CCLK);
+
   // Start the command line interface
   #ifdef CFG_INTERFACE
     cmdInit();
@@ -232,7 +247,35 @@ void __putchar(const char c)
 
 /**************************************************************************/
 /*! 
-    @brief Sends a string to a pre-determined end point (UART, etc.).
+    @brief Sends a block of characters to a pre-determined end point
+           (UART, etc.).  This is the default output sink for printf
+           (see core/libc/stdio.c).
+
+    @param[in]  data
+                Characters to send (not NULL-terminated)
+    @param[in]  length
+                Number of characters to send
+*/
+/**************************************************************************/
+void __putdata(const char *data, uint32_t length)
+{
+  // Text is queued in the CDC buffer, and the IN endpoint interrupt
+  // sends it to the host one 64 byte packet at a time in the background
+  #ifdef CFG_PRINTF_USBCDC
+    if (USB_Configuration) 
+    {
+      CDC_WrInBuf(data, length);
+    }
+  #elif defined CFG_PRINTF_UART
+    // Queue the whole block in the UART transmit buffer
+    uartWrite((const uint8_t *)data, length);
+  #endif
+}
+
+/**************************************************************************/
+/*! 
+    @brief Sends a string to the current printf sink (by default the
+           UART or USB CDC end point, see __putdata).
 
     @param[in]  str
                 Text to send
@@ -245,34 +288,7 @@ void __putchar(const char c)
 /**************************************************************************/
 int puts(const char * str)
 {
-  // There must be at least 1ms between USB frames (of up to 64 bytes)
-  // This buffers all data and writes it out from the buffer one frame
-  // and one millisecond at a time
-  #ifdef CFG_PRINTF_USBCDC
-    if (USB_Configuration) 
-    {
-      while(*str)
-        cdcBufferWrite(*str++);
-      // Check if we can flush the buffer now or if we need to wait
-      unsigned int currentTick = systickGetTicks();
-      if (currentTick != lastTick)
-      {
-        uint8_t frame[64];
-        uint32_t bytesRead = 0;
-        while (cdcBufferDataPending())
-        {
-          // Read up to 64 bytes as long as possible
-          bytesRead = cdcBufferReadLen(frame, 64);
-          USB_WriteEP (CDC_DEP_IN, frame, bytesRead);
-          systickDelay(1);
-        }
-        lastTick = currentTick;
-      }
-    }
-  #else
-    // Handle output character by character in __putchar
-    while(*str) __putchar(*str++);
-  #endif
+  printfWrite(str, strlen(str));
 
   return 0;
 }
@@ -0,0 +1,162 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ * Copyright (c) 2010, microBuilder SARL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the
+ * names of its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Measures the throughput of the USB CDC (or UART) link by asking the
+ * firmware's 'D' command to stream a test pattern, timing how long it
+ * takes to arrive and checking every byte.
+ *
+ * syntax: cdcbench <device> [bytes]
+ *   e.g.: cdcbench /dev/ttyACM0 1000000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <sys/select.h>
+
+#define DEFAULT_BYTES   (1000000)
+#define TIMEOUT_MS      (2000)      // Give up if nothing arrives for this long
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+// Read up to len bytes, waiting at most TIMEOUT_MS for the first one
+static int readTimeout(int fd, uint8_t *buf, int len)
+{
+  fd_set fds;
+  struct timeval tv;
+
+  FD_ZERO(&fds);
+  FD_SET(fd, &fds);
+  tv.tv_sec = TIMEOUT_MS / 1000;
+  tv.tv_usec = (TIMEOUT_MS % 1000) * 1000;
+  if (select(fd + 1, &fds, NULL, NULL, &tv) <= 0)
+  {
+    return 0;
+  }
+  return read(fd, buf, len);
+}
+
+int main(int argc, char *argv[])
+{
+  struct termios tio;
+  uint8_t buf[4096];
+  char cmd[32];
+  long total, received = 0, errors = 0;
+  double start, elapsed;
+  int fd, n, i, synced = 0;
+
+  // Check for required arguments
+  if (argc < 2)
+  {
+    printf("syntax: cdcbench <device> [bytes]\n");
+    return 1;
+  }
+  total = argc > 2 ? atol(argv[2]) : DEFAULT_BYTES;
+  if (total <= 0)
+  {
+    printf("error: invalid byte count [%s]\n", argv[2]);
+    return 1;
+  }
+
+  // Open the port in raw mode
+  if ((fd = open(argv[1], O_RDWR | O_NOCTTY)) < 0)
+  {
+    printf("error: could not open device [%s]\n", argv[1]);
+    return 1;
+  }
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIOFLUSH);
+
+  // Start the stream
+  snprintf(cmd, sizeof(cmd), "D %ld\r", total);
+  if (write(fd, cmd, strlen(cmd)) != (ssize_t)strlen(cmd))
+  {
+    printf("error: could not write to device\n");
+    return 1;
+  }
+
+  // Skip the command echo up to the STX marker, then time the data
+  start = now();
+  while (received < total)
+  {
+    n = readTimeout(fd, buf, sizeof(buf));
+    if (n <= 0)
+    {
+      break;
+    }
+    for (i = 0; i < n && received < total; i++)
+    {
+      if (!synced)
+      {
+        if (buf[i] == 0x02)
+        {
+          synced = 1;
+          start = now();
+        }
+        continue;
+      }
+      if (buf[i] != 'A' + (received % 26))
+      {
+        errors++;
+      }
+      received++;
+    }
+  }
+  elapsed = now() - start;
+  close(fd);
+
+  if (!synced)
+  {
+    printf("error: no response (is the 'D' command available?)\n");
+    return 1;
+  }
+  printf("received %ld of %ld bytes in %.3f s, %ld errors\n", received, total, elapsed, errors);
+  if (elapsed > 0)
+  {
+    printf("throughput: %.1f KB/s\n", received / elapsed / 1024.0);
+  }
+
+  return (received == total && errors == 0) ? 0 : 1;
+}
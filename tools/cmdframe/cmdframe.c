@@ -0,0 +1,337 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ * Copyright (c) 2010, microBuilder SARL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the
+ * names of its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Sends binary request frames to the firmware's command-line (see
+ * core/cmd/cmdframe.c) and checks the responses.  Numeric arguments are
+ * sent as 32-bit integers and anything else as a string.  With a count,
+ * the same request is repeated, keeping up to 'window' requests in flight
+ * at once, and the request rate is reported.
+ *
+ * syntax: cmdframe <device> [-n count] [-w window] <command> [args...]
+ *   e.g.: cmdframe /dev/ttyACM0 V
+ *         cmdframe /dev/ttyACM0 -n 1000 -w 8 p 10 10 0xFFFF
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <sys/select.h>
+
+#define MAX_FRAME       (1024)
+#define TIMEOUT_MS      (2000)      // Give up if nothing arrives for this long
+
+#define ARG_INT         (0x01)
+#define ARG_STRING      (0x02)
+
+static const char *statusText[] =
+{
+  "OK", "CRC error", "malformed request", "unknown command", "wrong argument count"
+};
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+// Read up to len bytes, waiting at most TIMEOUT_MS for the first one
+static int readTimeout(int fd, uint8_t *buf, int len)
+{
+  fd_set fds;
+  struct timeval tv;
+
+  FD_ZERO(&fds);
+  FD_SET(fd, &fds);
+  tv.tv_sec = TIMEOUT_MS / 1000;
+  tv.tv_usec = (TIMEOUT_MS % 1000) * 1000;
+  if (select(fd + 1, &fds, NULL, NULL, &tv) <= 0)
+  {
+    return 0;
+  }
+  return read(fd, buf, len);
+}
+
+// CRC-16/CCITT (0x1021, initial value 0xFFFF)
+static uint16_t crc16(const uint8_t *data, int len)
+{
+  uint16_t crc = 0xFFFF;
+  int i;
+
+  while (len--)
+  {
+    crc ^= *data++ << 8;
+    for (i = 0; i < 8; i++)
+    {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// COBS encode len bytes from src into dst, returning the encoded length
+static int cobsEncode(const uint8_t *src, int len, uint8_t *dst)
+{
+  int code = 0, out = 1, i;
+
+  for (i = 0; i < len; i++)
+  {
+    if (src[i] == 0)
+    {
+      dst[code] = out - code;
+      code = out++;
+      continue;
+    }
+    dst[out++] = src[i];
+    if (out - code == 0xFF)
+    {
+      dst[code] = 0xFF;
+      code = out++;
+    }
+  }
+  dst[code] = out - code;
+  return out;
+}
+
+// COBS decode in place, returning the decoded length or -1 if invalid
+static int cobsDecode(uint8_t *buf, int len)
+{
+  int in = 0, out = 0, code, i;
+
+  while (in < len)
+  {
+    code = buf[in++];
+    if (code == 0 || code - 1 > len - in)
+    {
+      return -1;
+    }
+    for (i = 1; i < code; i++)
+    {
+      buf[out++] = buf[in++];
+    }
+    if (code < 0xFF && in < len)
+    {
+      buf[out++] = 0;
+    }
+  }
+  return out;
+}
+
+// Check one response, returning 1 if it is valid and successful
+static int checkResponse(uint8_t *frame, int len, uint8_t seq, int show)
+{
+  uint16_t crc;
+
+  len = cobsDecode(frame, len);
+  if (len < 4)
+  {
+    printf("error: malformed response\n");
+    return 0;
+  }
+  len -= 2;
+  crc = frame[len] | (frame[len + 1] << 8);
+  if (crc16(frame, len) != crc)
+  {
+    printf("error: response CRC mismatch\n");
+    return 0;
+  }
+  if (frame[0] != seq)
+  {
+    printf("error: expected sequence %d, received %d\n", seq, frame[0]);
+    return 0;
+  }
+  if (frame[1] != 0)
+  {
+    printf("error: %s\n", frame[1] < 5 ? statusText[frame[1]] : "unknown status");
+    return 0;
+  }
+  if (show)
+  {
+    fwrite(&frame[2], 1, len - 2, stdout);
+  }
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  struct termios tio;
+  uint8_t request[MAX_FRAME], encoded[MAX_FRAME + MAX_FRAME / 254 + 3];
+  uint8_t rx[4096], frame[MAX_FRAME * 2];
+  long count = 1, sent = 0, received = 0, errors = 0;
+  int window = 1, reqLen, encLen, frameLen = 0, inFrame = 0;
+  int fd, n, i, arg = 2;
+  double start, elapsed;
+  uint16_t crc;
+  char *end;
+  long value;
+
+  // Check for required arguments
+  while (arg + 1 < argc && argv[arg][0] == '-')
+  {
+    if (!strcmp(argv[arg], "-n"))
+    {
+      count = atol(argv[arg + 1]);
+    }
+    else if (!strcmp(argv[arg], "-w"))
+    {
+      window = atoi(argv[arg + 1]);
+    }
+    else
+    {
+      break;
+    }
+    arg += 2;
+  }
+  if (argc <= arg || strlen(argv[arg]) != 1 || count <= 0 || window <= 0 || window > 128)
+  {
+    printf("syntax: cmdframe <device> [-n count] [-w window] <command> [args...]\n");
+    return 1;
+  }
+
+  // Build the request, leaving byte 0 for the sequence number
+  request[1] = argv[arg][0];
+  reqLen = 2;
+  for (arg++; arg < argc; arg++)
+  {
+    value = strtol(argv[arg], &end, 0);
+    n = strlen(argv[arg]);
+    if (reqLen + n + 4 > MAX_FRAME)
+    {
+      printf("error: too many arguments\n");
+      return 1;
+    }
+    if (*argv[arg] != '\0' && *end == '\0')
+    {
+      request[reqLen++] = ARG_INT;
+      for (i = 0; i < 4; i++)
+      {
+        request[reqLen++] = (uint32_t)value >> (8 * i);
+      }
+    }
+    else
+    {
+      if (n > 255)
+      {
+        printf("error: argument too long [%s]\n", argv[arg]);
+        return 1;
+      }
+      request[reqLen++] = ARG_STRING;
+      request[reqLen++] = n;
+      memcpy(&request[reqLen], argv[arg], n);
+      reqLen += n;
+    }
+  }
+
+  // Open the port in raw mode
+  if ((fd = open(argv[1], O_RDWR | O_NOCTTY)) < 0)
+  {
+    printf("error: could not open device [%s]\n", argv[1]);
+    return 1;
+  }
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIOFLUSH);
+
+  start = now();
+  while (received < count)
+  {
+    // Keep up to 'window' requests in flight
+    while (sent < count && sent - received < window)
+    {
+      request[0] = sent & 0xFF;
+      crc = crc16(request, reqLen);
+      request[reqLen] = crc & 0xFF;
+      request[reqLen + 1] = crc >> 8;
+      encoded[0] = 0x00;
+      encLen = cobsEncode(request, reqLen + 2, &encoded[1]) + 1;
+      encoded[encLen++] = 0x00;
+      if (write(fd, encoded, encLen) != encLen)
+      {
+        printf("error: could not write to device\n");
+        return 1;
+      }
+      sent++;
+    }
+
+    // Collect responses, ignoring any text between frames
+    n = readTimeout(fd, rx, sizeof(rx));
+    if (n <= 0)
+    {
+      printf("error: timed out waiting for response %ld\n", received);
+      break;
+    }
+    for (i = 0; i < n; i++)
+    {
+      if (rx[i] == 0x00)
+      {
+        if (inFrame && frameLen > 0)
+        {
+          if (!checkResponse(frame, frameLen, received & 0xFF, count == 1))
+          {
+            errors++;
+          }
+          received++;
+          inFrame = 0;
+        }
+        else
+        {
+          inFrame = 1;
+        }
+        frameLen = 0;
+      }
+      else if (inFrame && frameLen < (int)sizeof(frame))
+      {
+        frame[frameLen++] = rx[i];
+      }
+    }
+  }
+  elapsed = now() - start;
+  close(fd);
+
+  if (count > 1)
+  {
+    printf("%ld of %ld requests in %.3f s, %ld errors\n", received, count, elapsed, errors);
+    if (elapsed > 0)
+    {
+      printf("rate: %.1f requests/s\n", received / elapsed);
+    }
+  }
+
+  return (received == count && errors == 0) ? 0 : 1;
+}
@@ -48,7 +48,6 @@
 #endif
 
 #ifdef CFG_PRINTF_USBCDC
-  volatile unsigned int lastTick;
   #include "core/usbcdc/usb.h"
   #include "core/usbcdc/usbcore.h"
   #include "core/usbcdc/usbhw.h"
@@ -104,36 +103,15 @@ int main(void)
 
           
           // Send raw data the to PC for processing using wsbridge
-          uint8_t i;
-          for (i=0; i<rx_data.len; i++)
-          {
-            #ifdef CFG_PRINTF_UART
-              uartSendByte(rx_data.data[i]);
-            #endif
-            #ifdef CFG_PRINTF_USBCDC
-               // ToDo: This really needs to be refactored!
-              if (USB_Configuration) 
-              {
-                cdcBufferWrite(rx_data.data[i]);
-                // Check if we can flush the buffer now or if we need to wait
-                unsigned int currentTick = systickGetTicks();
-                if (currentTick != lastTick)
-                {
-                  uint8_t frame[64];
-                  uint32_t bytesRead = 0;
-                  while (cdcBufferDataPending())
-                  {
-                    // Read 64 byte chunks until end of data
-                    bytesRead = cdcBufferReadLen(frame, 64);
-                    // debug_printf("%d,", bytesRead);
-                    USB_WriteEP (CDC_DEP_IN, frame, bytesRead);
-                    systickDelay(1);
-                  }
-                  lastTick = currentTick;
-                }
-              }  
-            #endif
-          }
+          #ifdef CFG_PRINTF_UART
+            uartSend(rx_data.data, rx_data.len);
+          #endif
+          #ifdef CFG_PRINTF_USBCDC
+            if (USB_Configuration) 
+            {
+              CDC_WrInBuf((const char *)rx_data.data, rx_data.len);
+            }
+          #endif
 
           // Disable LED
           gpioSetValue (CFG_LED_PORT, CFG_LED_PIN, CFG_LED_OFF); 
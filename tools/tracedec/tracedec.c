@@ -0,0 +1,233 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ * Copyright (c) 2010, microBuilder SARL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the
+ * names of its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Decodes the binary trace records sent by core/trace/trace.c.  Normal
+ * text on the link is passed through unchanged, and each record is
+ * printed with its timestamp using the format from project/trace_tbl.h.
+ *
+ * syntax: tracedec <device|file|->
+ *   e.g.: tracedec /dev/ttyACM0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+#define TRACE_SYNC          (0xA5)
+#define TRACE_MAXARGS       (4)
+#define TRACE_HEADERSIZE    (8)
+#define TRACE_RECORDSIZE(argc)  (TRACE_HEADERSIZE + 4 * (argc) + 1)
+
+typedef struct
+{
+  const char *name;
+  const char *format;
+} traceMsg_t;
+
+// Format table, generated from the same file as the firmware's IDs
+static const traceMsg_t traceTable[] =
+{
+  #define TRACE_MSG(id, format) { #id, format },
+  #include "../../project/trace_tbl.h"
+  #undef TRACE_MSG
+};
+
+#define TRACE_COUNT   (sizeof(traceTable) / sizeof(traceTable[0]))
+
+static uint8_t record[TRACE_RECORDSIZE(TRACE_MAXARGS)];
+static int recordLen = 0;
+static unsigned long badRecords = 0;
+
+static uint32_t getU32(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Only 32-bit integer conversions can be used with the recorded arguments
+static int formatIsSafe(const char *format)
+{
+  while ((format = strchr(format, '%')) != NULL)
+  {
+    format++;
+    while (*format == '-' || (*format >= '0' && *format <= '9'))
+    {
+      format++;
+    }
+    if (*format == '\0' || strchr("diuxXc%", *format) == NULL)
+    {
+      return 0;
+    }
+    format++;
+  }
+  return 1;
+}
+
+static void printRecord(void)
+{
+  uint32_t args[TRACE_MAXARGS] = { 0 };
+  uint16_t id = record[2] | (record[3] << 8);
+  int argc = record[1];
+  int i;
+
+  for (i = 0; i < argc; i++)
+  {
+    args[i] = getU32(&record[TRACE_HEADERSIZE + 4 * i]);
+  }
+
+  printf("[%10u] ", getU32(&record[4]));
+  if (id < TRACE_COUNT && formatIsSafe(traceTable[id].format))
+  {
+    printf(traceTable[id].format, args[0], args[1], args[2], args[3]);
+  }
+  else
+  {
+    printf("unknown message %u:", id);
+    for (i = 0; i < argc; i++)
+    {
+      printf(" 0x%08X", args[i]);
+    }
+  }
+  printf("\n");
+}
+
+// Feeds one byte through the decoder
+static void decode(uint8_t c)
+{
+  uint8_t sum;
+  int i;
+
+  if (recordLen == 0)
+  {
+    if (c == TRACE_SYNC)
+    {
+      record[recordLen++] = c;
+    }
+    else
+    {
+      putchar(c);
+    }
+    return;
+  }
+
+  record[recordLen++] = c;
+  if (recordLen == 2 && record[1] > TRACE_MAXARGS)
+  {
+    // Not a record after all: resync on the bytes after the sync byte
+    recordLen = 0;
+    badRecords++;
+    decode(record[1]);
+    return;
+  }
+  if (recordLen < 2 || recordLen < TRACE_RECORDSIZE(record[1]))
+  {
+    return;
+  }
+
+  for (sum = 0, i = 1; i < recordLen - 1; i++)
+  {
+    sum += record[i];
+  }
+  if (sum == record[recordLen - 1])
+  {
+    recordLen = 0;
+    printRecord();
+  }
+  else
+  {
+    // Bad checksum: drop the sync byte and rescan what followed it
+    uint8_t rest[sizeof(record)];
+    int restLen = recordLen - 1;
+
+    memcpy(rest, &record[1], restLen);
+    recordLen = 0;
+    badRecords++;
+    for (i = 0; i < restLen; i++)
+    {
+      decode(rest[i]);
+    }
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  struct termios tio;
+  uint8_t buf[4096];
+  int fd, n, i;
+
+  // Check for required arguments
+  if (argc < 2)
+  {
+    printf("syntax: tracedec <device|file|->\n");
+    return 1;
+  }
+
+  if (!strcmp(argv[1], "-"))
+  {
+    fd = STDIN_FILENO;
+  }
+  else if ((fd = open(argv[1], O_RDONLY | O_NOCTTY)) < 0)
+  {
+    printf("error: could not open [%s]\n", argv[1]);
+    return 1;
+  }
+
+  // Put serial ports in raw mode
+  if (isatty(fd))
+  {
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+
+  while ((n = read(fd, buf, sizeof(buf))) > 0)
+  {
+    for (i = 0; i < n; i++)
+    {
+      decode(buf[i]);
+    }
+    fflush(stdout);
+  }
+
+  if (badRecords)
+  {
+    fprintf(stderr, "%lu invalid records skipped\n", badRecords);
+  }
+  close(fd);
+
+  return 0;
+}